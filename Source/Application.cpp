@@ -14,11 +14,23 @@
  * limitations under the License.
  */
 
+#include <Corrade/Utility/Debug.h>
 #include <Magnum/GL/DefaultFramebuffer.h>
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include "DrawableObjects/PickableObject.h"
+#include "DrawableObjects/ResourceCache.h"
+#include "Shaders/ProgramBinaryCache.h"
+#include "Core/ThreadPool.h"
 #include "Application.h"
 
+/****************************************************************************************************/
+/* Initialized before main() */
+static const auto s_ProcessStart = std::chrono::steady_clock::now();
+
 /****************************************************************************************************/
 Application::Application(const Arguments& arguments) :
     PickableApplication{"Quadratic Approximation of Cubic Curves", arguments} {
@@ -27,7 +39,25 @@ Application::Application(const Arguments& arguments) :
     setupCamera();
 
     /* Setup curves */
-    m_Curves.emplace(&m_Scene, &m_Drawables);
+    m_Curves.emplace(&m_Scene);
+    if(!m_Curves->loadError().empty()) {
+        Fatal() << m_Curves->loadError().c_str();
+    }
+
+    /* Startup statistics: with shared programs and sphere meshes, the curve setup time should scale with the data only */
+    m_StartupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_ProcessStart).count();
+    Debug() << "Startup:" << m_StartupTime << "ms, loading points" << m_Curves->startupTimings().loadPoints
+            << "ms, setting up curves" << m_Curves->startupTimings().setupCurves << "ms,"
+            << ResourceCache::programCount() << "shader programs in" << ResourceCache::programTime() << "ms ("
+            << ProgramBinaryCache::hitCount() << "from the binary cache," << ProgramBinaryCache::missCount()
+            << "compiled and cached)," << ResourceCache::sphereCount() << "sphere meshes";
+}
+
+/****************************************************************************************************/
+Application::~Application() {
+    /* The shared GL resources must go before the context */
+    m_Curves = nullptr;
+    ResourceCache::release();
 }
 
 /****************************************************************************************************/
@@ -35,8 +65,9 @@ void Application::drawEvent() {
     GL::defaultFramebuffer.clear(GL::FramebufferClear::Color | GL::FramebufferClear::Depth);
     ImGuiApplication::beginFrame();
 
-    /* Update camera */
+    /* Update camera and the selection of a pending picking readback */
     m_Camera->update();
+    updatePicking();
 
     /* Draw to custom framebuffer */
     m_FrameBuffer
@@ -45,6 +76,16 @@ void Application::drawEvent() {
         .clearDepth(1.0f)
         .bind();
 
+    /* The benchmark draws into the framebuffer many times, which is cleared again afterwards */
+    if(m_bBenchmarkRequested) {
+        m_RenderingBenchmark  = m_Curves->benchmarkQuadraticRendering(m_Camera->camera(), m_FrameBuffer.viewport().size());
+        m_bBenchmarkRequested = false;
+        m_FrameBuffer
+            .clearColor(0, m_BkgColor)
+            .clearColor(1, Vector4ui{})
+            .clearDepth(1.0f);
+    }
+
     /* Draw curves (with control points) */
     m_Curves->draw(m_Camera->camera(), m_FrameBuffer.viewport().size());
 
@@ -80,16 +121,10 @@ void Application::drawEvent() {
             if(editPointTransformation(objMat)) {
                 selectedPoint->setTransformation(objMat); /* Update drawable transformation */
 
-                /* Update the corresponding node's point */
+                /* Update the corresponding node's point and only the curves depending on it */
                 Vector3 translation = objMat[3].xyz();
-                m_Curves->setDataPoint(selectedPoint->idx(), translation);
-
-                /* Update all control points and curves */
+                m_Curves->moveDataPoint(selectedPoint->idx(), translation);
                 m_Curves->saveControlPoints();
-                m_Curves->computeBezierControlPoints();
-                m_Curves->updatePolylines();
-                m_Curves->updateCurveControlPoints();
-                m_Curves->computeCurves();
             }
             ImGui::End();
         }
@@ -102,32 +137,138 @@ void Application::drawEvent() {
 
 /****************************************************************************************************/
 void Application::showMenu() {
+    ImGui::Combo("Picking", &m_PickingMode, "Synchronous readback\0Asynchronous readback\0Ray casting\0");
+    ImGui::Spacing();
+
     if(ImGui::CollapsingHeader("Tessellation and quadratic approximation", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::PushID("Subdivision+Approximation");
+        int nThreads = static_cast<int>(Core::threadCount());
+        if(ImGui::SliderInt("Threads", &nThreads, 1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))) {
+            Core::setThreadCount(static_cast<size_t>(nThreads));
+            m_Curves->updateCurveControlPoints();
+            m_Curves->computeCurves();
+        }
         if(ImGui::SliderInt("Segments", &m_Curves->subdivision(), 1, 128)) {
             m_Curves->computeCurves();
         }
+        if(ImGui::Combo("Evaluation", &m_Curves->tessellationMethod(),
+                        "Bernstein\0Horner\0Forward differencing\0")) {
+            m_Curves->computeCurves();
+        }
+        if(ImGui::Checkbox("Adaptive tessellation", &m_Curves->adaptiveTessellation())) {
+            m_Curves->computeCurves();
+        }
+        if(m_Curves->adaptiveTessellation() &&
+           ImGui::InputFloat("Tolerance", &m_Curves->tessellationTolerance(), 1.0e-4f, 1.0e-3f, "%.5f")) {
+            m_Curves->tessellationTolerance() = std::max(m_Curves->tessellationTolerance(), 1.0e-6f);
+            m_Curves->computeCurves();
+        }
+        if(ImGui::Checkbox("GPU curve evaluation", &m_Curves->gpuCurveEvaluation())) {
+            m_Curves->computeCurves();
+        }
+        ImGui::Text("Tessellated vertices: %zu", m_Curves->tessellatedPointCount());
+        const auto footprint = m_Curves->memoryFootprint();
+        ImGui::Text("Memory: %zu curves (%.1f MB pooled), %zu points (%.1f MB pooled), curve data %.1f MB",
+                    footprint.curves, footprint.curvePoolBytes / 1048576.0, footprint.pointObjects,
+                    footprint.pointPoolBytes / 1048576.0, footprint.curveDataBytes / 1048576.0);
+        ImGui::Text("Startup: %.1f ms (points %.1f ms, curves %.1f ms, shaders %.1f ms)", m_StartupTime,
+                    m_Curves->startupTimings().loadPoints, m_Curves->startupTimings().setupCurves,
+                    ResourceCache::programTime());
         if(ImGui::Checkbox("Bezier from Catmull-Rom", &m_Curves->BezierFromCatmullRom())) {
             m_Curves->computeBezierControlPoints();
             m_Curves->generateCurves();
             m_Curves->computeCurves();
         }
+        /* Joints where the cosine between the segment directions is below -limit get a bevel instead of a
+         * miter (tessellated lines only) */
+        if(ImGui::SliderFloat("Miter limit", &m_Curves->cubicBezierConfig.miterLimit, -1.0f, 1.0f)) {
+            m_Curves->quadC1BezierConfig.miterLimit = m_Curves->cubicBezierConfig.miterLimit;
+            m_Curves->updateCurveConfigs();
+        }
         if(ImGui::Checkbox("Render quadratic Bezier", &m_Curves->quadC1BezierConfig.bEnabled)) {
             m_Curves->updateCurveConfigs();
         }
+        if(m_Curves->quadC1BezierConfig.bEnabled) {
+            if(ImGui::Checkbox("Analytic quadratic strokes", &m_Curves->analyticQuadratics())) {
+                m_Curves->computeCurves();
+            }
+            if(ImGui::Button("Benchmark quadratic rendering")) {
+                m_bBenchmarkRequested = true;
+            }
+            const auto& benchmark = m_RenderingBenchmark;
+            if(benchmark.nFrames > 0) {
+                ImGui::Text("Tessellated:    %.3f ms, %zu vertices (+%.2f ms CPU)", benchmark.tessellatedTime,
+                            benchmark.tessellatedVertices, benchmark.tessellationTime);
+                ImGui::Text("Vertex pulling: %.3f ms, %zu vertices", benchmark.vertexPullingTime,
+                            benchmark.vertexPullingVertices);
+                ImGui::Text("Analytic:       %.3f ms, %zu vertices", benchmark.analyticTime, benchmark.analyticVertices);
+            }
+        }
 
-        if(m_Curves->quadC1BezierConfig.bEnabled &&
-           ImGui::SliderFloat("\\gamma", &m_Curves->gamma(), 0.0f, 1.0f)) {
+        if(ImGui::Combo("\\gamma mode", &m_Curves->gammaMode(),
+                        "Global\0Per-curve optimal (L2)\0Per-curve optimal (max distance)\0")) {
             m_Curves->updateCurveControlPoints();
             m_Curves->computeCurves();
         }
-        ImGui::SameLine();
-        if(ImGui::Button("Set 0.5")) {
-            m_Curves->gamma() = 0.5f;
+        if(ImGui::Checkbox("Tolerance-driven quadratics", &m_Curves->toleranceDrivenQuadratics())) {
             m_Curves->updateCurveControlPoints();
             m_Curves->computeCurves();
         }
+        if(m_Curves->toleranceDrivenQuadratics() &&
+           ImGui::InputFloat("Max distance", &m_Curves->quadraticTolerance(), 1.0e-3f, 1.0e-2f, "%.4f")) {
+            m_Curves->quadraticTolerance() = std::max(m_Curves->quadraticTolerance(), 1.0e-5f);
+            m_Curves->updateCurveControlPoints();
+            m_Curves->computeCurves();
+        }
+        ImGui::Text("Quadratic curves: %zu", m_Curves->quadraticCount());
+        if(m_Curves->clampedChainCount() > 0) {
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.2f, 1.0f), "%zu curves exceed the max distance (%zu pairs limit)",
+                               m_Curves->clampedChainCount(), Core::MaxQuadraticPairsPerCubic);
+        }
+        if(m_Curves->toleranceDrivenQuadratics() ||
+           m_Curves->gammaMode() == static_cast<int>(QuadraticCurveApproximation::GammaMode::Global)) {
+            if(m_Curves->quadC1BezierConfig.bEnabled &&
+               ImGui::SliderFloat("\\gamma", &m_Curves->gamma(), 0.0f, 1.0f)) {
+                m_Curves->updateCurveControlPoints();
+                m_Curves->computeCurves();
+            }
+            ImGui::SameLine();
+            if(ImGui::Button("Set 0.5")) {
+                m_Curves->gamma() = 0.5f;
+                m_Curves->updateCurveControlPoints();
+                m_Curves->computeCurves();
+            }
+        }
+
+        ImGui::PopID();
+    }
+
+    if(ImGui::CollapsingHeader("Approximation error")) {
+        ImGui::PushID("ApproximationError");
+        if(ImGui::Checkbox("Evaluate errors", &m_Curves->evaluateErrors())) {
+            m_Curves->updateErrors();
+        }
+        if(m_Curves->evaluateErrors()) {
+            if(ImGui::Combo("Hausdorff", &m_Curves->hausdorffMethod(), "Sampled\0Exact\0")) {
+                m_Curves->updateErrors();
+            }
 
+            const auto& hausdorff = m_Curves->hausdorffDistances();
+            const auto& l2        = m_Curves->l2Errors();
+            if(!hausdorff.empty()) {
+                ImGui::Text("Max Hausdorff distance: %.3e", *std::max_element(hausdorff.begin(), hausdorff.end()));
+                ImGui::Text("Max L2 error: %.3e", *std::max_element(l2.begin(), l2.end()));
+                ImGui::BeginChild("Per-curve errors", ImVec2(0.0f, 150.0f), true);
+                ImGuiListClipper clipper;
+                clipper.Begin(static_cast<int>(hausdorff.size()));
+                while(clipper.Step()) {
+                    for(int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                        ImGui::Text("Curve %d: Hausdorff %.3e, L2 %.3e", i, hausdorff[i], l2[i]);
+                    }
+                }
+                ImGui::EndChild();
+            }
+        }
         ImGui::PopID();
     }
 }
@@ -23,6 +23,7 @@
 class Application : public PickableApplication {
 public:
     explicit Application(const Arguments& arguments);
+    ~Application() override;
 
 protected:
     void drawEvent() override;
@@ -30,6 +31,13 @@ protected:
 
     /* Quadratic approximation object */
     Containers::Pointer<QuadraticCurveApproximation> m_Curves { nullptr };
+
+    /* Time from process start to the end of the constructor, in milliseconds */
+    double m_StartupTime { 0.0 };
+
+    /* Quadratic rendering benchmark, run at the next frame when requested from the menu */
+    bool m_bBenchmarkRequested { false };
+    QuadraticCurveApproximation::RenderingBenchmark m_RenderingBenchmark;
 };
 
 /****************************************************************************************************/
@@ -16,13 +16,36 @@
 
 #include "Application/PickableApplication.h"
 #include "DrawableObjects/PickableObject.h"
+#include "Shaders/InstancedSphereShader.h"
 
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/PixelFormat.h>
 #include <Magnum/Image.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include <cstring>
 
 #include <ImGuizmo.h>
 
+/****************************************************************************************************/
+namespace {
+uint32_t decodeObjectIdx(const char* data, PixelFormat format) {
+    if(format == PixelFormat::R8UI) {
+        return static_cast<uint32_t>(static_cast<uint8_t>(data[0]));
+    } else if(format == PixelFormat::R16UI) {
+        uint16_t idx;
+        std::memcpy(&idx, data, sizeof(idx));
+        return idx;
+    } else if(format == PixelFormat::R32UI) {
+        uint32_t idx;
+        std::memcpy(&idx, data, sizeof(idx));
+        return idx;
+    }
+    Fatal{} << "Invalid pixel format";
+    return 0;
+}
+}
+
 /****************************************************************************************************/
 PickableApplication::PickableApplication(const std::string& title, const Arguments& arguments,
                                          size_t indexDataSize, const Vector2i& defaultWindowSize) :
@@ -51,6 +74,8 @@ PickableApplication::PickableApplication(const std::string& title, const Argumen
         Fatal{} << "Invalid index data size type";
     }
 
+    m_PickImage = GL::BufferImage2D{ m_PixelFormat };
+
     m_RBObjectIdx = GL::Renderbuffer{};
     m_RBObjectIdx.setStorage(m_IndexFormat, GL::defaultFramebuffer.viewport().size());
 
@@ -61,11 +86,18 @@ PickableApplication::PickableApplication(const std::string& title, const Argumen
     m_FrameBuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{ 0 }, m_RBColor)
         .attachRenderbuffer(GL::Framebuffer::ColorAttachment{ 1 }, m_RBObjectIdx)
         .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth,  m_RBDepth)
-        .mapForDraw({ { Shaders::Phong::ColorOutput, GL::Framebuffer::ColorAttachment{ 0 } },
-                        { Shaders::Phong::ObjectIdOutput, GL::Framebuffer::ColorAttachment{ 1 } } });
+        .mapForDraw({ { InstancedSphereShader::ColorOutput, GL::Framebuffer::ColorAttachment{ 0 } },
+                        { InstancedSphereShader::ObjectIdOutput, GL::Framebuffer::ColorAttachment{ 1 } } });
     CORRADE_INTERNAL_ASSERT(m_FrameBuffer.checkStatus(GL::FramebufferTarget::Draw) == GL::Framebuffer::Status::Complete);
 }
 
+/****************************************************************************************************/
+PickableApplication::~PickableApplication() {
+    if(m_PickFence) {
+        glDeleteSync(m_PickFence);
+    }
+}
+
 /****************************************************************************************************/
 void PickableApplication::viewportEvent(ViewportEvent& event) {
     ImGuiApplication::viewportEvent(event);
@@ -77,7 +109,7 @@ void PickableApplication::viewportEvent(ViewportEvent& event) {
     /* Resize buffers */
     const auto viewport = GL::defaultFramebuffer.viewport();
     m_RBColor.setStorage(GL::RenderbufferFormat::RGBA8, viewport.size());
-    m_RBObjectIdx.setStorage(GL::RenderbufferFormat::R16UI, viewport.size());
+    m_RBObjectIdx.setStorage(m_IndexFormat, viewport.size());
     m_RBDepth.setStorage(GL::RenderbufferFormat::DepthComponent24, viewport.size());
     m_FrameBuffer.setViewport(viewport);
 }
@@ -89,32 +121,63 @@ void PickableApplication::mousePressEvent(MouseEvent& event) {
         return;
     }
 
+    if(m_PickingMode == static_cast<int>(PickingMode::RayCast)) {
+        /* Unproject the cursor on the near and far planes */
+        const Vector2 ndc = Vector2{ event.position() } / Vector2{ windowSize() } * Vector2{ 2.0f, -2.0f } +
+                            Vector2{ -1.0f, 1.0f };
+        const Matrix4 invViewProj = (m_Camera->camera().projectionMatrix() * m_Camera->viewMatrix()).inverted();
+        const Vector4 nearPoint   = invViewProj * Vector4{ ndc, -1.0f, 1.0f };
+        const Vector4 farPoint    = invViewProj * Vector4{ ndc, 1.0f, 1.0f };
+        const Vector3 origin      = nearPoint.xyz() / nearPoint.w();
+        const Vector3 direction   = farPoint.xyz() / farPoint.w() - origin;
+
+        const auto obj = PickableObject::pickByRay(origin, direction);
+        PickableObject::updateSelectedObject(obj ? obj->idx() : 0);
+        event.setAccepted();
+        return;
+    }
+
     /* Update picking object
      * Read object ID at given click position (framebuffer has Y up while windowing system Y down)
      * If is there any active text edit, then just deselect object
      */
     m_FrameBuffer.mapForRead(GL::Framebuffer::ColorAttachment{ 1 });
-    Image2D data = m_FrameBuffer.read(
-        Range2Di::fromSize({ event.position().x(),
-                             m_FrameBuffer.viewport().sizeY() - event.position().y() - 1 },
-                           { 1, 1 }),
-        { m_PixelFormat });
-
-    uint32_t idx = 0;
-    if(m_PixelFormat == PixelFormat::R8UI) {
-        idx = static_cast<uint32_t>(data.data()[0]);
-    } else if(m_PixelFormat == PixelFormat::R16UI) {
-        idx = static_cast<uint32_t>(Containers::arrayCast<uint16_t>(data.data())[0]);
-    } else if(m_PixelFormat == PixelFormat::R32UI) {
-        idx = Containers::arrayCast<uint32_t>(data.data())[0];
+    const auto pixel = Range2Di::fromSize({ event.position().x(),
+                                            m_FrameBuffer.viewport().sizeY() - event.position().y() - 1 },
+                                          { 1, 1 });
+    if(m_PickingMode == static_cast<int>(PickingMode::Asynchronous)) {
+        /* The copy into the pixel buffer is queued behind the rendering, a newer click replaces a pending one */
+        m_FrameBuffer.read(pixel, m_PickImage, GL::BufferUsage::StreamRead);
+        if(m_PickFence) {
+            glDeleteSync(m_PickFence);
+        }
+        m_PickFence            = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_PickDestructionCount = PickableObject::destructionCount();
     } else {
-        Fatal{} << "Invalid pixel format";
+        Image2D data = m_FrameBuffer.read(pixel, { m_PixelFormat });
+        PickableObject::updateSelectedObject(decodeObjectIdx(data.data(), m_PixelFormat));
     }
-
-    PickableObject::updateSelectedObject(idx);
     event.setAccepted();
 }
 
+/****************************************************************************************************/
+void PickableApplication::updatePicking() {
+    if(!m_PickFence || glClientWaitSync(m_PickFence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED) {
+        return;
+    }
+    glDeleteSync(m_PickFence);
+    m_PickFence = nullptr;
+
+    /* Freed IDs are reused, so the ID may name an object created after the click */
+    if(PickableObject::destructionCount() != m_PickDestructionCount) {
+        return;
+    }
+
+    /* The copy is done, so reading the buffer back does not stall */
+    const auto data = m_PickImage.buffer().data();
+    PickableObject::updateSelectedObject(decodeObjectIdx(data.data(), m_PixelFormat));
+}
+
 /****************************************************************************************************/
 bool PickableApplication::editPointTransformation(Matrix4& objMat) {
     const auto camMat = m_Camera->viewMatrix();
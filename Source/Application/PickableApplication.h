@@ -20,7 +20,9 @@
 
 #include <Magnum/Magnum.h>
 #include <Magnum/PixelFormat.h>
+#include <Magnum/GL/BufferImage.h>
 #include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/OpenGL.h>
 #include <Magnum/GL/Renderbuffer.h>
 #include <Magnum/GL/RenderbufferFormat.h>
 
@@ -32,11 +34,20 @@ public:
     explicit PickableApplication(const std::string& title, const Arguments& arguments,
                                  size_t indexDataSize = 16,
                                  const Vector2i& defaultWindowSize = Vector2i{ 1920, 1080 });
+    ~PickableApplication();
+
+    /* Synchronous: read the object ID under the cursor, stalling until the frame is rendered
+     * Asynchronous: copy the object ID into a pixel buffer, resolved by updatePicking() once the copy is done
+     * RayCast: intersect the camera ray with the selectable objects on the CPU, without framebuffer access */
+    enum class PickingMode { Synchronous = 0, Asynchronous, RayCast };
 
 protected:
     void viewportEvent(ViewportEvent& event) override;
     void mousePressEvent(MouseEvent& event) override;
 
+    /* Select the object of a finished asynchronous readback, to be called once per frame */
+    void updatePicking();
+
     bool editPointTransformation(Matrix4& objMat);
     void setPointTransformation(size_t selectedObjID, const Matrix4& objMat,
                                 Containers::Array<Vector3>& points);
@@ -46,6 +57,12 @@ protected:
     PixelFormat                          m_PixelFormat { PixelFormat::R16UI };
     std::unordered_map<uint32_t, size_t> m_mDrawableIdxToPointIdx;
 
+    /* Picking */
+    int               m_PickingMode { static_cast<int>(PickingMode::Asynchronous) };
+    GL::BufferImage2D m_PickImage { NoCreate };
+    GLsync            m_PickFence { nullptr };
+    uint64_t          m_PickDestructionCount { 0 }; /* PickableObject::destructionCount() at the click */
+
     /* Framebuffer and render bufers */
     GL::Framebuffer  m_FrameBuffer { NoCreate };
     GL::Renderbuffer m_RBColor{ NoCreate };
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/AsyncSaver.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+/****************************************************************************************************/
+Core::AsyncSaver::AsyncSaver(std::chrono::milliseconds minInterval /*= std::chrono::milliseconds(250)*/) :
+    m_MinInterval(minInterval), m_LastWrite(Clock::now() - minInterval) {
+    m_Worker = std::thread([this] { workerLoop(); });
+}
+
+/****************************************************************************************************/
+Core::AsyncSaver::~AsyncSaver() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStop = true;
+    }
+    m_Wake.notify_one();
+    m_Worker.join();
+}
+
+/****************************************************************************************************/
+void Core::AsyncSaver::save(const std::string& path, Writer writer) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        const auto it = std::find_if(m_Pending.begin(), m_Pending.end(),
+                                     [&](const Pending& pending) { return pending.path == path; });
+        if(it != m_Pending.end()) {
+            it->writer = std::move(writer);
+        } else {
+            m_Pending.push_back(Pending{ path, std::move(writer) });
+        }
+    }
+    m_Wake.notify_one();
+}
+
+/****************************************************************************************************/
+void Core::AsyncSaver::flush() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_bFlush = true;
+    m_Wake.notify_one();
+    m_Idle.wait(lock, [this] { return m_Pending.empty() && !m_bWriting; });
+}
+
+/****************************************************************************************************/
+std::string Core::AsyncSaver::lastError() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_LastError;
+}
+
+/****************************************************************************************************/
+void Core::AsyncSaver::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while(true) {
+        if(m_Pending.empty()) {
+            m_bFlush = false;
+            m_Idle.notify_all();
+            if(m_bStop) {
+                break;
+            }
+            m_Wake.wait(lock);
+            continue;
+        }
+
+        /* Rate limit, unless the saves are forced out */
+        const auto notBefore = m_LastWrite + m_MinInterval;
+        if(!m_bStop && !m_bFlush && Clock::now() < notBefore) {
+            m_Wake.wait_until(lock, notBefore);
+            continue;
+        }
+
+        /* Write the oldest pending save without holding the lock, so that save() never waits on disk */
+        auto pending = std::move(m_Pending.front());
+        m_Pending.erase(m_Pending.begin());
+        m_bWriting = true;
+        lock.unlock();
+        write(pending.path, pending.writer);
+        lock.lock();
+        m_bWriting  = false;
+        m_LastWrite = Clock::now();
+    }
+}
+
+/****************************************************************************************************/
+void Core::AsyncSaver::write(const std::string& path, const Writer& writer) {
+    const auto      tempPath = path + ".tmp";
+    std::string     error;
+    std::error_code ec;
+    if(!writer(tempPath)) {
+        error = "cannot write " + tempPath;
+    } else {
+        std::filesystem::rename(tempPath, path, ec);
+        if(ec) {
+            error = "cannot rename " + tempPath + " to " + path + ": " + ec.message();
+        }
+    }
+    if(!error.empty()) {
+        std::remove(tempPath.c_str());
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_LastError = error;
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/****************************************************************************************************/
+/* Background file saving for interactive edits.
+ *
+ * save() only queues a writer function, which owns a snapshot of the data to save. A queued save
+ * replaces any pending one for the same path, so a burst of edits costs a single write of the newest
+ * data. Consecutive writes are spaced by at least minInterval, and are atomic: the writer fills a
+ * temporary file next to the target, which is then renamed over it.
+ */
+namespace Core {
+class AsyncSaver {
+public:
+    /* Fill the file at tempPath, returns false on failure */
+    using Writer = std::function<bool(const std::string& tempPath)>;
+
+    explicit AsyncSaver(std::chrono::milliseconds minInterval = std::chrono::milliseconds(250));
+    /* Pending saves are written before returning */
+    ~AsyncSaver();
+    AsyncSaver(const AsyncSaver&) = delete;
+    AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+    void save(const std::string& path, Writer writer);
+
+    /* Write all pending saves now and wait for them */
+    void flush();
+
+    /* Message of the last failed write, empty if the last write succeeded */
+    std::string lastError() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Pending {
+        std::string path;
+        Writer      writer;
+    };
+
+    void workerLoop();
+    void write(const std::string& path, const Writer& writer);
+
+    const std::chrono::milliseconds m_MinInterval;
+    mutable std::mutex              m_Mutex;
+    std::condition_variable         m_Wake;
+    std::condition_variable         m_Idle;
+    std::vector<Pending>            m_Pending;
+    Clock::time_point               m_LastWrite;
+    std::string                     m_LastError;
+    bool                            m_bWriting { false };
+    bool                            m_bFlush { false };
+    bool                            m_bStop { false };
+    std::thread                     m_Worker;
+};
+} // namespace Core
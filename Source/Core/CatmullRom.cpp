@@ -0,0 +1,140 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/CpuFeatures.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+/****************************************************************************************************/
+namespace {
+using Core::CatmullRomParameterization;
+using Core::Point3;
+
+/* Number of curves converted per block. Segment powers of a block live on the stack */
+constexpr size_t BlockSize = 256;
+
+/* Number of curves per task of the thread pool */
+constexpr size_t GrainSize = 16 * BlockSize;
+
+/* powers[s] = |points[s + 1] - points[s]|^alpha for nSegments consecutive segments */
+template<CatmullRomParameterization parameterization>
+void computeSegmentPowers(const Point3* points, size_t nSegments, float alpha, float* powers) {
+    if constexpr (parameterization == CatmullRomParameterization::Uniform) {
+        std::fill(powers, powers + nSegments, 1.0f);
+        return;
+    }
+
+    for(size_t s = 0; s < nSegments; ++s) {
+        powers[s] = lengthSquared(points[s + 1] - points[s]);
+    }
+    if constexpr (parameterization == CatmullRomParameterization::Centripetal) {
+        for(size_t s = 0; s < nSegments; ++s) {
+            powers[s] = std::sqrt(std::sqrt(powers[s]));
+        }
+    } else if constexpr (parameterization == CatmullRomParameterization::Chordal) {
+        for(size_t s = 0; s < nSegments; ++s) {
+            powers[s] = std::sqrt(powers[s]);
+        }
+    } else {
+        switch(Core::simdLevel()) {
+            case Core::SimdLevel::AVX512:
+                Core::Kernels::powLengthsAVX512(powers, nSegments, alpha, powers);
+                break;
+            case Core::SimdLevel::AVX2:
+                Core::Kernels::powLengthsAVX2(powers, nSegments, alpha, powers);
+                break;
+            case Core::SimdLevel::SSE:
+                Core::Kernels::powLengthsSSE(powers, nSegments, alpha, powers);
+                break;
+            default:
+                Core::Kernels::powLengthsScalar(powers, nSegments, alpha, powers);
+        }
+    }
+}
+
+/****************************************************************************************************/
+/* Convert the curves [begin, end) in blocks */
+template<CatmullRomParameterization parameterization>
+void convertCurves(const Point3* points, size_t begin, size_t end, float alpha, Point3* cubicControlPoints) {
+    float powers[BlockSize + 2];
+    for(size_t blockStart = begin; blockStart < end; blockStart += BlockSize) {
+        const auto blockSize = std::min(BlockSize, end - blockStart);
+
+        /* Curve i uses segments i, i + 1 and i + 2, so each segment power is computed only once
+         * instead of six pow() calls per curve */
+        computeSegmentPowers<parameterization>(&points[blockStart], blockSize + 2, alpha, powers);
+
+        for(size_t i = 0; i < blockSize; ++i) {
+            const Point3* P = &points[blockStart + i];
+            Point3*       B = &cubicControlPoints[(blockStart + i) * 4];
+            B[0] = P[1];
+            B[3] = P[2];
+
+            if constexpr (parameterization == CatmullRomParameterization::Uniform) {
+                B[1] = P[1] + (P[2] - P[0]) / 6.0f;
+                B[2] = P[2] + (P[1] - P[3]) / 6.0f;
+            } else {
+                const auto d1_alpha  = powers[i];
+                const auto d2_alpha  = powers[i + 1];
+                const auto d3_alpha  = powers[i + 2];
+                const auto d1_2alpha = d1_alpha * d1_alpha;
+                const auto d2_2alpha = d2_alpha * d2_alpha;
+                const auto d3_2alpha = d3_alpha * d3_alpha;
+                B[1] = (d1_2alpha * P[2] - d2_2alpha * P[0] +
+                        (2.0f * d1_2alpha + 3.0f * d1_alpha * d2_alpha + d2_2alpha) * P[1]) /
+                       (3.0f * d1_alpha * (d1_alpha + d2_alpha));
+                B[2] = (d3_2alpha * P[1] - d2_2alpha * P[3] +
+                        (2.0f * d3_2alpha + 3.0f * d3_alpha * d2_alpha + d2_2alpha) * P[2]) /
+                       (3.0f * d3_alpha * (d3_alpha + d2_alpha));
+            }
+        }
+    }
+}
+}
+
+/****************************************************************************************************/
+template<CatmullRomParameterization parameterization>
+size_t Core::catmullRomToCubics(const Point3* points, size_t nPoints, float alpha,
+                                Point3* cubicControlPoints) {
+    const auto nCurves = catmullRomCurveCount(nPoints);
+
+    /* Curves only read their own window of data points, tasks write disjoint ranges of control points */
+    threadPool()->parallelFor(0, nCurves, GrainSize, [&](size_t begin, size_t end) {
+                                  convertCurves<parameterization>(points, begin, end, alpha, cubicControlPoints);
+                              });
+    return nCurves;
+}
+
+template size_t Core::catmullRomToCubics<CatmullRomParameterization::Uniform>(const Point3*, size_t, float, Point3*);
+template size_t Core::catmullRomToCubics<CatmullRomParameterization::Centripetal>(const Point3*, size_t, float, Point3*);
+template size_t Core::catmullRomToCubics<CatmullRomParameterization::Chordal>(const Point3*, size_t, float, Point3*);
+template size_t Core::catmullRomToCubics<CatmullRomParameterization::Generic>(const Point3*, size_t, float, Point3*);
+
+/****************************************************************************************************/
+size_t Core::catmullRomToCubics(const Point3* points, size_t nPoints, float alpha,
+                                Point3* cubicControlPoints) {
+    if(alpha == 0.0f) {
+        return catmullRomToCubics<CatmullRomParameterization::Uniform>(points, nPoints, alpha, cubicControlPoints);
+    } else if(alpha == 0.5f) {
+        return catmullRomToCubics<CatmullRomParameterization::Centripetal>(points, nPoints, alpha, cubicControlPoints);
+    } else if(alpha == 1.0f) {
+        return catmullRomToCubics<CatmullRomParameterization::Chordal>(points, nPoints, alpha, cubicControlPoints);
+    }
+    return catmullRomToCubics<CatmullRomParameterization::Generic>(points, nPoints, alpha, cubicControlPoints);
+}
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CpuFeatures.h"
+
+#include <atomic>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/****************************************************************************************************/
+namespace {
+Core::SimdLevel detect() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) {
+        return Core::SimdLevel::AVX512;
+    }
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Core::SimdLevel::AVX2;
+    }
+    if(__builtin_cpu_supports("sse2")) {
+        return Core::SimdLevel::SSE;
+    }
+    return Core::SimdLevel::Scalar;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 1);
+    const bool sse2    = (info[3] & (1 << 26)) != 0;
+    const bool fma     = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const auto xcr0    = osxsave ? _xgetbv(0) : 0;
+    __cpuidex(info, 7, 0);
+    const bool avx2    = (info[1] & (1 << 5)) != 0;
+    const bool avx512f = (info[1] & (1 << 16)) != 0;
+    if(avx512f && (xcr0 & 0xe6) == 0xe6) {
+        return Core::SimdLevel::AVX512;
+    }
+    if(avx2 && fma && (xcr0 & 0x6) == 0x6) {
+        return Core::SimdLevel::AVX2;
+    }
+    return sse2 ? Core::SimdLevel::SSE : Core::SimdLevel::Scalar;
+#else
+    return Core::SimdLevel::Scalar;
+#endif
+}
+
+std::atomic<int> s_SimdLevel { -1 };
+}
+
+/****************************************************************************************************/
+Core::SimdLevel Core::detectSimdLevel() {
+    static const SimdLevel s_Detected = detect();
+    return s_Detected;
+}
+
+/****************************************************************************************************/
+Core::SimdLevel Core::simdLevel() {
+    const int level = s_SimdLevel.load(std::memory_order_relaxed);
+    return level < 0 ? detectSimdLevel() : static_cast<SimdLevel>(level);
+}
+
+/****************************************************************************************************/
+void Core::setSimdLevel(SimdLevel level) {
+    const auto detected = detectSimdLevel();
+    s_SimdLevel.store(static_cast<int>(level > detected ? detected : level), std::memory_order_relaxed);
+}
+
+/****************************************************************************************************/
+const char* Core::simdLevelName(SimdLevel level) {
+    switch(level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+    }
+    return "Unknown";
+}
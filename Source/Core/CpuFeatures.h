@@ -0,0 +1,38 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/****************************************************************************************************/
+/* Runtime selection of the SIMD code paths used by the batch kernels */
+namespace Core {
+enum class SimdLevel {
+    Scalar,
+    SSE,    /* 4 floats per register */
+    AVX2,   /* 8 floats per register */
+    AVX512 /* 16 floats per register */
+};
+
+/* Highest SIMD level supported by the CPU and the operating system, detected once */
+SimdLevel detectSimdLevel();
+
+/* SIMD level used by the batch kernels. Defaults to detectSimdLevel() and can be lowered (for
+ * example to compare code paths in benchmarks). Requests above the detected level are clamped */
+SimdLevel simdLevel();
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+} // namespace Core
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+/****************************************************************************************************/
+namespace {
+using Core::Point3;
+
+/* Curves transposed to SoA at once by the conversions, small enough for the blocks to stay in L1 */
+constexpr size_t ConversionBlockSize = 256;
+
+inline float gammasFrom(float gamma, size_t) { return gamma; }
+inline const float* gammasFrom(const float* gammas, size_t first) { return gammas + first; }
+
+/* Convert curves [begin, end) in blocks: transpose to SoA, run the SIMD kernel, transpose back */
+template<class Gamma>
+void convertCubicsToQuadraticsBlocked(const Point3* cubicControlPoints, size_t begin, size_t end, Gamma gamma,
+                                      Point3* quadraticControlPoints) {
+    alignas(64) float  cubics[4][3][ConversionBlockSize];
+    alignas(64) float  quadratics[5][3][ConversionBlockSize];
+    Core::CubicSoA     cubicView;
+    Core::QuadraticSoA quadraticView;
+    for(size_t axis = 0; axis < 3; ++axis) {
+        for(size_t k = 0; k < 4; ++k) {
+            cubicView.B[k][axis] = cubics[k][axis];
+        }
+        for(size_t k = 0; k < 5; ++k) {
+            quadraticView.Q[k][axis] = quadratics[k][axis];
+        }
+    }
+
+    for(size_t first = begin; first < end; first += ConversionBlockSize) {
+        const size_t  n = std::min(ConversionBlockSize, end - first);
+        const Point3* B = &cubicControlPoints[first * 4];
+        for(size_t i = 0; i < n; ++i) {
+            for(size_t k = 0; k < 4; ++k) {
+                cubics[k][0][i] = B[i * 4 + k].x;
+                cubics[k][1][i] = B[i * 4 + k].y;
+                cubics[k][2][i] = B[i * 4 + k].z;
+            }
+        }
+
+        Core::Kernels::convertCubicsToQuadratics(cubicView, n, gammasFrom(gamma, first), quadraticView);
+
+        Point3* Q = &quadraticControlPoints[first * 5];
+        for(size_t i = 0; i < n; ++i) {
+            for(size_t k = 0; k < 5; ++k) {
+                Q[i * 5 + k] = Point3{ quadratics[k][0][i], quadratics[k][1][i], quadratics[k][2][i] };
+            }
+        }
+    }
+}
+}
+
+/****************************************************************************************************/
+void Core::convertCubicsToQuadratics(const Point3* cubicControlPoints, size_t nCurves, float gamma,
+                                     Point3* quadraticControlPoints) {
+    threadPool()->parallelFor(0, nCurves, Core::Kernels::ConversionGrainSize, [&](size_t begin, size_t end) {
+                                  convertCubicsToQuadraticsBlocked(cubicControlPoints, begin, end, gamma,
+                                                                   quadraticControlPoints);
+                              });
+}
+
+/****************************************************************************************************/
+void Core::convertCubicsToQuadratics(const Point3* cubicControlPoints, size_t nCurves, const float* gammas,
+                                     Point3* quadraticControlPoints) {
+    threadPool()->parallelFor(0, nCurves, Core::Kernels::ConversionGrainSize, [&](size_t begin, size_t end) {
+                                  convertCubicsToQuadraticsBlocked(cubicControlPoints, begin, end, gammas,
+                                                                   quadraticControlPoints);
+                              });
+}
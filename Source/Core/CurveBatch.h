@@ -0,0 +1,136 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+#include <cstddef>
+#include <vector>
+
+/****************************************************************************************************/
+/* Batch curve operations of the headless core library.
+ * All functions work on flat, caller-allocated arrays and have no dependency on GL, SceneGraph or
+ * ImGui, so they can be used by the viewer as well as by batch tools running without a GL context.
+ *
+ * Layouts:
+ *  - Cubic Bezier curves:   4 consecutive control points per curve (B0, B1, B2, B3)
+ *  - Quadratic C1 pairs:    5 consecutive control points per curve (Q0, Q1, Q2, Q3, Q4)
+ *  - Tessellated curves:    (subdivision + 1) consecutive points per curve
+ */
+namespace Core {
+enum class CurveType {
+    CubicBezier,
+    QuadraticPair
+};
+
+/* Number of control points of a single curve of the given type */
+inline constexpr size_t controlPointCount(CurveType type) {
+    return type == CurveType::CubicBezier ? 4 : 5;
+}
+
+/* Number of cubic curves generated from a Catmull-Rom spline through nPoints data points */
+inline constexpr size_t catmullRomCurveCount(size_t nPoints) {
+    return nPoints < 4 ? 0 : nPoints - 3;
+}
+
+/* Curve evaluation strategies of tessellate():
+ *  - Bernstein:           full Bernstein form at every sample (reference)
+ *  - Horner:              power basis evaluated with Horner's rule
+ *  - ForwardDifferencing: power basis stepped with forward differences (3 additions per sample)
+ * Horner and ForwardDifferencing evaluate the two halves of a quadratic pair in separate, branch-free
+ * loops, while Bernstein selects the half per sample */
+enum class TessellationMethod {
+    Bernstein,
+    Horner,
+    ForwardDifferencing
+};
+
+/* Number of points generated by tessellate() */
+inline constexpr size_t tessellatedPointCount(size_t nCurves, int subdivision) {
+    return nCurves * static_cast<size_t>(subdivision + 1);
+}
+
+/* Convert each cubic Bezier curve into a pair of C1 quadratic Bezier curves.
+ * quadraticControlPoints must hold 5 * nCurves points */
+void convertCubicsToQuadratics(const Point3* cubicControlPoints, size_t nCurves, float gamma,
+                               Point3* quadraticControlPoints);
+
+/* Same as above, with one gamma value per curve (see GammaSolver.h) */
+void convertCubicsToQuadratics(const Point3* cubicControlPoints, size_t nCurves, const float* gammas,
+                               Point3* quadraticControlPoints);
+
+/* Conversion of a single curve, for the solvers calling it in their inner loops: the batch versions
+ * above dispatch to the thread pool and the SIMD kernels, which only pays off for many curves */
+inline void convertCubicToQuadratics(const Point3* B, float gamma, Point3* Q) {
+    Q[0] = B[0];
+    Q[4] = B[3];
+    Q[1] = B[0] + 1.5f * gamma * (B[1] - B[0]);
+    Q[3] = B[3] - 1.5f * (1.0f - gamma) * (B[3] - B[2]);
+    Q[2] = (1.0f - gamma) * Q[1] + gamma * Q[3];
+}
+
+/* Convert a Catmull-Rom spline with parameterization alpha into cubic Bezier curves, one curve per
+ * window of 4 data points. cubicControlPoints must hold 4 * catmullRomCurveCount(nPoints) points.
+ * Alpha values 0, 0.5 and 1 are dispatched to the specializations below.
+ * Returns the number of generated curves */
+size_t catmullRomToCubics(const Point3* points, size_t nPoints, float alpha,
+                          Point3* cubicControlPoints);
+
+/* Catmull-Rom parameterizations with compile-time specializations of d^alpha:
+ * uniform (alpha = 0) gives 1, centripetal (alpha = 0.5) gives sqrt(d), chordal (alpha = 1) gives d.
+ * Generic evaluates d^alpha once per segment with the SIMD powLengths kernel */
+enum class CatmullRomParameterization {
+    Uniform,
+    Centripetal,
+    Chordal,
+    Generic
+};
+
+/* Same as above, with the parameterization known at compile time (alpha is only used by Generic).
+ * Writes directly into cubicControlPoints and does not allocate */
+template<CatmullRomParameterization parameterization>
+size_t catmullRomToCubics(const Point3* points, size_t nPoints, float alpha,
+                          Point3* cubicControlPoints);
+
+/* Evaluate curves at (subdivision + 1) uniformly spaced parameters.
+ * points must hold tessellatedPointCount(nCurves, subdivision) points */
+void tessellate(CurveType type, const Point3* controlPoints, size_t nCurves, int subdivision,
+                Point3* points, TessellationMethod method = TessellationMethod::Horner);
+
+/* Same as above, resizing points once to the exact output size */
+void tessellate(CurveType type, const Point3* controlPoints, size_t nCurves, int subdivision,
+                std::vector<Point3>& points, TessellationMethod method = TessellationMethod::Horner);
+
+/* Single curve on the calling thread, for callers already running one task per curve: the batch
+ * versions above go through the shared thread pool for every call */
+void tessellateCurve(CurveType type, const Point3* controlPoints, int subdivision, Point3* points,
+                     TessellationMethod method = TessellationMethod::Horner);
+
+/* Adaptive tessellation: the polyline deviates from the curve by at most tolerance.
+ * Cubics are recursively split (de Casteljau at t = 0.5) until the flatness bound of each piece
+ * (distance to its chord <= sqrt(sum_i max(u_i^2, v_i^2)) / 4, u = 3B1 - 2B0 - B3, v = 3B2 - B0 - 2B3)
+ * is below tolerance. Each quadratic half is sampled uniformly with the exact segment count
+ * n = ceil(sqrt(|Q0 - 2Q1 + Q2| / (4 * tolerance))).
+ *
+ * appendAdaptiveTessellation() appends the points of one curve (both end points included).
+ * The batch version writes the points of all curves, with the points of curve i in
+ * [offsets[i], offsets[i + 1]) */
+void appendAdaptiveTessellation(CurveType type, const Point3* controlPoints, float tolerance,
+                                std::vector<Point3>& points);
+void tessellateAdaptive(CurveType type, const Point3* controlPoints, size_t nCurves, float tolerance,
+                        std::vector<Point3>& points, std::vector<size_t>& offsets);
+} // namespace Core
@@ -0,0 +1,203 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+/****************************************************************************************************/
+namespace {
+size_t coordinateSize(Core::CurveFilePrecision precision) {
+    return precision == Core::CurveFilePrecision::Float64 ? sizeof(double) : sizeof(float);
+}
+
+/* Points per write of a Float64 file, converted in a fixed buffer */
+constexpr size_t ConversionBatch = 4096;
+
+/* The file layout is little endian and mapped as is */
+bool isLittleEndianHost() {
+    const uint32_t one = 1;
+    unsigned char  firstByte;
+    std::memcpy(&firstByte, &one, 1);
+    return firstByte == 1;
+}
+
+const char* const BigEndianError = "curve files are not supported on big endian hosts";
+}
+
+/****************************************************************************************************/
+bool Core::isCurveFile(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if(!file) {
+        return false;
+    }
+    char       magic[sizeof(CurveFileMagic)];
+    const auto bMagic = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                        std::memcmp(magic, CurveFileMagic, sizeof(magic)) == 0;
+    std::fclose(file);
+    return bMagic;
+}
+
+/****************************************************************************************************/
+bool Core::MappedCurveFile::open(const std::string& path) {
+    m_Error.clear();
+    if(!isLittleEndianHost()) {
+        m_Error = BigEndianError;
+        return false;
+    }
+    if(!m_File.open(path)) {
+        m_Error = m_File.error();
+        return false;
+    }
+    if(m_File.size() < sizeof(CurveFileHeader)) {
+        m_Error = path + " is too small to be a curve file";
+        close();
+        return false;
+    }
+
+    /* Validate the header before exposing any data */
+    const auto& h = header();
+    if(std::memcmp(h.magic, CurveFileMagic, sizeof(CurveFileMagic)) != 0) {
+        m_Error = path + " is not a curve file";
+    } else if(h.version != CurveFileVersion) {
+        m_Error = path + ": unsupported version " + std::to_string(h.version);
+    } else if(h.topology != CurveFileTopology::CubicBezier && h.topology != CurveFileTopology::QuadraticPair &&
+              h.topology != CurveFileTopology::CatmullRom) {
+        m_Error = path + ": unknown topology";
+    } else if(h.precision != CurveFilePrecision::Float32 && h.precision != CurveFilePrecision::Float64) {
+        m_Error = path + ": unknown precision";
+    } else if(h.dataOffset < sizeof(CurveFileHeader) || h.dataOffset % CurveFileAlignment != 0 ||
+              h.dataOffset > m_File.size() ||
+              h.pointCount > (m_File.size() - h.dataOffset) / (3 * coordinateSize(h.precision))) {
+        m_Error = path + ": truncated or corrupted data";
+    }
+    if(!m_Error.empty()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/****************************************************************************************************/
+const Core::Point3* Core::MappedCurveFile::points() const {
+    return header().precision == CurveFilePrecision::Float32 ?
+           reinterpret_cast<const Point3*>(m_File.data() + header().dataOffset) : nullptr;
+}
+
+/****************************************************************************************************/
+const double* Core::MappedCurveFile::pointsDouble() const {
+    return header().precision == CurveFilePrecision::Float64 ?
+           reinterpret_cast<const double*>(m_File.data() + header().dataOffset) : nullptr;
+}
+
+/****************************************************************************************************/
+void Core::MappedCurveFile::copyPoints(size_t first, size_t count, Point3* points) const {
+    if(const auto data = this->points()) {
+        std::memcpy(points, data + first, count * sizeof(Point3));
+        return;
+    }
+    const auto data = pointsDouble() + 3 * first;
+    for(size_t i = 0; i < count; ++i) {
+        points[i] = Point3{ static_cast<float>(data[3 * i]),
+                            static_cast<float>(data[3 * i + 1]),
+                            static_cast<float>(data[3 * i + 2]) };
+    }
+}
+
+/****************************************************************************************************/
+bool Core::CurveFileWriter::open(const std::string& path, CurveFileTopology topology,
+                                 CurveFilePrecision precision /*= CurveFilePrecision::Float32*/,
+                                 float catmullRomAlpha /*= 0.5f*/) {
+    close();
+    m_Error.clear();
+    if(!isLittleEndianHost()) {
+        m_Error = BigEndianError;
+        return false;
+    }
+    m_File = std::fopen(path.c_str(), "wb");
+    if(!m_File) {
+        m_Error = "cannot open " + path;
+        return false;
+    }
+
+    m_Header = CurveFileHeader{};
+    std::memcpy(m_Header.magic, CurveFileMagic, sizeof(CurveFileMagic));
+    m_Header.version         = CurveFileVersion;
+    m_Header.topology        = topology;
+    m_Header.precision       = precision;
+    m_Header.catmullRomAlpha = catmullRomAlpha;
+    m_Header.pointCount      = 0;
+    m_Header.dataOffset      = CurveFileAlignment;
+
+    /* The header is rewritten with the final point count on close() */
+    unsigned char padding[CurveFileAlignment] = {};
+    std::memcpy(padding, &m_Header, sizeof(m_Header));
+    if(std::fwrite(padding, 1, sizeof(padding), m_File) != sizeof(padding)) {
+        m_Error = "cannot write " + path;
+        std::fclose(m_File);
+        m_File = nullptr;
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/****************************************************************************************************/
+bool Core::CurveFileWriter::append(const Point3* points, size_t count) {
+    if(!m_File || !m_Error.empty()) {
+        return false;
+    }
+
+    bool bWritten;
+    if(m_Header.precision == CurveFilePrecision::Float32) {
+        bWritten = std::fwrite(points, sizeof(Point3), count, m_File) == count;
+    } else {
+        double buffer[3 * ConversionBatch];
+        bWritten = true;
+        for(size_t first = 0; first < count && bWritten; first += ConversionBatch) {
+            const auto n = std::min(ConversionBatch, count - first);
+            for(size_t i = 0; i < n; ++i) {
+                buffer[3 * i]     = points[first + i].x;
+                buffer[3 * i + 1] = points[first + i].y;
+                buffer[3 * i + 2] = points[first + i].z;
+            }
+            bWritten = std::fwrite(buffer, 3 * sizeof(double), n, m_File) == n;
+        }
+    }
+    if(!bWritten) {
+        m_Error = "write error";
+        return false;
+    }
+    m_Header.pointCount += count;
+    return true;
+}
+
+/****************************************************************************************************/
+bool Core::CurveFileWriter::close() {
+    if(!m_File) {
+        return m_Error.empty();
+    }
+    if(m_Error.empty() &&
+       (std::fseek(m_File, 0, SEEK_SET) != 0 || std::fwrite(&m_Header, sizeof(m_Header), 1, m_File) != 1)) {
+        m_Error = "write error";
+    }
+    if(std::fclose(m_File) != 0 && m_Error.empty()) {
+        m_Error = "write error";
+    }
+    m_File = nullptr;
+    return m_Error.empty();
+}
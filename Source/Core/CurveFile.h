@@ -0,0 +1,118 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+#include "Core/MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/****************************************************************************************************/
+/* Versioned binary curve file, designed to be memory-mapped and used without copy:
+ *
+ *   offset 0:          CurveFileHeader (64 bytes, little endian)
+ *   offset dataOffset: pointCount points of 3 packed float32 (Point3 layout) or float64 coordinates,
+ *                      dataOffset is a multiple of 64
+ *
+ * The topology tells how points form curves: 4 control points per cubic Bezier curve, 5 per quadratic
+ * pair, or the data points of a Catmull-Rom spline (with its parameterization alpha).
+ *
+ * Files are used in place without byte swapping, so reading and writing them on a big endian host fails
+ * with an error from open().
+ */
+namespace Core {
+enum class CurveFileTopology : uint32_t {
+    CubicBezier   = 0,
+    QuadraticPair = 1,
+    CatmullRom    = 2
+};
+
+enum class CurveFilePrecision : uint32_t {
+    Float32 = 0,
+    Float64 = 1
+};
+
+struct CurveFileHeader {
+    char               magic[8];   /* "QACURVES" */
+    uint32_t           version;    /* CurveFileVersion */
+    CurveFileTopology  topology;
+    CurveFilePrecision precision;
+    float              catmullRomAlpha;
+    uint64_t           pointCount;
+    uint64_t           dataOffset;
+    uint8_t            reserved[24];
+};
+static_assert(sizeof(CurveFileHeader) == 64, "CurveFileHeader must be 64 bytes");
+
+constexpr char     CurveFileMagic[8]  = { 'Q', 'A', 'C', 'U', 'R', 'V', 'E', 'S' };
+constexpr uint32_t CurveFileVersion   = 1;
+constexpr size_t   CurveFileAlignment = 64;
+
+/* True if the file starts with the curve file magic */
+bool isCurveFile(const std::string& path);
+
+/****************************************************************************************************/
+/* Read-only memory mapping of a curve file. The header is validated on open() */
+class MappedCurveFile {
+public:
+    /* Returns false and sets error() on failure */
+    bool open(const std::string& path);
+    void close() { m_File.close(); }
+    const std::string& error() const { return m_Error; }
+
+    /* Valid after a successful open() */
+    const CurveFileHeader& header() const { return *reinterpret_cast<const CurveFileHeader*>(m_File.data()); }
+    size_t pointCount() const { return static_cast<size_t>(header().pointCount); }
+
+    /* Mapped coordinates, nullptr if the file has the other precision */
+    const Point3* points() const;
+    const double* pointsDouble() const;
+
+    /* Copy points [first, first + count) as floats, whatever the precision of the file */
+    void copyPoints(size_t first, size_t count, Point3* points) const;
+
+private:
+    MappedFile  m_File;
+    std::string m_Error;
+};
+
+/****************************************************************************************************/
+/* Streaming writer: points are appended in any number of calls, the point count in the header is
+ * written by close() */
+class CurveFileWriter {
+public:
+    CurveFileWriter() = default;
+    ~CurveFileWriter() { close(); }
+    CurveFileWriter(const CurveFileWriter&) = delete;
+    CurveFileWriter& operator=(const CurveFileWriter&) = delete;
+
+    /* Returns false and sets error() on failure */
+    bool open(const std::string& path, CurveFileTopology topology,
+              CurveFilePrecision precision = CurveFilePrecision::Float32, float catmullRomAlpha = 0.5f);
+    bool append(const Point3* points, size_t count);
+    bool close();
+    const std::string& error() const { return m_Error; }
+
+private:
+    FILE*           m_File { nullptr };
+    CurveFileHeader m_Header {};
+    std::string     m_Error;
+};
+} // namespace Core
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+/****************************************************************************************************/
+/* Minimal math types for the headless core library.
+ * Point3 has the same memory layout as Magnum::Vector3 (three packed floats), so arrays of either
+ * type can be passed to the batch functions without copying.
+ */
+namespace Core {
+struct Point3 {
+    float x, y, z;
+};
+
+inline constexpr Point3 operator+(const Point3& a, const Point3& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline constexpr Point3 operator-(const Point3& a, const Point3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline constexpr Point3 operator-(const Point3& a) { return { -a.x, -a.y, -a.z }; }
+inline constexpr Point3 operator*(float s, const Point3& a) { return { s * a.x, s * a.y, s * a.z }; }
+inline constexpr Point3 operator*(const Point3& a, float s) { return { s * a.x, s * a.y, s * a.z }; }
+inline constexpr Point3 operator/(const Point3& a, float s) { return { a.x / s, a.y / s, a.z / s }; }
+inline Point3& operator+=(Point3& a, const Point3& b) { a.x += b.x; a.y += b.y; a.z += b.z; return a; }
+inline Point3& operator-=(Point3& a, const Point3& b) { a.x -= b.x; a.y -= b.y; a.z -= b.z; return a; }
+
+inline constexpr float dot(const Point3& a, const Point3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline constexpr float lengthSquared(const Point3& a) { return dot(a, a); }
+inline float length(const Point3& a) { return std::sqrt(dot(a, a)); }
+inline Point3 lerp(const Point3& a, const Point3& b, float t) { return a + t * (b - a); }
+
+/* Double precision counterpart, for the solvers that accumulate errors */
+struct Point3d {
+    double x, y, z;
+};
+
+inline constexpr Point3d operator+(const Point3d& a, const Point3d& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline constexpr Point3d operator-(const Point3d& a, const Point3d& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline constexpr Point3d operator*(double s, const Point3d& a) { return { s * a.x, s * a.y, s * a.z }; }
+inline constexpr double dot(const Point3d& a, const Point3d& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline constexpr Point3d toDouble(const Point3& p) { return { p.x, p.y, p.z }; }
+
+/****************************************************************************************************/
+/* Evaluate the cubic Bezier curve B[0..3] at parameter t, using the Bernstein form */
+inline Point3 evaluateCubic(const Point3* B, float t) {
+    const auto t_sqr       = t * t;
+    const auto one_m_t     = 1.0f - t;
+    const auto one_m_t_sqr = one_m_t * one_m_t;
+    return one_m_t * one_m_t_sqr * B[0] +
+           3.0f * one_m_t_sqr * t * B[1] +
+           3.0f * one_m_t * t_sqr * B[2] +
+           t * t_sqr * B[3];
+}
+
+/* Evaluate the quadratic Bezier curve Q[0..2] at parameter s */
+inline Point3 evaluateQuadratic(const Point3* Q, float s) {
+    const auto one_m_s = 1.0f - s;
+    return one_m_s * one_m_s * Q[0] + 2.0f * one_m_s * s * Q[1] + s * s * Q[2];
+}
+
+/* Evaluate the C1 quadratic pair Q[0..4] at global parameter t in [0, 1]:
+ * the first half maps to Q[0..2] and the second half to Q[2..4] */
+inline Point3 evaluateQuadraticPair(const Point3* Q, float t) {
+    return (t < 0.5f) ?
+           evaluateQuadratic(Q, 2.0f * t) :
+           evaluateQuadratic(Q + 2, 2.0f * (t - 0.5f));
+}
+
+/* Evaluate the C1 quadratic pair Q[0..4] of a cubic converted with gamma at the cubic parameter t:
+ * the first half covers [0, gamma] and the second half [gamma, 1] */
+inline Point3 evaluateQuadraticPair(const Point3* Q, float gamma, float t) {
+    return (t < gamma) ?
+           evaluateQuadratic(Q, t / gamma) :
+           evaluateQuadratic(Q + 2, gamma < 1.0f ? (t - gamma) / (1.0f - gamma) : 0.0f);
+}
+} // namespace Core
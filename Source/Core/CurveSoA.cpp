@@ -0,0 +1,138 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveSoA.h"
+#include "Core/CpuFeatures.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/ThreadPool.h"
+
+#include <cassert>
+
+/****************************************************************************************************/
+void Core::CurveSoA::resize(CurveType type, size_t nCurves) {
+    m_Type    = type;
+    m_nCurves = nCurves;
+    m_Stride  = (nCurves + 15) & ~static_cast<size_t>(15);
+    m_Data.resize(controlPointCount(type) * 3 * m_Stride);
+}
+
+/****************************************************************************************************/
+void Core::CurveSoA::fromPoints(const Point3* controlPoints) {
+    const auto nControlPoints = controlPointCount(m_Type);
+    for(size_t k = 0; k < nControlPoints; ++k) {
+        float* x = data(k, 0);
+        float* y = data(k, 1);
+        float* z = data(k, 2);
+        for(size_t i = 0; i < m_nCurves; ++i) {
+            const auto& p = controlPoints[i * nControlPoints + k];
+            x[i] = p.x;
+            y[i] = p.y;
+            z[i] = p.z;
+        }
+    }
+}
+
+/****************************************************************************************************/
+void Core::CurveSoA::toPoints(Point3* controlPoints) const {
+    const auto nControlPoints = controlPointCount(m_Type);
+    for(size_t k = 0; k < nControlPoints; ++k) {
+        const float* x = data(k, 0);
+        const float* y = data(k, 1);
+        const float* z = data(k, 2);
+        for(size_t i = 0; i < m_nCurves; ++i) {
+            controlPoints[i * nControlPoints + k] = Point3{ x[i], y[i], z[i] };
+        }
+    }
+}
+
+/****************************************************************************************************/
+Core::CubicSoA Core::CurveSoA::cubicView() const {
+    assert(m_Type == CurveType::CubicBezier);
+    CubicSoA view;
+    for(size_t k = 0; k < 4; ++k) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            view.B[k][axis] = data(k, axis);
+        }
+    }
+    return view;
+}
+
+/****************************************************************************************************/
+Core::QuadraticSoA Core::CurveSoA::quadraticView() {
+    assert(m_Type == CurveType::QuadraticPair);
+    QuadraticSoA view;
+    for(size_t k = 0; k < 5; ++k) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            view.Q[k][axis] = data(k, axis);
+        }
+    }
+    return view;
+}
+
+/****************************************************************************************************/
+namespace {
+/* Kernel of the current SIMD level, for a scalar gamma (Gamma = float) or one gamma per curve */
+template<class Gamma>
+auto convertKernel() -> void (*)(const Core::CubicSoA&, size_t, Gamma, const Core::QuadraticSoA&) {
+    using namespace Core;
+    switch(simdLevel()) {
+        case SimdLevel::AVX512:
+            return Kernels::convertCubicsToQuadraticsAVX512;
+        case SimdLevel::AVX2:
+            return Kernels::convertCubicsToQuadraticsAVX2;
+        case SimdLevel::SSE:
+            return Kernels::convertCubicsToQuadraticsSSE;
+        default:
+            return Kernels::convertCubicsToQuadraticsScalar;
+    }
+}
+}
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, float gamma,
+                                              const QuadraticSoA& quadratics) {
+    convertKernel<float>()(cubics, nCurves, gamma, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, const float* gammas,
+                                              const QuadraticSoA& quadratics) {
+    convertKernel<const float*>()(cubics, nCurves, gammas, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, float gamma,
+                                     const QuadraticSoA& quadratics) {
+    const auto kernel = convertKernel<float>();
+    threadPool()->parallelFor(0, nCurves, Kernels::ConversionGrainSize, [&](size_t begin, size_t end) {
+                                  kernel(subView(cubics, begin), end - begin, gamma, subView(quadratics, begin));
+                              });
+}
+
+/****************************************************************************************************/
+void Core::convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, const float* gammas,
+                                     const QuadraticSoA& quadratics) {
+    const auto kernel = convertKernel<const float*>();
+    threadPool()->parallelFor(0, nCurves, Kernels::ConversionGrainSize, [&](size_t begin, size_t end) {
+                                  kernel(subView(cubics, begin), end - begin, gammas + begin, subView(quadratics, begin));
+                              });
+}
+
+/****************************************************************************************************/
+void Core::convertCubicsToQuadratics(const CurveSoA& cubics, float gamma, CurveSoA& quadratics) {
+    quadratics.resize(CurveType::QuadraticPair, cubics.size());
+    convertCubicsToQuadratics(cubics.cubicView(), cubics.size(), gamma, quadratics.quadraticView());
+}
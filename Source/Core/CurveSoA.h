@@ -0,0 +1,94 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveBatch.h"
+
+#include <cstddef>
+#include <vector>
+
+/****************************************************************************************************/
+/* Structure-of-arrays views and storage of curve control points for the SIMD batch kernels.
+ * Component arrays are indexed by [control point][axis], each array holds one value per curve.
+ */
+namespace Core {
+struct CubicSoA {
+    const float* B[4][3];
+};
+
+struct QuadraticSoA {
+    float* Q[5][3];
+};
+
+/* Views of the curves from index first on, used to split batches between threads */
+inline CubicSoA subView(const CubicSoA& view, size_t first) {
+    CubicSoA result;
+    for(size_t k = 0; k < 4; ++k) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            result.B[k][axis] = view.B[k][axis] + first;
+        }
+    }
+    return result;
+}
+
+inline QuadraticSoA subView(const QuadraticSoA& view, size_t first) {
+    QuadraticSoA result;
+    for(size_t k = 0; k < 5; ++k) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            result.Q[k][axis] = view.Q[k][axis] + first;
+        }
+    }
+    return result;
+}
+
+/****************************************************************************************************/
+/* Owning SoA storage. Every component array is padded to a multiple of 16 floats */
+class CurveSoA {
+public:
+    CurveSoA() = default;
+    explicit CurveSoA(CurveType type, size_t nCurves) { resize(type, nCurves); }
+
+    void resize(CurveType type, size_t nCurves);
+    size_t size() const { return m_nCurves; }
+    CurveType type() const { return m_Type; }
+
+    float* data(size_t controlPoint, size_t axis) { return &m_Data[(controlPoint * 3 + axis) * m_Stride]; }
+    const float* data(size_t controlPoint, size_t axis) const { return &m_Data[(controlPoint * 3 + axis) * m_Stride]; }
+
+    /* Conversion from/to the packed Point3 layout of CurveBatch.h */
+    void fromPoints(const Point3* controlPoints);
+    void toPoints(Point3* controlPoints) const;
+
+    /* Views for the kernels (cubicView() requires a cubic storage, quadraticView() a quadratic one) */
+    CubicSoA cubicView() const;
+    QuadraticSoA quadraticView();
+
+private:
+    CurveType          m_Type { CurveType::CubicBezier };
+    size_t             m_nCurves { 0 };
+    size_t             m_Stride { 0 };
+    std::vector<float> m_Data;
+};
+
+/****************************************************************************************************/
+/* SIMD version of convertCubicsToQuadratics() over SoA data, using the code path of simdLevel() */
+void convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, float gamma,
+                               const QuadraticSoA& quadratics);
+void convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, const float* gammas,
+                               const QuadraticSoA& quadratics);
+void convertCubicsToQuadratics(const CurveSoA& cubics, float gamma, CurveSoA& quadratics);
+} // namespace Core
@@ -0,0 +1,321 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/ErrorMetrics.h"
+#include "Core/CpuFeatures.h"
+#include "Core/Polynomial.h"
+#include "Core/PowerBasis.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/****************************************************************************************************/
+namespace {
+using Core::Point3;
+using Core::Point3d;
+
+/* Uniform samples bracketing the farthest point of a curve, and golden-section iterations refining it */
+constexpr int FarthestPointSamples = 32;
+constexpr int GoldenIterations     = 30;
+
+/* Brackets of the roots of the squared distance derivative along a cubic, and Newton iterations */
+constexpr int CubicRootBrackets = 16;
+constexpr int NewtonIterations  = 32;
+
+/* Number of curves per task of the thread pool, for the SIMD metrics and the exact Hausdorff distance */
+constexpr size_t SimdGrainSize  = 4096;
+constexpr size_t ExactGrainSize = 16;
+
+using QuadraticPolynomial = Core::QuadraticPolynomial<Point3d>;
+using CubicPolynomial     = Core::CubicPolynomial<Point3d>;
+
+inline double lengthSquared(const Point3d& v) { return dot(v, v); }
+
+/****************************************************************************************************/
+/* Squared distance from p to a quadratic: the derivative of |Q(s) - p|^2 is a cubic of s */
+double distanceSqr(const Point3d& p, const QuadraticPolynomial& Q) {
+    const auto cp = Q.c - p;
+    double     roots[3];
+    const auto nRoots = Core::solveCubic(2.0 * dot(Q.a, Q.a), 3.0 * dot(Q.a, Q.b),
+                                         dot(Q.b, Q.b) + 2.0 * dot(Q.a, cp), dot(Q.b, cp), roots);
+    auto result = std::min(lengthSquared(cp), lengthSquared(Q.value(1.0) - p));
+    for(int k = 0; k < nRoots; ++k) {
+        if(roots[k] > 0.0 && roots[k] < 1.0) {
+            result = std::min(result, lengthSquared(Q.value(roots[k]) - p));
+        }
+    }
+    return result;
+}
+
+/* Squared distance from p to a cubic: the derivative f(t) = (C(t) - p) . C'(t) is a quintic, every local
+ * minimum of the distance is a root where f goes from negative to positive. Those roots are bracketed
+ * by uniform samples and refined with Newton steps falling back to bisection */
+double distanceSqr(const Point3d& p, const CubicPolynomial& C) {
+    auto f = [&](double t) { return dot(C.value(t) - p, C.derivative(t)); };
+
+    auto   result = std::min(lengthSquared(C.d - p), lengthSquared(C.value(1.0) - p));
+    double t0     = 0.0;
+    double f0     = f(t0);
+    for(int j = 1; j <= CubicRootBrackets; ++j) {
+        const auto t1 = static_cast<double>(j) / static_cast<double>(CubicRootBrackets);
+        const auto f1 = f(t1);
+        if(f0 < 0.0 && f1 >= 0.0) {
+            double lo = t0, hi = t1, t = 0.5 * (t0 + t1);
+            for(int iter = 0; iter < NewtonIterations; ++iter) {
+                const auto ft = f(t);
+                (ft < 0.0 ? lo : hi) = t;
+                const auto df = lengthSquared(C.derivative(t)) + dot(C.value(t) - p, C.secondDerivative(t));
+                auto       next = (df != 0.0) ? t - ft / df : lo;
+                if(!(next > lo && next < hi)) {
+                    next = 0.5 * (lo + hi);
+                }
+                const auto converged = std::abs(next - t) < 1.0e-14;
+                t = next;
+                if(converged) {
+                    break;
+                }
+            }
+            result = std::min(result, lengthSquared(C.value(t) - p));
+        }
+        t0 = t1;
+        f0 = f1;
+    }
+    return result;
+}
+
+/****************************************************************************************************/
+/* Maximum of distanceSqrAt(s) over [0, 1]: every local maximum among uniform samples is refined with a
+ * golden-section search between its neighbors */
+template<class Function>
+double farthestDistanceSqr(const Function& distanceSqrAt) {
+    constexpr int M = FarthestPointSamples;
+    double        samples[M + 1];
+    for(int j = 0; j <= M; ++j) {
+        samples[j] = distanceSqrAt(static_cast<double>(j) / static_cast<double>(M));
+    }
+    double result = *std::max_element(samples, samples + M + 1);
+    if(result == 0.0) {
+        return 0.0;
+    }
+
+    constexpr double invPhi = 0.6180339887498949;
+    for(int j = 0; j <= M; ++j) {
+        const auto prev = std::max(j - 1, 0);
+        const auto next = std::min(j + 1, M);
+        if(samples[j] < samples[prev] || samples[j] < samples[next]) {
+            continue;
+        }
+        double lo = static_cast<double>(prev) / static_cast<double>(M);
+        double hi = static_cast<double>(next) / static_cast<double>(M);
+        double x1 = hi - invPhi * (hi - lo);
+        double x2 = lo + invPhi * (hi - lo);
+        double f1 = distanceSqrAt(x1);
+        double f2 = distanceSqrAt(x2);
+        for(int iter = 0; iter < GoldenIterations; ++iter) {
+            if(f1 > f2) {
+                hi = x2;
+                x2 = x1;
+                f2 = f1;
+                x1 = hi - invPhi * (hi - lo);
+                f1 = distanceSqrAt(x1);
+            } else {
+                lo = x1;
+                x1 = x2;
+                f1 = f2;
+                x2 = lo + invPhi * (hi - lo);
+                f2 = distanceSqrAt(x2);
+            }
+        }
+        result = std::max({ result, f1, f2 });
+    }
+    return result;
+}
+
+/****************************************************************************************************/
+float exactHausdorffDistance(const Point3* B, const Point3* Q) {
+    const CubicPolynomial     cubic(B);
+    const QuadraticPolynomial halves[2] = { QuadraticPolynomial(Q), QuadraticPolynomial(Q + 2) };
+
+    auto result = farthestDistanceSqr([&](double t) {
+                                          const auto p = cubic.value(t);
+                                          return std::min(distanceSqr(p, halves[0]), distanceSqr(p, halves[1]));
+                                      });
+    for(const auto& half : halves) {
+        result = std::max(result, farthestDistanceSqr([&](double s) { return distanceSqr(half.value(s), cubic); }));
+    }
+    return static_cast<float>(std::sqrt(result));
+}
+
+/****************************************************************************************************/
+/* Cubic pieces of all chains with their quadratic pairs, in the packed layouts of the pair batches */
+void splitChains(const Point3* cubicControlPoints, const Core::QuadraticChains& chains,
+                 std::vector<Point3>& cubicPieces, std::vector<Point3>& quadraticPieces) {
+    const auto nCurves = chains.offsets.size() - 1;
+    const auto nPieces = (chains.points.size() - nCurves) / 4;
+    cubicPieces.resize(nPieces * 4);
+    quadraticPieces.resize(nPieces * 5);
+
+    size_t piece = 0;
+    for(size_t idx = 0; idx < nCurves; ++idx) {
+        const auto nPairs = (chains.offsets[idx + 1] - chains.offsets[idx] - 1) / 4;
+        const auto h      = 1.0f / static_cast<float>(nPairs);
+        for(size_t k = 0; k < nPairs; ++k, ++piece) {
+            const auto t1 = (k + 1 == nPairs) ? 1.0f : static_cast<float>(k + 1) * h;
+            Core::extractCubicPiece(&cubicControlPoints[idx * 4], static_cast<float>(k) * h, t1, &cubicPieces[piece * 4]);
+            const auto Q = chains.points.begin() + chains.offsets[idx] + 4 * k;
+            std::copy(Q, Q + 5, quadraticPieces.begin() + piece * 5);
+        }
+    }
+}
+
+/* Reduce the errors of the pieces to one value per curve */
+template<class Reduce>
+void reducePieces(const Core::QuadraticChains& chains, const std::vector<float>& pieceErrors, float* errors,
+                  const Reduce& reduce) {
+    const auto nCurves = chains.offsets.size() - 1;
+    auto       it      = pieceErrors.begin();
+    for(size_t idx = 0; idx < nCurves; ++idx) {
+        const auto nPairs = (chains.offsets[idx + 1] - chains.offsets[idx] - 1) / 4;
+        errors[idx] = reduce(it, it + nPairs);
+        it         += nPairs;
+    }
+}
+}
+
+/****************************************************************************************************/
+float Core::l2Error(const Point3* cubicControlPoints, const Point3* quadraticControlPoints) {
+    float error;
+    l2Errors(cubicControlPoints, quadraticControlPoints, 1, &error);
+    return error;
+}
+
+/****************************************************************************************************/
+float Core::hausdorffDistance(const Point3* cubicControlPoints, const Point3* quadraticControlPoints,
+                              HausdorffMethod method) {
+    float distance;
+    hausdorffDistances(cubicControlPoints, quadraticControlPoints, 1, method, &distance);
+    return distance;
+}
+
+/****************************************************************************************************/
+void Core::l2Errors(const Point3* cubicControlPoints, const Point3* quadraticControlPoints, size_t nCurves,
+                    float* errors) {
+    /* Each task converts its curves to SoA storage of its own */
+    threadPool()->parallelFor(0, nCurves, SimdGrainSize, [&](size_t begin, size_t end) {
+                                  CurveSoA cubics(CurveType::CubicBezier, end - begin);
+                                  CurveSoA quadratics(CurveType::QuadraticPair, end - begin);
+                                  cubics.fromPoints(&cubicControlPoints[begin * 4]);
+                                  quadratics.fromPoints(&quadraticControlPoints[begin * 5]);
+                                  l2Errors(cubics.cubicView(), quadratics.quadraticView(), end - begin, &errors[begin]);
+                              });
+}
+
+/****************************************************************************************************/
+void Core::hausdorffDistances(const Point3* cubicControlPoints, const Point3* quadraticControlPoints, size_t nCurves,
+                              HausdorffMethod method, float* distances) {
+    if(method == HausdorffMethod::Exact) {
+        threadPool()->parallelFor(0, nCurves, ExactGrainSize, [&](size_t begin, size_t end) {
+                                      for(size_t idx = begin; idx < end; ++idx) {
+                                          distances[idx] = exactHausdorffDistance(&cubicControlPoints[idx * 4],
+                                                                                  &quadraticControlPoints[idx * 5]);
+                                      }
+                                  });
+        return;
+    }
+
+    threadPool()->parallelFor(0, nCurves, SimdGrainSize, [&](size_t begin, size_t end) {
+                                  CurveSoA cubics(CurveType::CubicBezier, end - begin);
+                                  CurveSoA quadratics(CurveType::QuadraticPair, end - begin);
+                                  cubics.fromPoints(&cubicControlPoints[begin * 4]);
+                                  quadratics.fromPoints(&quadraticControlPoints[begin * 5]);
+                                  sampledHausdorffDistances(cubics.cubicView(), quadratics.quadraticView(), end - begin,
+                                                            &distances[begin]);
+                              });
+}
+
+/****************************************************************************************************/
+void Core::l2Errors(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors) {
+    auto kernel = Kernels::l2ErrorsScalar;
+    switch(simdLevel()) {
+        case SimdLevel::AVX512:
+            kernel = Kernels::l2ErrorsAVX512;
+            break;
+        case SimdLevel::AVX2:
+            kernel = Kernels::l2ErrorsAVX2;
+            break;
+        case SimdLevel::SSE:
+            kernel = Kernels::l2ErrorsSSE;
+            break;
+        default:
+            break;
+    }
+    threadPool()->parallelFor(0, nCurves, SimdGrainSize, [&](size_t begin, size_t end) {
+                                  kernel(subView(cubics, begin), subView(quadratics, begin), end - begin, &errors[begin]);
+                              });
+}
+
+/****************************************************************************************************/
+void Core::sampledHausdorffDistances(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves,
+                                     float* distances) {
+    auto kernel = Kernels::sampledHausdorffDistancesScalar;
+    switch(simdLevel()) {
+        case SimdLevel::AVX512:
+            kernel = Kernels::sampledHausdorffDistancesAVX512;
+            break;
+        case SimdLevel::AVX2:
+            kernel = Kernels::sampledHausdorffDistancesAVX2;
+            break;
+        case SimdLevel::SSE:
+            kernel = Kernels::sampledHausdorffDistancesSSE;
+            break;
+        default:
+            break;
+    }
+    threadPool()->parallelFor(0, nCurves, SimdGrainSize, [&](size_t begin, size_t end) {
+                                  kernel(subView(cubics, begin), subView(quadratics, begin), end - begin, &distances[begin]);
+                              });
+}
+
+/****************************************************************************************************/
+void Core::l2Errors(const Point3* cubicControlPoints, const QuadraticChains& chains, float* errors) {
+    std::vector<Point3> cubicPieces, quadraticPieces;
+    splitChains(cubicControlPoints, chains, cubicPieces, quadraticPieces);
+    std::vector<float> pieceErrors(cubicPieces.size() / 4);
+    l2Errors(cubicPieces.data(), quadraticPieces.data(), pieceErrors.size(), pieceErrors.data());
+
+    /* Pieces have the same parameter length: the squared error of the curve is the mean of theirs */
+    reducePieces(chains, pieceErrors, errors, [](auto begin, auto end) {
+                     double sum = 0.0;
+                     for(auto it = begin; it != end; ++it) {
+                         sum += static_cast<double>(*it) * static_cast<double>(*it);
+                     }
+                     return static_cast<float>(std::sqrt(sum / static_cast<double>(end - begin)));
+                 });
+}
+
+/****************************************************************************************************/
+void Core::hausdorffDistances(const Point3* cubicControlPoints, const QuadraticChains& chains, HausdorffMethod method,
+                              float* distances) {
+    std::vector<Point3> cubicPieces, quadraticPieces;
+    splitChains(cubicControlPoints, chains, cubicPieces, quadraticPieces);
+    std::vector<float> pieceDistances(cubicPieces.size() / 4);
+    hausdorffDistances(cubicPieces.data(), quadraticPieces.data(), pieceDistances.size(), method, pieceDistances.data());
+    reducePieces(chains, pieceDistances, distances,
+                 [](auto begin, auto end) { return *std::max_element(begin, end); });
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveSoA.h"
+#include "Core/QuadraticChain.h"
+
+#include <cstddef>
+
+/****************************************************************************************************/
+/* Error metrics between cubic Bezier curves and their C1 quadratic approximations.
+ *
+ *  - L2:        root mean square distance between the cubic and the quadratic pair at corresponding
+ *               parameters, integrated exactly. The halves match the cubic on [0, gamma] and
+ *               [gamma, 1] as in QuadraticChain.h, gamma being recovered from the joint
+ *               Q2 = (1 - gamma) * Q1 + gamma * Q3.
+ *  - Hausdorff: symmetric Hausdorff distance between both curves as point sets.
+ *               Sampled: from uniform samples of each curve to the polyline of the other one (SIMD).
+ *               Exact:   the distance from a point to a quadratic comes from the roots of a cubic in
+ *                        closed form, to a cubic from a bracketed Newton solve of the quintic
+ *                        derivative; the farthest point of each curve is bracketed by uniform samples
+ *                        and refined with a golden-section search.
+ *
+ * Batches use the packed layouts of CurveBatch.h (4 points per cubic, 5 per quadratic pair), the SoA
+ * overloads are vectorized with the code path of simdLevel().
+ */
+namespace Core {
+enum class HausdorffMethod {
+    Sampled,
+    Exact
+};
+
+/* Single curve */
+float l2Error(const Point3* cubicControlPoints, const Point3* quadraticControlPoints);
+float hausdorffDistance(const Point3* cubicControlPoints, const Point3* quadraticControlPoints, HausdorffMethod method);
+
+/* Batches of quadratic pairs */
+void l2Errors(const Point3* cubicControlPoints, const Point3* quadraticControlPoints, size_t nCurves, float* errors);
+void hausdorffDistances(const Point3* cubicControlPoints, const Point3* quadraticControlPoints, size_t nCurves,
+                        HausdorffMethod method, float* distances);
+void l2Errors(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors);
+void sampledHausdorffDistances(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* distances);
+
+/* Batches of quadratic chains (QuadraticChain.h), evaluated piece by piece: the L2 error is exact, the
+ * Hausdorff distance is the maximum over the pieces, an upper bound of the distance between whole curves */
+void l2Errors(const Point3* cubicControlPoints, const QuadraticChains& chains, float* errors);
+void hausdorffDistances(const Point3* cubicControlPoints, const QuadraticChains& chains, HausdorffMethod method,
+                        float* distances);
+} // namespace Core
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/GammaSolver.h"
+#include "Core/CurveBatch.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+/****************************************************************************************************/
+namespace {
+using Core::Point3;
+using Core::Point3d;
+
+/* 4-point Gauss-Legendre rule on [0, 1]: exact for the degree 6 squared error of each half */
+constexpr double GaussNodes[4]   = { 0.0694318442029737, 0.3300094782075719, 0.6699905217924281, 0.9305681557970263 };
+constexpr double GaussWeights[4] = { 0.1739274225687269, 0.3260725774312731, 0.3260725774312731, 0.1739274225687269 };
+
+/* Number of uniform samples of the max distance objective, and golden-section iterations */
+constexpr int MaxDistanceSamples = 32;
+constexpr int GoldenIterations   = 24;
+
+/****************************************************************************************************/
+inline Point3d evaluateCubic(const Point3d* B, double t) {
+    const auto mt = 1.0 - t;
+    return (mt * mt * mt) * B[0] + (3.0 * mt * mt * t) * B[1] + (3.0 * mt * t * t) * B[2] + (t * t * t) * B[3];
+}
+
+inline Point3d evaluateQuadratic(const Point3d& Q0, const Point3d& Q1, const Point3d& Q2, double s) {
+    const auto ms = 1.0 - s;
+    return (ms * ms) * Q0 + (2.0 * ms * s) * Q1 + (s * s) * Q2;
+}
+
+/* Integrated squared distance between the cubic and its quadratic pair, the first quadratic matching the
+ * cubic on [0, gamma] and the second one on [gamma, 1] */
+double l2Error(const Point3d* B, double gamma) {
+    const auto Q1 = B[0] + (1.5 * gamma) * (B[1] - B[0]);
+    const auto Q3 = B[3] - (1.5 * (1.0 - gamma)) * (B[3] - B[2]);
+    const auto Q2 = (1.0 - gamma) * Q1 + gamma * Q3;
+
+    double first = 0, second = 0;
+    for(int k = 0; k < 4; ++k) {
+        const auto s  = GaussNodes[k];
+        const auto D0 = evaluateCubic(B, gamma * s) - evaluateQuadratic(B[0], Q1, Q2, s);
+        const auto D1 = evaluateCubic(B, gamma + (1.0 - gamma) * s) - evaluateQuadratic(Q2, Q3, B[3], s);
+        first  += GaussWeights[k] * dot(D0, D0);
+        second += GaussWeights[k] * dot(D1, D1);
+    }
+    return gamma * first + (1.0 - gamma) * second;
+}
+
+/****************************************************************************************************/
+/* Minimize error(gamma) on [0, 1] with a golden-section search */
+template<class Error>
+float goldenSectionSearch(Error&& error) {
+    constexpr float invPhi = 0.6180339887498949f;
+    float lo = 0.0f, hi = 1.0f;
+    float x1 = hi - invPhi * (hi - lo);
+    float x2 = lo + invPhi * (hi - lo);
+    auto  f1 = error(x1);
+    auto  f2 = error(x2);
+    for(int iter = 0; iter < GoldenIterations; ++iter) {
+        if(f1 < f2) {
+            hi = x2;
+            x2 = x1;
+            f2 = f1;
+            x1 = hi - invPhi * (hi - lo);
+            f1 = error(x1);
+        } else {
+            lo = x1;
+            x1 = x2;
+            f1 = f2;
+            x2 = lo + invPhi * (hi - lo);
+            f2 = error(x2);
+        }
+    }
+    return 0.5f * (lo + hi);
+}
+
+/****************************************************************************************************/
+float optimalGammaL2(const Point3* Bf) {
+    const Point3d B[4] = { toDouble(Bf[0]), toDouble(Bf[1]), toDouble(Bf[2]), toDouble(Bf[3]) };
+    return goldenSectionSearch([&](float gamma) { return l2Error(B, gamma); });
+}
+
+/****************************************************************************************************/
+/* Squared max distance at the interior samples, cubic samples are precomputed by the caller */
+float maxDistanceError(const Point3* B, const Point3* cubicSamples, float gamma) {
+    Point3 Q[5];
+    Core::convertCubicToQuadratics(B, gamma, Q);
+    float maxDistSqr = 0.0f;
+    for(int i = 1; i < MaxDistanceSamples; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(MaxDistanceSamples);
+        maxDistSqr = std::max(maxDistSqr, lengthSquared(cubicSamples[i - 1] - Core::evaluateQuadraticPair(Q, gamma, t)));
+    }
+    return maxDistSqr;
+}
+
+float optimalGammaMaxDistance(const Point3* B) {
+    Point3 cubicSamples[MaxDistanceSamples - 1];
+    for(int i = 1; i < MaxDistanceSamples; ++i) {
+        cubicSamples[i - 1] = Core::evaluateCubic(B, static_cast<float>(i) / static_cast<float>(MaxDistanceSamples));
+    }
+    return goldenSectionSearch([&](float gamma) { return maxDistanceError(B, cubicSamples, gamma); });
+}
+}
+
+/****************************************************************************************************/
+float Core::optimalGamma(const Point3* cubicControlPoints, GammaObjective objective) {
+    return objective == GammaObjective::L2 ?
+           optimalGammaL2(cubicControlPoints) :
+           optimalGammaMaxDistance(cubicControlPoints);
+}
+
+/****************************************************************************************************/
+void Core::optimalGammas(const Point3* cubicControlPoints, size_t nCurves, GammaObjective objective, float* gammas) {
+    threadPool()->parallelFor(0, nCurves, 256, [&](size_t begin, size_t end) {
+                                  for(size_t idx = begin; idx < end; ++idx) {
+                                      gammas[idx] = optimalGamma(&cubicControlPoints[idx * 4], objective);
+                                  }
+                              });
+}
@@ -0,0 +1,44 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+#include <cstddef>
+
+/****************************************************************************************************/
+/* Per-curve choice of gamma, the parameter of the split point Q2 = (1 - gamma) * Q1 + gamma * Q3 of
+ * the C1 quadratic pair approximating a cubic.
+ *
+ * Both objectives compare the cubic at t with the quadratic pair at the corresponding point of its own
+ * parameterization, the first half covering [0, gamma] and the second one [gamma, 1] (as the chains of
+ * QuadraticChain.h), and minimize over gamma in [0, 1] with a golden-section search:
+ *  - L2:          the integrated squared distance, computed exactly with Gauss-Legendre quadrature on
+ *                 each half.
+ *  - MaxDistance: the maximum distance over uniform samples of t.
+ * The difference is the third difference of the cubic times a fixed polynomial of t (QuadraticChain.h),
+ * so for non-degenerate cubics both optima are at gamma = 0.5 up to the search precision.
+ */
+namespace Core {
+enum class GammaObjective {
+    L2,
+    MaxDistance
+};
+
+float optimalGamma(const Point3* cubicControlPoints, GammaObjective objective);
+void optimalGammas(const Point3* cubicControlPoints, size_t nCurves, GammaObjective objective, float* gammas);
+} // namespace Core
@@ -0,0 +1,174 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Core/ImageFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <vector>
+
+/****************************************************************************************************/
+namespace {
+/* Largest length of a stored deflate block */
+constexpr size_t StoredBlockSize = 65535;
+
+std::vector<uint32_t> crcTable() {
+    std::vector<uint32_t> table(256);
+    for(uint32_t n = 0; n < 256; ++n) {
+        uint32_t c = n;
+        for(int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[n] = c;
+    }
+    return table;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static const auto table = crcTable();
+    crc = ~crc;
+    for(size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t adler32(const uint8_t* data, size_t size) {
+    uint32_t a = 1, b = 0;
+    for(size_t i = 0; i < size; ++i) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void appendChunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data) {
+    appendBigEndian(out, static_cast<uint32_t>(data.size()));
+    const auto typeBegin = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBigEndian(out, crc32(out.data() + typeBegin, out.size() - typeBegin));
+}
+
+/* Top-down RGB rows */
+std::vector<uint8_t> rgbRows(const uint8_t* pixels, size_t width, size_t height, size_t nChannels, bool bBottomUp) {
+    std::vector<uint8_t> rgb(width * height * 3);
+    for(size_t y = 0; y < height; ++y) {
+        const uint8_t* row = pixels + (bBottomUp ? height - 1 - y : y) * width * nChannels;
+        uint8_t*       out = &rgb[y * width * 3];
+        for(size_t x = 0; x < width; ++x) {
+            std::copy(row + x * nChannels, row + x * nChannels + 3, out + x * 3);
+        }
+    }
+    return rgb;
+}
+
+std::vector<uint8_t> encodePng(const std::vector<uint8_t>& rgb, size_t width, size_t height) {
+    /* Scanlines with filter type 0 (none) */
+    std::vector<uint8_t> scanlines;
+    scanlines.reserve(height * (width * 3 + 1));
+    for(size_t y = 0; y < height; ++y) {
+        scanlines.push_back(0);
+        scanlines.insert(scanlines.end(), rgb.begin() + static_cast<std::ptrdiff_t>(y * width * 3),
+                         rgb.begin() + static_cast<std::ptrdiff_t>((y + 1) * width * 3));
+    }
+
+    /* zlib stream of stored deflate blocks */
+    std::vector<uint8_t> zlib{ 0x78, 0x01 };
+    for(size_t first = 0; first < scanlines.size(); first += StoredBlockSize) {
+        const auto length = static_cast<uint16_t>(std::min(StoredBlockSize, scanlines.size() - first));
+        zlib.push_back(first + length == scanlines.size() ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(length));
+        zlib.push_back(static_cast<uint8_t>(length >> 8));
+        zlib.push_back(static_cast<uint8_t>(~length));
+        zlib.push_back(static_cast<uint8_t>(~length >> 8));
+        zlib.insert(zlib.end(), scanlines.begin() + static_cast<std::ptrdiff_t>(first),
+                    scanlines.begin() + static_cast<std::ptrdiff_t>(first + length));
+    }
+    appendBigEndian(zlib, adler32(scanlines.data(), scanlines.size()));
+
+    std::vector<uint8_t> header;
+    appendBigEndian(header, static_cast<uint32_t>(width));
+    appendBigEndian(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), { 8, 2, 0, 0, 0 }); /* 8-bit RGB, deflate, adaptive filtering, no interlace */
+
+    std::vector<uint8_t> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    appendChunk(png, "IHDR", header);
+    appendChunk(png, "IDAT", zlib);
+    appendChunk(png, "IEND", {});
+    return png;
+}
+}
+
+/****************************************************************************************************/
+bool Core::imageFormatFromPath(const std::string& path, ImageFormat& format) {
+    const auto dot = path.find_last_of('.');
+    if(dot == std::string::npos) {
+        return false;
+    }
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if(extension == "png") {
+        format = ImageFormat::Png;
+        return true;
+    } else if(extension == "ppm") {
+        format = ImageFormat::Ppm;
+        return true;
+    }
+    return false;
+}
+
+/****************************************************************************************************/
+bool Core::writeImage(const std::string& path, ImageFormat format, const uint8_t* pixels, size_t width,
+                      size_t height, size_t nChannels, bool bBottomUp, std::string& error) {
+    if((nChannels != 3 && nChannels != 4) || width == 0 || height == 0) {
+        error = "Invalid image of " + std::to_string(width) + "x" + std::to_string(height) + " pixels with " +
+                std::to_string(nChannels) + " channels";
+        return false;
+    }
+
+    const auto           rgb = rgbRows(pixels, width, height, nChannels, bBottomUp);
+    std::vector<uint8_t> data;
+    if(format == ImageFormat::Png) {
+        data = encodePng(rgb, width, height);
+    } else {
+        const auto header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+        data.assign(header.begin(), header.end());
+        data.insert(data.end(), rgb.begin(), rgb.end());
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if(!file) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    const auto bWritten = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if(std::fclose(file) != 0 || !bWritten) {
+        error = "Cannot write " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/****************************************************************************************************/
+/* Writing of 8-bit RGB images without external dependencies: binary PPM (P6), or PNG with stored
+ * (uncompressed) deflate blocks, which any PNG reader accepts */
+namespace Core {
+enum class ImageFormat { Ppm, Png };
+
+/* Format from the extension of path (.png or .ppm, case insensitive), returns false for any other */
+bool imageFormatFromPath(const std::string& path, ImageFormat& format);
+
+/* pixels holds height rows of width pixels with nChannels (3, or 4 with an ignored alpha) bytes each,
+ * rows are stored bottom up (as read from OpenGL) if bBottomUp. Returns false and sets error on failure */
+bool writeImage(const std::string& path, ImageFormat format, const uint8_t* pixels, size_t width, size_t height,
+                size_t nChannels, bool bBottomUp, std::string& error);
+} // namespace Core
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/MappedFile.h"
+
+#ifdef _WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/****************************************************************************************************/
+bool Core::MappedFile::open(const std::string& path) {
+    close();
+    m_Error.clear();
+
+#ifdef _WIN32
+    const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE) {
+        m_Error = "cannot open " + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    m_File = file;
+    m_Size = static_cast<size_t>(size.QuadPart);
+    if(m_Size == 0) {
+        return true;
+    }
+    m_Mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(m_Mapping) {
+        m_Data = static_cast<const char*>(MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        m_Error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        m_Error = path + " is not a regular file";
+        return false;
+    }
+    m_Size = static_cast<size_t>(st.st_size);
+    if(m_Size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, m_Size, PROT_READ, MAP_SHARED, fd, 0);
+    if(data != MAP_FAILED) {
+        m_Data = static_cast<const char*>(data);
+        madvise(data, m_Size, MADV_SEQUENTIAL);
+    }
+    ::close(fd); /* the mapping keeps the file alive */
+#endif
+
+    if(!m_Data) {
+        m_Error = "cannot map " + path;
+        close();
+        return false;
+    }
+    return true;
+}
+
+/****************************************************************************************************/
+void Core::MappedFile::close() {
+#ifdef _WIN32
+    if(m_Data) {
+        UnmapViewOfFile(m_Data);
+    }
+    if(m_Mapping) {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+    }
+    if(m_File) {
+        CloseHandle(m_File);
+        m_File = nullptr;
+    }
+#else
+    if(m_Data) {
+        munmap(const_cast<char*>(m_Data), m_Size);
+    }
+#endif
+    m_Data = nullptr;
+    m_Size = 0;
+}
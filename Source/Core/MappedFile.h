@@ -0,0 +1,50 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/****************************************************************************************************/
+/* Read-only memory mapping of a whole file (mmap, or a file mapping on Windows). Empty files are
+ * opened successfully with a null data() */
+namespace Core {
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /* Returns false and sets error() on failure */
+    bool open(const std::string& path);
+    void close();
+    const std::string& error() const { return m_Error; }
+
+    const char* data() const { return m_Data; }
+    size_t size() const { return m_Size; }
+
+private:
+    const char* m_Data { nullptr };
+    size_t      m_Size { 0 };
+    std::string m_Error;
+#ifdef _WIN32
+    void* m_File { nullptr };
+    void* m_Mapping { nullptr };
+#endif
+};
+} // namespace Core
@@ -0,0 +1,115 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/****************************************************************************************************/
+/* Pooled storage for many objects of one type, created and destroyed individually or all at once.
+ *
+ * Objects are constructed in place in blocks of BlockSize slots, so they keep their address for their
+ * whole lifetime and a pool of N objects costs N / BlockSize heap allocations. Destroyed slots go on a
+ * free list and are reused by the next create(); the blocks themselves are only freed with the pool.
+ */
+namespace Core {
+template<class T, size_t BlockSize = 1024>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<class... Args>
+    T* create(Args&&... args) {
+        if(!m_FreeList) {
+            addBlock();
+        }
+        /* The free list link shares the storage of the object */
+        Slot* const slot     = m_FreeList;
+        Slot* const nextFree = slot->nextFree;
+        T* const    object   = new(slot->storage) T(std::forward<Args>(args)...);
+        m_FreeList  = nextFree;
+        slot->bLive = true;
+        ++m_nObjects;
+        return object;
+    }
+
+    /* object must have been created by this pool */
+    void destroy(T* object) {
+        Slot* const slot = reinterpret_cast<Slot*>(object);
+        assert(slot->bLive);
+        object->~T();
+        slot->bLive    = false;
+        slot->nextFree = m_FreeList;
+        m_FreeList     = slot;
+        --m_nObjects;
+    }
+
+    /* Destroy all objects, keeping the blocks for reuse */
+    void clear() {
+        for(auto& block : m_Blocks) {
+            for(size_t i = 0; i < BlockSize; ++i) {
+                if(block[i].bLive) {
+                    destroy(reinterpret_cast<T*>(block[i].storage));
+                }
+            }
+        }
+    }
+
+    /* Allocate the blocks for nObjects objects at once */
+    void reserve(size_t nObjects) {
+        while(capacity() < nObjects) {
+            addBlock();
+        }
+    }
+
+    size_t size() const { return m_nObjects; }
+    size_t capacity() const { return m_Blocks.size() * BlockSize; }
+    size_t allocatedBytes() const { return m_Blocks.size() * BlockSize * sizeof(Slot); }
+
+private:
+    /* The storage comes first, so that a T* is also the address of its slot */
+    struct Slot {
+        union {
+            alignas(T) unsigned char storage[sizeof(T)];
+            Slot* nextFree;
+        };
+        bool bLive;
+    };
+
+    void addBlock() {
+        m_Blocks.emplace_back(new Slot[BlockSize]);
+        Slot* const block = m_Blocks.back().get();
+        for(size_t i = BlockSize; i-- > 0;) {
+            block[i].bLive    = false;
+            block[i].nextFree = m_FreeList;
+            m_FreeList        = &block[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> m_Blocks;
+    Slot*                                m_FreeList { nullptr };
+    size_t                               m_nObjects { 0 };
+};
+} // namespace Core
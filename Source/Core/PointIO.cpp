@@ -0,0 +1,229 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/PointIO.h"
+#include "Core/MappedFile.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+/****************************************************************************************************/
+namespace {
+/* Bytes per parallel parsing task, rounded up to the next line end */
+constexpr size_t ParseChunkSize = 1 << 20;
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+/* Parse the line [begin, end): returns 1 for a point, 0 for an empty or comment line, -1 if malformed */
+int parseLine(const char* begin, const char* end, Core::Point3& point) {
+    for(auto slash = begin; (slash = static_cast<const char*>(std::memchr(slash, '/', end - slash))) != nullptr;) {
+        if(++slash < end && *slash == '/') {
+            return 0;
+        }
+    }
+
+    float xyz[3];
+    for(int k = 0; k < 3; ++k) {
+        while(begin < end && isBlank(*begin)) {
+            ++begin;
+        }
+        if(k == 0 && begin == end) {
+            return 0;
+        }
+        /* from_chars rejects the leading '+' that strtof accepts */
+        if(begin + 1 < end && *begin == '+' && *(begin + 1) != '-') {
+            ++begin;
+        }
+        const auto result = std::from_chars(begin, end, xyz[k]);
+        if(result.ec == std::errc::result_out_of_range) {
+            /* Saturate as strtof: underflow needs a negative exponent, anything else overflows */
+            const auto exponent = std::find_if(begin, result.ptr, [](char c) { return c == 'e' || c == 'E'; });
+            const auto bTiny    = exponent + 1 < result.ptr && *(exponent + 1) == '-';
+            xyz[k] = bTiny ? 0.0f : std::numeric_limits<float>::infinity();
+            if(*begin == '-') {
+                xyz[k] = -xyz[k];
+            }
+        } else if(result.ec != std::errc{}) {
+            return -1;
+        }
+        begin = result.ptr;
+    }
+    point = Core::Point3{ xyz[0], xyz[1], xyz[2] };
+    return 1;
+}
+
+const char* lineEnd(const char* begin, const char* end) {
+    const auto newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return newline ? newline : end;
+}
+}
+
+/****************************************************************************************************/
+size_t Core::TextPointReader::read(Point3* points, size_t maxPoints) {
+    size_t nPoints = 0;
+    while(nPoints < maxPoints && !failed() && std::getline(m_Stream, m_Line)) {
+        ++m_LineNumber;
+        if(m_Line.find("//") != std::string::npos) {
+            continue;
+        }
+
+        const char* begin = m_Line.c_str();
+        float       xyz[3];
+        int         k = 0;
+        for(; k < 3; ++k) {
+            char* end;
+            xyz[k] = std::strtof(begin, &end);
+            if(end == begin) {
+                break;
+            }
+            begin = end;
+        }
+        if(k == 0 && m_Line.find_first_not_of(" \t\r\n") == std::string::npos) {
+            continue; /* empty line */
+        }
+        if(k < 3) {
+            m_Error = "line " + std::to_string(m_LineNumber) + ": expected 3 coordinates, got \"" + m_Line + "\"";
+            break;
+        }
+        points[nPoints++] = Point3{ xyz[0], xyz[1], xyz[2] };
+    }
+    return nPoints;
+}
+
+/****************************************************************************************************/
+bool Core::parseTextPoints(const char* text, size_t size, std::vector<Point3>& points, std::string& error) {
+    points.clear();
+    error.clear();
+    const char* const textEnd = text + size;
+
+    /* Chunk k is [chunkBegin[k], chunkBegin[k + 1]), every chunk but the last ends with a newline */
+    const size_t        nChunks = (size + ParseChunkSize - 1) / ParseChunkSize;
+    std::vector<size_t> chunkBegin(nChunks + 1, size);
+    chunkBegin[0] = 0;
+    for(size_t k = 1; k < nChunks; ++k) {
+        const auto from = std::max(chunkBegin[k - 1], k * ParseChunkSize - 1);
+        chunkBegin[k] = std::min(size, static_cast<size_t>(lineEnd(text + from, textEnd) - text) + 1);
+    }
+
+    /* Line counts give an upper bound of the point count of every chunk */
+    std::vector<size_t> lineOffsets(nChunks + 1, 0);
+    threadPool()->parallelFor(0, nChunks, 1, [&](size_t first, size_t last) {
+                                  for(size_t k = first; k < last; ++k) {
+                                      const auto begin = text + chunkBegin[k];
+                                      const auto end   = text + chunkBegin[k + 1];
+                                      lineOffsets[k + 1] = static_cast<size_t>(std::count(begin, end, '\n'));
+                                      if(end == textEnd && begin < end && *(end - 1) != '\n') {
+                                          ++lineOffsets[k + 1];
+                                      }
+                                  }
+                              });
+    for(size_t k = 0; k < nChunks; ++k) {
+        lineOffsets[k + 1] += lineOffsets[k];
+    }
+    points.resize(lineOffsets[nChunks]);
+
+    /* Parse every chunk into its own range, recording its point count or its first malformed line */
+    std::vector<size_t>      pointCounts(nChunks, 0);
+    std::vector<const char*> errorLines(nChunks, nullptr);
+    threadPool()->parallelFor(0, nChunks, 1, [&](size_t first, size_t last) {
+                                  for(size_t k = first; k < last; ++k) {
+                                      const auto end = text + chunkBegin[k + 1];
+                                      Point3*    P   = points.data() + lineOffsets[k];
+                                      size_t     n   = 0;
+                                      for(auto line = text + chunkBegin[k]; line < end;) {
+                                          const auto eol    = lineEnd(line, end);
+                                          const auto result = parseLine(line, eol, P[n]);
+                                          if(result < 0) {
+                                              errorLines[k] = line;
+                                              break;
+                                          }
+                                          n   += static_cast<size_t>(result);
+                                          line = eol + 1;
+                                      }
+                                      pointCounts[k] = n;
+                                  }
+                              });
+
+    for(size_t k = 0; k < nChunks; ++k) {
+        if(errorLines[k]) {
+            const auto line       = errorLines[k];
+            const auto lineNumber = lineOffsets[k] + static_cast<size_t>(std::count(text + chunkBegin[k], line, '\n')) + 1;
+            error = "line " + std::to_string(lineNumber) + ": expected 3 coordinates, got \"" +
+                    std::string(line, lineEnd(line, textEnd)) + "\"";
+            points.clear();
+            return false;
+        }
+    }
+
+    /* Close the gaps left by empty and comment lines, ranges only move towards the front */
+    size_t nPoints = 0;
+    for(size_t k = 0; k < nChunks; ++k) {
+        if(nPoints != lineOffsets[k]) {
+            std::memmove(points.data() + nPoints, points.data() + lineOffsets[k], pointCounts[k] * sizeof(Point3));
+        }
+        nPoints += pointCounts[k];
+    }
+    points.resize(nPoints);
+    return true;
+}
+
+/****************************************************************************************************/
+bool Core::loadTextPoints(const std::string& path, std::vector<Point3>& points, std::string& error) {
+    MappedFile file;
+    if(!file.open(path)) {
+        error = file.error();
+        return false;
+    }
+    return parseTextPoints(file.data(), file.size(), points, error);
+}
+
+/****************************************************************************************************/
+void Core::formatCurves(const Point3* controlPoints, size_t nCurves, size_t nControlPoints, PointFormat format,
+                        std::string& out, size_t firstCurve /*= 0*/) {
+    if(format == PointFormat::Raw) {
+        const auto nBytes = nCurves * nControlPoints * sizeof(Point3);
+        out.append(reinterpret_cast<const char*>(controlPoints), nBytes);
+        return;
+    }
+
+    /* Shortest representation that reads back to the same float */
+    char buffer[64];
+    for(size_t idx = 0; idx < nCurves; ++idx) {
+        const Point3* P = &controlPoints[idx * nControlPoints];
+        if(format == PointFormat::Text && nControlPoints > 1) {
+            const auto n = std::snprintf(buffer, sizeof(buffer), "\n// Control point of curve #%zu\n", firstCurve + idx);
+            out.append(buffer, static_cast<size_t>(n));
+        }
+        for(size_t k = 0; k < nControlPoints; ++k) {
+            const auto separator = format == PointFormat::Text ? ' ' : ',';
+            char*      end       = buffer;
+            end    = std::to_chars(end, buffer + sizeof(buffer), P[k].x).ptr;
+            *end++ = separator;
+            end    = std::to_chars(end, buffer + sizeof(buffer), P[k].y).ptr;
+            *end++ = separator;
+            end    = std::to_chars(end, buffer + sizeof(buffer), P[k].z).ptr;
+            *end++ = (format == PointFormat::Text || k + 1 == nControlPoints) ? '\n' : ',';
+            out.append(buffer, end);
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+/****************************************************************************************************/
+/* Streaming input and output of curve points.
+ *
+ * Input is the points.txt format of the viewer: one "x y z" point per line, empty lines and lines
+ * containing "//" are skipped. The reader keeps a single line in memory, so arbitrarily large inputs
+ * can be processed in fixed-size batches.
+ */
+namespace Core {
+class TextPointReader {
+public:
+    explicit TextPointReader(std::istream& stream) : m_Stream(stream) {}
+
+    /* Read up to maxPoints points. Fewer points are returned only at the end of the stream or on a
+     * malformed line, in which case failed() is set */
+    size_t read(Point3* points, size_t maxPoints);
+
+    bool failed() const { return !m_Error.empty(); }
+    const std::string& error() const { return m_Error; }
+
+private:
+    std::istream& m_Stream;
+    std::string   m_Line;
+    std::string   m_Error;
+    size_t        m_LineNumber { 0 };
+};
+
+/* Parse a whole points.txt-style buffer on the thread pool. The buffer is split into chunks at line
+ * boundaries, every chunk is parsed with std::from_chars straight into its range of points (sized by
+ * its line count), and the ranges are then compacted over the skipped lines. Returns false and sets
+ * error (with the line number, as TextPointReader) on a malformed line */
+bool parseTextPoints(const char* text, size_t size, std::vector<Point3>& points, std::string& error);
+
+/* Memory-map a points.txt-style file and parse it with parseTextPoints() */
+bool loadTextPoints(const std::string& path, std::vector<Point3>& points, std::string& error);
+
+/* Output formats of curve control points:
+ *  - Text: the points.txt format, one point per line and a comment line before each curve (omitted
+ *          for single points, e.g. the data points of a Catmull-Rom spline)
+ *  - Csv:  one curve per line, comma separated coordinates of all its control points
+ *  - Raw:  packed native float32 coordinates, no separators */
+enum class PointFormat {
+    Text,
+    Csv,
+    Raw
+};
+
+/* Append nCurves curves of nControlPoints points each to out. firstCurve numbers the Text comments */
+void formatCurves(const Point3* controlPoints, size_t nCurves, size_t nControlPoints, PointFormat format,
+                  std::string& out, size_t firstCurve = 0);
+} // namespace Core
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/Polynomial.h"
+
+#include <algorithm>
+#include <cmath>
+
+/****************************************************************************************************/
+int Core::solveCubic(double a, double b, double c, double d, double roots[3]) {
+    const auto scale = std::max({ std::abs(a), std::abs(b), std::abs(c), std::abs(d) });
+    if(scale == 0.0) {
+        return 0;
+    }
+    if(std::abs(a) <= 1.0e-12 * scale) {
+        /* Quadratic, or linear */
+        if(std::abs(b) <= 1.0e-12 * scale) {
+            if(c == 0.0) {
+                return 0;
+            }
+            roots[0] = -d / c;
+            return 1;
+        }
+        const auto disc = c * c - 4.0 * b * d;
+        if(disc < 0.0) {
+            return 0;
+        }
+        const auto sq = std::sqrt(disc);
+        roots[0] = (-c + sq) / (2.0 * b);
+        roots[1] = (-c - sq) / (2.0 * b);
+        return 2;
+    }
+
+    /* Depressed cubic x = y - b / 3a: y^3 + p * y + q = 0 */
+    const auto bn = b / a, cn = c / a, dn = d / a;
+    const auto p     = cn - bn * bn / 3.0;
+    const auto q     = 2.0 * bn * bn * bn / 27.0 - bn * cn / 3.0 + dn;
+    const auto shift = -bn / 3.0;
+    const auto disc  = q * q / 4.0 + p * p * p / 27.0;
+    if(disc > 0.0) {
+        const auto sq = std::sqrt(disc);
+        roots[0] = std::cbrt(-q / 2.0 + sq) + std::cbrt(-q / 2.0 - sq) + shift;
+        return 1;
+    }
+    if(p == 0.0) {
+        roots[0] = shift;
+        return 1;
+    }
+
+    /* Three real roots: trigonometric solution */
+    const auto r   = 2.0 * std::sqrt(-p / 3.0);
+    const auto phi = std::acos(std::clamp(3.0 * q / (p * r), -1.0, 1.0)) / 3.0;
+    for(int k = 0; k < 3; ++k) {
+        roots[k] = r * std::cos(phi - 2.0943951023931957 * k) + shift;
+    }
+    return 3;
+}
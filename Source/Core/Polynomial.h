@@ -0,0 +1,25 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/****************************************************************************************************/
+/* Closed-form polynomial root finding shared by the solvers of the core library */
+namespace Core {
+/* Real roots of a * x^3 + b * x^2 + c * x + d = 0, falling back to the quadratic or linear equation
+ * when the leading coefficients vanish relative to the others. Returns the number of roots written */
+int solveCubic(double a, double b, double c, double d, double roots[3]);
+} // namespace Core
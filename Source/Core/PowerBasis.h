@@ -0,0 +1,70 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+/****************************************************************************************************/
+/* Power basis form of Bezier curves, shared by the tessellation, the quadratic chains and the error
+ * metrics. Point is Point3 or Point3d: control points are read as Point3 and converted first, so the
+ * double precision forms are exact for float input.
+ */
+namespace Core {
+inline constexpr Point3 toPoint(const Point3& p, Point3) { return p; }
+inline constexpr Point3d toPoint(const Point3& p, Point3d) { return toDouble(p); }
+
+/* Q(s) = a * s^2 + b * s + c */
+template<class Point>
+struct QuadraticPolynomial {
+    using Scalar = decltype(Point::x);
+    Point a, b, c;
+
+    /* Quadratic Bezier curve Q[0..2] */
+    explicit QuadraticPolynomial(const Point3* Q) {
+        const auto Q0 = toPoint(Q[0], Point{}), Q1 = toPoint(Q[1], Point{}), Q2 = toPoint(Q[2], Point{});
+        a = Q0 - Scalar(2) * Q1 + Q2;
+        b = Scalar(2) * (Q1 - Q0);
+        c = Q0;
+    }
+
+    Point value(Scalar s) const { return s * (s * a + b) + c; }
+};
+
+/* P(t) = a * t^3 + b * t^2 + c * t + d */
+template<class Point>
+struct CubicPolynomial {
+    using Scalar = decltype(Point::x);
+    Point a, b, c, d;
+
+    /* Cubic Bezier curve B[0..3] */
+    explicit CubicPolynomial(const Point3* B) {
+        const auto B0 = toPoint(B[0], Point{}), B1 = toPoint(B[1], Point{});
+        const auto B2 = toPoint(B[2], Point{}), B3 = toPoint(B[3], Point{});
+        a = B3 - B0 + Scalar(3) * (B1 - B2);
+        b = Scalar(3) * (B2 - Scalar(2) * B1 + B0);
+        c = Scalar(3) * (B1 - B0);
+        d = B0;
+    }
+
+    /* Quadratic curve as a cubic with a = 0 */
+    explicit CubicPolynomial(const QuadraticPolynomial<Point>& Q) : a{}, b(Q.a), c(Q.b), d(Q.c) {}
+
+    Point value(Scalar t) const { return t * (t * (t * a + b) + c) + d; }
+    Point derivative(Scalar t) const { return t * (t * (Scalar(3) * a) + Scalar(2) * b) + c; }
+    Point secondDerivative(Scalar t) const { return t * (Scalar(6) * a) + Scalar(2) * b; }
+};
+} // namespace Core
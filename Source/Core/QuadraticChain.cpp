@@ -0,0 +1,171 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/QuadraticChain.h"
+#include "Core/CurveBatch.h"
+#include "Core/PowerBasis.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+/****************************************************************************************************/
+namespace {
+using Core::Point3;
+
+/* max |a3 * s^3 + a2 * s^2 + a1 * s + a0| on [0, 1] */
+double maxAbsCubic(double a3, double a2, double a1, double a0) {
+    auto f = [&](double s) { return std::abs(((a3 * s + a2) * s + a1) * s + a0); };
+    double result = std::max(f(0.0), f(1.0));
+
+    /* Interior extrema at the roots of 3 * a3 * s^2 + 2 * a2 * s + a1 */
+    const auto a = 3.0 * a3, b = 2.0 * a2, c = a1;
+    if(a == 0.0) {
+        if(b != 0.0) {
+            const auto s = -c / b;
+            if(s > 0.0 && s < 1.0) { result = std::max(result, f(s)); }
+        }
+        return result;
+    }
+    const auto disc = b * b - 4.0 * a * c;
+    if(disc >= 0.0) {
+        const auto sq = std::sqrt(disc);
+        for(const auto s : { (-b + sq) / (2.0 * a), (-b - sq) / (2.0 * a) }) {
+            if(s > 0.0 && s < 1.0) { result = std::max(result, f(s)); }
+        }
+    }
+    return result;
+}
+}
+
+/****************************************************************************************************/
+float Core::quadraticPairErrorFactor(float gammaf) {
+    /* Unit cubic t^3 (B = 0, 0, 0, 1) and its quadratic pair Q0 = Q1 = 0, Q3, Q2 = gamma * Q3, Q4 = 1 */
+    const double gamma = gammaf;
+    const double Q3    = 1.0 - 1.5 * (1.0 - gamma);
+    const double Q2    = gamma * Q3;
+
+    /* First half, t = gamma * s:               (gamma s)^3 - Q2 s^2
+     * Second half, t = gamma + (1 - gamma) s: t^3 - [(1 - s)^2 Q2 + 2 s (1 - s) Q3 + s^2] */
+    const double g = 1.0 - gamma;
+    const auto   e0 = maxAbsCubic(gamma * gamma * gamma, -Q2, 0.0, 0.0);
+    const auto   e1 = maxAbsCubic(g * g * g,
+                                  3.0 * gamma * g * g - Q2 + 2.0 * Q3 - 1.0,
+                                  3.0 * gamma * gamma * g - 2.0 * Q3 + 2.0 * Q2,
+                                  gamma * gamma * gamma - Q2);
+    return static_cast<float>(std::max(e0, e1));
+}
+
+/****************************************************************************************************/
+namespace {
+size_t pairCount(const Point3* B, float tolerance, float errorFactor, bool& bClamped) {
+    const auto error = length(B[3] - 3.0f * B[2] + 3.0f * B[1] - B[0]) * errorFactor;
+    bClamped = false;
+    if(error <= tolerance) {
+        return 1;
+    }
+    /* Compared as double before the conversion, so that infinite or huge ratios are clamped too */
+    const auto n = std::ceil(std::cbrt(static_cast<double>(error) / static_cast<double>(tolerance)));
+    if(!(n <= static_cast<double>(Core::MaxQuadraticPairsPerCubic))) {
+        bClamped = true;
+        return Core::MaxQuadraticPairsPerCubic;
+    }
+    return static_cast<size_t>(n);
+}
+
+/* Chain of nPairs quadratic pairs (4 * nPairs + 1 points) of one cubic */
+void approximateCubic(const Point3* B, float gamma, Point3* out, size_t nPairs) {
+    if(nPairs == 1) {
+        Core::convertCubicToQuadratics(B, gamma, out);
+        return;
+    }
+
+    const auto h = 1.0f / static_cast<float>(nPairs);
+    for(size_t k = 0; k < nPairs; ++k) {
+        const auto t0 = static_cast<float>(k) * h;
+        const auto t1 = (k + 1 == nPairs) ? 1.0f : static_cast<float>(k + 1) * h;
+        Point3     piece[4];
+        Core::extractCubicPiece(B, t0, t1, piece);
+
+        /* Q4 of a piece is Q0 of the next one */
+        Core::convertCubicToQuadratics(piece, gamma, &out[4 * k]);
+    }
+}
+}
+
+/****************************************************************************************************/
+size_t Core::quadraticPairCount(const Point3* cubicControlPoints, float tolerance, float gamma /*= 0.5f*/,
+                                bool* bClamped /*= nullptr*/) {
+    assert(tolerance > 0.0f);
+    bool       bPairsClamped;
+    const auto nPairs = pairCount(cubicControlPoints, tolerance, quadraticPairErrorFactor(gamma), bPairsClamped);
+    if(bClamped) {
+        *bClamped = bPairsClamped;
+    }
+    return nPairs;
+}
+
+/****************************************************************************************************/
+void Core::extractCubicPiece(const Point3* cubicControlPoints, float t0, float t1, Point3* piece) {
+    const CubicPolynomial<Point3> P(cubicControlPoints);
+    const auto                    p0 = (t0 == 0.0f) ? cubicControlPoints[0] : P.value(t0);
+    const auto                    p1 = (t1 == 1.0f) ? cubicControlPoints[3] : P.value(t1);
+    const auto                    dt = (t1 - t0) / 3.0f;
+    piece[0] = p0;
+    piece[1] = p0 + dt * P.derivative(t0);
+    piece[2] = p1 - dt * P.derivative(t1);
+    piece[3] = p1;
+}
+
+/****************************************************************************************************/
+size_t Core::approximateCubicsWithQuadratics(const Point3* cubicControlPoints, size_t nCurves, float tolerance,
+                                             QuadraticChains& chains, float gamma /*= 0.5f*/) {
+    assert(tolerance > 0.0f);
+    const auto errorFactor = quadraticPairErrorFactor(gamma);
+
+    /* Pass 1: number of points per curve, prefix sum into offsets. Clamped curves are flagged in the low
+     * bit of their point count, which is odd otherwise */
+    chains.offsets.resize(nCurves + 1);
+    chains.offsets[0] = 0;
+    threadPool()->parallelFor(0, nCurves, 16384, [&](size_t begin, size_t end) {
+                                  for(size_t idx = begin; idx < end; ++idx) {
+                                      bool       bClamped;
+                                      const auto nPairs = pairCount(&cubicControlPoints[idx * 4], tolerance, errorFactor,
+                                                                    bClamped);
+                                      chains.offsets[idx + 1] = 4 * nPairs + (bClamped ? 0 : 1);
+                                  }
+                              });
+    chains.clampedCurves.clear();
+    for(size_t idx = 0; idx < nCurves; ++idx) {
+        if((chains.offsets[idx + 1] & 1) == 0) {
+            chains.clampedCurves.push_back(idx);
+            chains.offsets[idx + 1] += 1;
+        }
+        chains.offsets[idx + 1] += chains.offsets[idx];
+    }
+    chains.points.resize(chains.offsets[nCurves]);
+
+    /* Pass 2: extract the pieces from the Hermite form of the cubic and convert them */
+    threadPool()->parallelFor(0, nCurves, 1024, [&](size_t begin, size_t end) {
+                                  for(size_t idx = begin; idx < end; ++idx) {
+                                      approximateCubic(&cubicControlPoints[idx * 4], gamma,
+                                                       &chains.points[chains.offsets[idx]],
+                                                       (chains.offsets[idx + 1] - chains.offsets[idx] - 1) / 4);
+                                  }
+                              });
+    return chains.clampedCurves.size();
+}
@@ -0,0 +1,69 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+#include <cstddef>
+#include <vector>
+
+/****************************************************************************************************/
+/* Approximation of cubic Bezier curves by chains of C1 quadratic pairs within a given tolerance.
+ *
+ * With the quadratic halves matched to the cubic parameter ranges [0, gamma] and [gamma, 1], the
+ * difference between a cubic and its quadratic pair is linear in the control points and vanishes for
+ * quadratics, hence it is D(t) = (B3 - 3B2 + 3B1 - B0) * phi_gamma(t) for a fixed scalar polynomial
+ * phi_gamma. The distance is therefore bounded by |B3 - 3B2 + 3B1 - B0| * max|phi_gamma|, and since the
+ * third difference of a piece of parameter length h scales with h^3, splitting the cubic into N equal
+ * pieces (the optimal split points, all pieces have the same error) with
+ *     N = ceil(cbrt(|B3 - 3B2 + 3B1 - B0| * max|phi_gamma| / tolerance))
+ * guarantees that every point of the cubic is within tolerance of the quadratic chain, as long as N does
+ * not exceed MaxQuadraticPairsPerCubic. Larger counts are clamped to that limit, the chains of those
+ * curves miss the tolerance and are reported in QuadraticChains::clampedCurves.
+ *
+ * Chain layout: the N pieces of a curve give 2N quadratics sharing their end points, stored as
+ * 4N + 1 consecutive points (Q0, Q1, Q2, Q3, Q4 = next Q0, ...). The points of curve i are in
+ * [offsets[i], offsets[i + 1]).
+ */
+namespace Core {
+struct QuadraticChains {
+    std::vector<Point3> points;
+    std::vector<size_t> offsets;
+    std::vector<size_t> clampedCurves; /* ascending indices of the curves missing the tolerance */
+};
+
+/* Upper limit of the number of pieces per cubic, bounding the chain size of degenerate input (huge
+ * coordinates or a tolerance far below the curve size) */
+constexpr size_t MaxQuadraticPairsPerCubic = 4096;
+
+/* max|phi_gamma(t)|, the error of the quadratic pair of a cubic with unit third difference */
+float quadraticPairErrorFactor(float gamma);
+
+/* Number of quadratic pairs needed to approximate a cubic within tolerance, clamped to
+ * MaxQuadraticPairsPerCubic. bClamped, if given, tells whether the clamp applied */
+size_t quadraticPairCount(const Point3* cubicControlPoints, float tolerance, float gamma = 0.5f,
+                          bool* bClamped = nullptr);
+
+/* Control points of the piece [t0, t1] of a cubic, from its Hermite form. Piece k of a chain of N pairs is
+ * the piece [k / N, (k + 1) / N] converted with the chain gamma */
+void extractCubicPiece(const Point3* cubicControlPoints, float t0, float t1, Point3* piece);
+
+/* Approximate all curves in one call. Counts pieces first, then fills the chains without reallocation.
+ * Returns the number of clamped curves, whose chains miss the tolerance */
+size_t approximateCubicsWithQuadratics(const Point3* cubicControlPoints, size_t nCurves, float tolerance,
+                                       QuadraticChains& chains, float gamma = 0.5f);
+} // namespace Core
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/CurveSoA.h"
+
+/****************************************************************************************************/
+/* Per-ISA entry points of the batch kernels, selected at runtime from Core::simdLevel().
+ * Each ISA is compiled in its own translation unit with the matching compiler flags.
+ */
+namespace Core::Kernels {
+/* Curves per task of the batch conversions, which only touch 9 points per curve */
+constexpr size_t ConversionGrainSize = 16384;
+
+void convertCubicsToQuadraticsScalar(const CubicSoA& cubics, size_t nCurves, float gamma, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsSSE(const CubicSoA& cubics, size_t nCurves, float gamma, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsAVX2(const CubicSoA& cubics, size_t nCurves, float gamma, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsAVX512(const CubicSoA& cubics, size_t nCurves, float gamma, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsScalar(const CubicSoA& cubics, size_t nCurves, const float* gammas, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsSSE(const CubicSoA& cubics, size_t nCurves, const float* gammas, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsAVX2(const CubicSoA& cubics, size_t nCurves, const float* gammas, const QuadraticSoA& quadratics);
+void convertCubicsToQuadraticsAVX512(const CubicSoA& cubics, size_t nCurves, const float* gammas, const QuadraticSoA& quadratics);
+
+/* Single-threaded conversions with the code path of Core::simdLevel(), used by the batch entry points
+ * of CurveSoA.h and CurveBatch.h to process their tasks */
+void convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, float gamma, const QuadraticSoA& quadratics);
+void convertCubicsToQuadratics(const CubicSoA& cubics, size_t nCurves, const float* gammas, const QuadraticSoA& quadratics);
+
+/* powers[i] = sqrt(lengthsSqr[i])^alpha for alpha > 0, computed as exp2(0.5 * alpha * log2(lengthsSqr[i]))
+ * with polynomial approximations (relative error ~1e-7). Zero lengths give zero powers */
+void powLengthsScalar(const float* lengthsSqr, size_t n, float alpha, float* powers);
+void powLengthsSSE(const float* lengthsSqr, size_t n, float alpha, float* powers);
+void powLengthsAVX2(const float* lengthsSqr, size_t n, float alpha, float* powers);
+void powLengthsAVX512(const float* lengthsSqr, size_t n, float alpha, float* powers);
+
+/* Root mean square distance between cubics and their quadratic pairs at corresponding parameters (the
+ * halves on [0, gamma] and [gamma, 1], gamma recovered from Q2), integrated exactly with the 4-point
+ * Gauss-Legendre rule on each half. The quadratic view is only read */
+void l2ErrorsScalar(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors);
+void l2ErrorsSSE(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors);
+void l2ErrorsAVX2(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors);
+void l2ErrorsAVX512(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors);
+
+/* Symmetric Hausdorff distance between HausdorffSegments + 1 uniform samples of each curve and the
+ * polyline through the samples of the other one */
+constexpr int HausdorffSegments = 32;
+void sampledHausdorffDistancesScalar(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* distances);
+void sampledHausdorffDistancesSSE(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* distances);
+void sampledHausdorffDistancesAVX2(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* distances);
+void sampledHausdorffDistancesAVX512(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* distances);
+} // namespace Core::Kernels
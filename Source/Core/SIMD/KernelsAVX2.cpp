@@ -0,0 +1,86 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/SIMD/KernelsImpl.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+/****************************************************************************************************/
+namespace {
+struct AVX2Traits {
+    using Float = __m256;
+    static constexpr size_t Width = 8;
+    static Float load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+    static Float set1(float v) { return _mm256_set1_ps(v); }
+    static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+    static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+    static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+    using Int   = __m256i;
+    using Mask  = __m256;
+    static Float div(Float a, Float b) { return _mm256_div_ps(a, b); }
+    static Float sqrt(Float a) { return _mm256_sqrt_ps(a); }
+    static Float min(Float a, Float b) { return _mm256_min_ps(a, b); }
+    static Float max(Float a, Float b) { return _mm256_max_ps(a, b); }
+    static Mask greater(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Float select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+    static Int set1i(int v) { return _mm256_set1_epi32(v); }
+    static Int castToInt(Float a) { return _mm256_castps_si256(a); }
+    static Float castToFloat(Int a) { return _mm256_castsi256_ps(a); }
+    static Int andi(Int a, Int b) { return _mm256_and_si256(a, b); }
+    static Int ori(Int a, Int b) { return _mm256_or_si256(a, b); }
+    static Int addi(Int a, Int b) { return _mm256_add_epi32(a, b); }
+    static Int subi(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+    template<int N> static Int shiftLeft(Int a) { return _mm256_slli_epi32(a, N); }
+    template<int N> static Int shiftRight(Int a) { return _mm256_srli_epi32(a, N); }
+    static Int roundToInt(Float a) { return _mm256_cvtps_epi32(a); }
+    static Float toFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+};
+using Traits = AVX2Traits;
+}
+#else
+/* The compiler does not target this ISA: fall back to plain C++ so the entry points still exist */
+using Traits = ScalarTraits;
+#endif
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadraticsAVX2(const CubicSoA& cubics, size_t nCurves, float gamma,
+                                                  const QuadraticSoA& quadratics) {
+    convertCubicsToQuadraticsImpl<Traits>(cubics, nCurves, gamma, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadraticsAVX2(const CubicSoA& cubics, size_t nCurves, const float* gammas,
+                                                  const QuadraticSoA& quadratics) {
+    convertCubicsToQuadraticsImpl<Traits>(cubics, nCurves, gammas, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::powLengthsAVX2(const float* lengthsSqr, size_t n, float alpha, float* powers) {
+    powLengthsImpl<Traits>(lengthsSqr, n, alpha, powers);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::l2ErrorsAVX2(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors) {
+    l2ErrorsImpl<Traits>(cubics, quadratics, nCurves, errors);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::sampledHausdorffDistancesAVX2(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves,
+                                                  float* distances) {
+    sampledHausdorffDistancesImpl<Traits>(cubics, quadratics, nCurves, distances);
+}
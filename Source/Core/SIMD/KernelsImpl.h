@@ -0,0 +1,426 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Core/SIMD/Kernels.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/****************************************************************************************************/
+/* Kernel bodies shared by all ISAs, written against a SIMD traits type S providing:
+ *   S::Float, S::Width, S::load, S::store, S::set1, S::add, S::sub, S::mul, S::div, S::sqrt,
+ *   S::min, S::max, S::Mask, S::greater, S::select,
+ *   S::Int, S::set1i, S::castToInt, S::castToFloat, S::andi, S::ori, S::addi, S::subi,
+ *   S::shiftLeft<N>, S::shiftRight<N>, S::roundToInt, S::toFloat
+ *
+ * This header is included by the per-ISA translation units only. Everything here has internal
+ * linkage and must not call out-of-line library functions: an inline function emitted in an AVX-512
+ * translation unit could otherwise be picked by the linker for the scalar code path.
+ */
+namespace {
+template<class S>
+inline void convertCubicsToQuadraticsImpl(const Core::CubicSoA& cubics, size_t nCurves, float gamma,
+                                          const Core::QuadraticSoA& quadratics) {
+    const float a = 1.5f * gamma;
+    const float b = 1.5f * (1.0f - gamma);
+    const float g = gamma;
+    const float h = 1.0f - gamma;
+    const auto  va = S::set1(a);
+    const auto  vb = S::set1(b);
+    const auto  vg = S::set1(g);
+    const auto  vh = S::set1(h);
+
+    for(size_t axis = 0; axis < 3; ++axis) {
+        const float* b0 = cubics.B[0][axis];
+        const float* b1 = cubics.B[1][axis];
+        const float* b2 = cubics.B[2][axis];
+        const float* b3 = cubics.B[3][axis];
+        float*       q0 = quadratics.Q[0][axis];
+        float*       q1 = quadratics.Q[1][axis];
+        float*       q2 = quadratics.Q[2][axis];
+        float*       q3 = quadratics.Q[3][axis];
+        float*       q4 = quadratics.Q[4][axis];
+
+        size_t i = 0;
+        for(; i + S::Width <= nCurves; i += S::Width) {
+            const auto B0 = S::load(b0 + i);
+            const auto B1 = S::load(b1 + i);
+            const auto B2 = S::load(b2 + i);
+            const auto B3 = S::load(b3 + i);
+            const auto Q1 = S::add(B0, S::mul(va, S::sub(B1, B0)));
+            const auto Q3 = S::sub(B3, S::mul(vb, S::sub(B3, B2)));
+            S::store(q0 + i, B0);
+            S::store(q1 + i, Q1);
+            S::store(q2 + i, S::add(S::mul(vh, Q1), S::mul(vg, Q3)));
+            S::store(q3 + i, Q3);
+            S::store(q4 + i, B3);
+        }
+
+        /* Remainder */
+        for(; i < nCurves; ++i) {
+            const float Q1 = b0[i] + a * (b1[i] - b0[i]);
+            const float Q3 = b3[i] - b * (b3[i] - b2[i]);
+            q0[i] = b0[i];
+            q1[i] = Q1;
+            q2[i] = h * Q1 + g * Q3;
+            q3[i] = Q3;
+            q4[i] = b3[i];
+        }
+    }
+}
+
+/* Same with one gamma per curve */
+template<class S>
+inline void convertCubicsToQuadraticsImpl(const Core::CubicSoA& cubics, size_t nCurves, const float* gammas,
+                                          const Core::QuadraticSoA& quadratics) {
+    const auto one        = S::set1(1.0f);
+    const auto oneAndHalf = S::set1(1.5f);
+
+    for(size_t axis = 0; axis < 3; ++axis) {
+        const float* b0 = cubics.B[0][axis];
+        const float* b1 = cubics.B[1][axis];
+        const float* b2 = cubics.B[2][axis];
+        const float* b3 = cubics.B[3][axis];
+        float*       q0 = quadratics.Q[0][axis];
+        float*       q1 = quadratics.Q[1][axis];
+        float*       q2 = quadratics.Q[2][axis];
+        float*       q3 = quadratics.Q[3][axis];
+        float*       q4 = quadratics.Q[4][axis];
+
+        size_t i = 0;
+        for(; i + S::Width <= nCurves; i += S::Width) {
+            const auto g  = S::load(gammas + i);
+            const auto h  = S::sub(one, g);
+            const auto B0 = S::load(b0 + i);
+            const auto B1 = S::load(b1 + i);
+            const auto B2 = S::load(b2 + i);
+            const auto B3 = S::load(b3 + i);
+            const auto Q1 = S::add(B0, S::mul(S::mul(oneAndHalf, g), S::sub(B1, B0)));
+            const auto Q3 = S::sub(B3, S::mul(S::mul(oneAndHalf, h), S::sub(B3, B2)));
+            S::store(q0 + i, B0);
+            S::store(q1 + i, Q1);
+            S::store(q2 + i, S::add(S::mul(h, Q1), S::mul(g, Q3)));
+            S::store(q3 + i, Q3);
+            S::store(q4 + i, B3);
+        }
+
+        /* Remainder */
+        for(; i < nCurves; ++i) {
+            const float g  = gammas[i];
+            const float h  = 1.0f - g;
+            const float Q1 = b0[i] + 1.5f * g * (b1[i] - b0[i]);
+            const float Q3 = b3[i] - 1.5f * h * (b3[i] - b2[i]);
+            q0[i] = b0[i];
+            q1[i] = Q1;
+            q2[i] = h * Q1 + g * Q3;
+            q3[i] = Q3;
+            q4[i] = b3[i];
+        }
+    }
+}
+
+/****************************************************************************************************/
+/* log2(x) for x > 0 (Cephes logf polynomial on the mantissa reduced to [sqrt(0.5), sqrt(2))) */
+template<class S>
+inline typename S::Float log2Impl(typename S::Float x) {
+    const auto bits     = S::castToInt(x);
+    auto       exponent = S::toFloat(S::subi(S::template shiftRight<23>(bits), S::set1i(127)));
+    auto       mantissa = S::castToFloat(S::ori(S::andi(bits, S::set1i(0x007fffff)), S::set1i(0x3f800000)));
+
+    /* Move mantissa from [1, 2) to [sqrt(0.5), sqrt(2)) */
+    const auto bigMantissa = S::greater(mantissa, S::set1(1.41421356f));
+    mantissa = S::select(bigMantissa, S::mul(mantissa, S::set1(0.5f)), mantissa);
+    exponent = S::select(bigMantissa, S::add(exponent, S::set1(1.0f)), exponent);
+
+    const auto m  = S::sub(mantissa, S::set1(1.0f));
+    const auto m2 = S::mul(m, m);
+    auto       p  = S::set1(7.0376836292e-2f);
+    p = S::add(S::mul(p, m), S::set1(-1.1514610310e-1f));
+    p = S::add(S::mul(p, m), S::set1(1.1676998740e-1f));
+    p = S::add(S::mul(p, m), S::set1(-1.2420140846e-1f));
+    p = S::add(S::mul(p, m), S::set1(1.4249322787e-1f));
+    p = S::add(S::mul(p, m), S::set1(-1.6668057665e-1f));
+    p = S::add(S::mul(p, m), S::set1(2.0000714765e-1f));
+    p = S::add(S::mul(p, m), S::set1(-2.4999993993e-1f));
+    p = S::add(S::mul(p, m), S::set1(3.3333331174e-1f));
+
+    /* ln(1 + m) = m - m^2 / 2 + m^3 * p(m) */
+    const auto ln = S::add(S::sub(m, S::mul(S::set1(0.5f), m2)), S::mul(S::mul(m2, m), p));
+    return S::add(exponent, S::mul(ln, S::set1(1.44269504089f)));
+}
+
+/* 2^x (Cephes exp2f polynomial on the fractional part in [-0.5, 0.5]) */
+template<class S>
+inline typename S::Float exp2Impl(typename S::Float x) {
+    x = S::min(S::max(x, S::set1(-126.0f)), S::set1(126.0f));
+    const auto n = S::roundToInt(x);
+    const auto f = S::sub(x, S::toFloat(n));
+    auto       p = S::set1(1.535336188319500e-4f);
+    p = S::add(S::mul(p, f), S::set1(1.339887440266574e-3f));
+    p = S::add(S::mul(p, f), S::set1(9.618437357674640e-3f));
+    p = S::add(S::mul(p, f), S::set1(5.550332471162809e-2f));
+    p = S::add(S::mul(p, f), S::set1(2.402264791363012e-1f));
+    p = S::add(S::mul(p, f), S::set1(6.931472028550421e-1f));
+    p = S::add(S::mul(p, f), S::set1(1.0f));
+
+    /* Scale by 2^n by adding n to the exponent bits */
+    return S::castToFloat(S::addi(S::castToInt(p), S::template shiftLeft<23>(n)));
+}
+
+/****************************************************************************************************/
+template<class S, class Scalar>
+inline void powLengthsLoop(const float* lengthsSqr, size_t n, float alpha, float* powers) {
+    const auto vHalfAlpha = S::set1(0.5f * alpha);
+    const auto vZero      = S::set1(0.0f);
+    size_t     i          = 0;
+    for(; i + S::Width <= n; i += S::Width) {
+        const auto x = S::load(lengthsSqr + i);
+        const auto y = exp2Impl<S>(S::mul(vHalfAlpha, log2Impl<S>(x)));
+        S::store(powers + i, S::select(S::greater(x, vZero), y, vZero));
+    }
+
+    /* Remainder */
+    for(; i < n; ++i) {
+        const float x = lengthsSqr[i];
+        powers[i] = x > 0.0f ? exp2Impl<Scalar>(0.5f * alpha * log2Impl<Scalar>(x)) : 0.0f;
+    }
+}
+
+/****************************************************************************************************/
+/* Square root without the out-of-line std::sqrt(float) overload, which non-optimized builds emit as a
+ * weak symbol shared by all translation units */
+inline float sqrtScalar(float a) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<float>(std::sqrt(static_cast<double>(a)));
+#else
+    return __builtin_sqrtf(a);
+#endif
+}
+
+/****************************************************************************************************/
+/* Plain C++ traits, used for the scalar code path and on non-x86 targets */
+struct ScalarTraits {
+    using Float = float;
+    static constexpr size_t Width = 1;
+    static Float load(const float* p) { return *p; }
+    static void store(float* p, Float v) { *p = v; }
+    static Float set1(float v) { return v; }
+    static Float add(Float a, Float b) { return a + b; }
+    static Float sub(Float a, Float b) { return a - b; }
+    static Float mul(Float a, Float b) { return a * b; }
+    static Float div(Float a, Float b) { return a / b; }
+    static Float sqrt(Float a) { return sqrtScalar(a); }
+    static Float min(Float a, Float b) { return a < b ? a : b; }
+    static Float max(Float a, Float b) { return a > b ? a : b; }
+
+    using Mask = bool;
+    static Mask greater(Float a, Float b) { return a > b; }
+    static Float select(Mask m, Float a, Float b) { return m ? a : b; }
+
+    using Int = int32_t;
+    static Int set1i(int v) { return v; }
+    static Int castToInt(Float a) { Int i; std::memcpy(&i, &a, sizeof(i)); return i; }
+    static Float castToFloat(Int a) { Float f; std::memcpy(&f, &a, sizeof(f)); return f; }
+    static Int andi(Int a, Int b) { return a & b; }
+    static Int ori(Int a, Int b) { return a | b; }
+    static Int addi(Int a, Int b) { return static_cast<Int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b)); }
+    static Int subi(Int a, Int b) { return static_cast<Int>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b)); }
+    template<int N> static Int shiftLeft(Int a) { return static_cast<Int>(static_cast<uint32_t>(a) << N); }
+    template<int N> static Int shiftRight(Int a) { return static_cast<Int>(static_cast<uint32_t>(a) >> N); }
+    static Int roundToInt(Float a) { return static_cast<Int>(a < 0.0f ? a - 0.5f : a + 0.5f); }
+    static Float toFloat(Int a) { return static_cast<Float>(a); }
+};
+
+/****************************************************************************************************/
+template<class S>
+inline void powLengthsImpl(const float* lengthsSqr, size_t n, float alpha, float* powers) {
+    powLengthsLoop<S, ScalarTraits>(lengthsSqr, n, alpha, powers);
+}
+
+/****************************************************************************************************/
+/* Cubic and quadratic pair control points of the curves [i, i + S::Width) along one axis */
+template<class S>
+struct PairLanes {
+    typename S::Float B[4], Q[5];
+
+    PairLanes(const Core::CubicSoA& cubics, const Core::QuadraticSoA& quadratics, size_t axis, size_t i) {
+        for(size_t k = 0; k < 4; ++k) {
+            B[k] = S::load(cubics.B[k][axis] + i);
+        }
+        for(size_t k = 0; k < 5; ++k) {
+            Q[k] = S::load(quadratics.Q[k][axis] + i);
+        }
+    }
+
+    typename S::Float cubic(float t) const {
+        const float mt = 1.0f - t;
+        return S::add(S::add(S::mul(S::set1(mt * mt * mt), B[0]), S::mul(S::set1(3.0f * mt * mt * t), B[1])),
+                      S::add(S::mul(S::set1(3.0f * mt * t * t), B[2]), S::mul(S::set1(t * t * t), B[3])));
+    }
+
+    /* Cubic at a different parameter per lane */
+    typename S::Float cubicPerLane(const typename S::Float& t) const {
+        const auto mt  = S::sub(S::set1(1.0f), t);
+        const auto mt2 = S::mul(mt, mt);
+        const auto t2  = S::mul(t, t);
+        return S::add(S::add(S::mul(S::mul(mt2, mt), B[0]), S::mul(S::mul(S::set1(3.0f), S::mul(mt2, t)), B[1])),
+                      S::add(S::mul(S::mul(S::set1(3.0f), S::mul(mt, t2)), B[2]), S::mul(S::mul(t2, t), B[3])));
+    }
+
+    /* First (half = 0, Q[0..2]) or second (half = 1, Q[2..4]) quadratic at its own parameter s */
+    typename S::Float quadraticHalf(int half, float s) const {
+        const size_t first = 2 * static_cast<size_t>(half);
+        const float  ms    = 1.0f - s;
+        return S::add(S::add(S::mul(S::set1(ms * ms), Q[first]), S::mul(S::set1(2.0f * ms * s), Q[first + 1])),
+                      S::mul(S::set1(s * s), Q[first + 2]));
+    }
+
+    /* Quadratic pair at t, the first half maps to Q[0..2] and the second one to Q[2..4] */
+    typename S::Float quadratic(float t) const {
+        return (t < 0.5f) ? quadraticHalf(0, 2.0f * t) : quadraticHalf(1, 2.0f * t - 1.0f);
+    }
+};
+
+/****************************************************************************************************/
+/* The quadratics of a pair match the cubic on [0, gamma] and [gamma, 1]. The gamma of each pair is
+ * recovered from its joint Q2 = (1 - gamma) * Q1 + gamma * Q3, and is 0.5 when Q1 = Q3 */
+template<class S>
+inline void l2ErrorsGroup(const Core::CubicSoA& cubics, const Core::QuadraticSoA& quadratics, size_t i, float* errors) {
+    /* 4-point Gauss-Legendre rule on [0, 1], exact for the degree 6 squared difference on each half */
+    constexpr float nodes[4]   = { 0.0694318442f, 0.3300094782f, 0.6699905218f, 0.9305681558f };
+    constexpr float weights[4] = { 0.1739274226f, 0.3260725774f, 0.3260725774f, 0.1739274226f };
+
+    const PairLanes<S> lanes[3] = { PairLanes<S>(cubics, quadratics, 0, i), PairLanes<S>(cubics, quadratics, 1, i),
+                                    PairLanes<S>(cubics, quadratics, 2, i) };
+    const auto zero = S::set1(0.0f);
+    const auto one  = S::set1(1.0f);
+    auto       num  = zero;
+    auto       den  = zero;
+    for(size_t axis = 0; axis < 3; ++axis) {
+        const auto d12 = S::sub(lanes[axis].Q[2], lanes[axis].Q[1]);
+        const auto d13 = S::sub(lanes[axis].Q[3], lanes[axis].Q[1]);
+        num = S::add(num, S::mul(d12, d13));
+        den = S::add(den, S::mul(d13, d13));
+    }
+    const auto ratio  = S::min(S::max(S::div(num, S::max(den, S::set1(1.0e-30f))), zero), one);
+    const auto gamma  = S::select(S::greater(den, zero), ratio, S::set1(0.5f));
+    const auto mGamma = S::sub(one, gamma);
+
+    auto sum = zero;
+    for(int k = 0; k < 4; ++k) {
+        const auto t0     = S::mul(gamma, S::set1(nodes[k]));
+        const auto t1     = S::add(gamma, S::mul(mGamma, S::set1(nodes[k])));
+        auto       first  = zero;
+        auto       second = zero;
+        for(size_t axis = 0; axis < 3; ++axis) {
+            const auto diff0 = S::sub(lanes[axis].cubicPerLane(t0), lanes[axis].quadraticHalf(0, nodes[k]));
+            const auto diff1 = S::sub(lanes[axis].cubicPerLane(t1), lanes[axis].quadraticHalf(1, nodes[k]));
+            first  = S::add(first, S::mul(diff0, diff0));
+            second = S::add(second, S::mul(diff1, diff1));
+        }
+        /* The halves span gamma and 1 - gamma of the cubic parameter */
+        sum = S::add(sum, S::mul(S::set1(weights[k]), S::add(S::mul(gamma, first), S::mul(mGamma, second))));
+    }
+    S::store(errors + i, S::sqrt(sum));
+}
+
+template<class S>
+inline void l2ErrorsImpl(const Core::CubicSoA& cubics, const Core::QuadraticSoA& quadratics, size_t nCurves, float* errors) {
+    size_t i = 0;
+    for(; i + S::Width <= nCurves; i += S::Width) {
+        l2ErrorsGroup<S>(cubics, quadratics, i, errors);
+    }
+
+    /* Remainder */
+    for(; i < nCurves; ++i) {
+        l2ErrorsGroup<ScalarTraits>(cubics, quadratics, i, errors);
+    }
+}
+
+/****************************************************************************************************/
+/* Squared distance from every sample of a to the polyline b, maximized over the samples */
+template<class S>
+inline typename S::Float maxPolylineDistanceSqr(const typename S::Float (&a)[3][Core::Kernels::HausdorffSegments + 1],
+                                                const typename S::Float (&b)[3][Core::Kernels::HausdorffSegments + 1]) {
+    constexpr int N = Core::Kernels::HausdorffSegments;
+
+    /* Segment directions and inverse squared lengths, degenerate segments project to their start */
+    typename S::Float e[3][N], invLengthSqr[N];
+    for(int j = 0; j < N; ++j) {
+        for(int axis = 0; axis < 3; ++axis) {
+            e[axis][j] = S::sub(b[axis][j + 1], b[axis][j]);
+        }
+        const auto lengthSqr = S::add(S::add(S::mul(e[0][j], e[0][j]), S::mul(e[1][j], e[1][j])), S::mul(e[2][j], e[2][j]));
+        invLengthSqr[j] = S::div(S::set1(1.0f), S::max(lengthSqr, S::set1(1.0e-30f)));
+    }
+
+    const auto zero   = S::set1(0.0f);
+    const auto one    = S::set1(1.0f);
+    auto       result = zero;
+    for(int p = 0; p <= N; ++p) {
+        auto minDistSqr = S::set1(3.0e38f);
+        for(int j = 0; j < N; ++j) {
+            const auto dx = S::sub(a[0][p], b[0][j]);
+            const auto dy = S::sub(a[1][p], b[1][j]);
+            const auto dz = S::sub(a[2][p], b[2][j]);
+            const auto proj = S::add(S::add(S::mul(dx, e[0][j]), S::mul(dy, e[1][j])), S::mul(dz, e[2][j]));
+            const auto t    = S::min(S::max(S::mul(proj, invLengthSqr[j]), zero), one);
+            const auto rx   = S::sub(dx, S::mul(t, e[0][j]));
+            const auto ry   = S::sub(dy, S::mul(t, e[1][j]));
+            const auto rz   = S::sub(dz, S::mul(t, e[2][j]));
+            minDistSqr = S::min(minDistSqr, S::add(S::add(S::mul(rx, rx), S::mul(ry, ry)), S::mul(rz, rz)));
+        }
+        result = S::max(result, minDistSqr);
+    }
+    return result;
+}
+
+template<class S>
+inline void sampledHausdorffGroup(const Core::CubicSoA& cubics, const Core::QuadraticSoA& quadratics, size_t i,
+                                  float* distances) {
+    constexpr int     N = Core::Kernels::HausdorffSegments;
+    typename S::Float cubicSamples[3][N + 1], quadraticSamples[3][N + 1];
+    for(size_t axis = 0; axis < 3; ++axis) {
+        const PairLanes<S> lanes(cubics, quadratics, axis, i);
+        for(int j = 0; j <= N; ++j) {
+            const float t = static_cast<float>(j) / static_cast<float>(N);
+            cubicSamples[axis][j]     = lanes.cubic(t);
+            quadraticSamples[axis][j] = lanes.quadratic(t);
+        }
+    }
+    const auto distSqr = S::max(maxPolylineDistanceSqr<S>(cubicSamples, quadraticSamples),
+                                maxPolylineDistanceSqr<S>(quadraticSamples, cubicSamples));
+    S::store(distances + i, S::sqrt(distSqr));
+}
+
+template<class S>
+inline void sampledHausdorffDistancesImpl(const Core::CubicSoA& cubics, const Core::QuadraticSoA& quadratics, size_t nCurves,
+                                          float* distances) {
+    size_t i = 0;
+    for(; i + S::Width <= nCurves; i += S::Width) {
+        sampledHausdorffGroup<S>(cubics, quadratics, i, distances);
+    }
+
+    /* Remainder */
+    for(; i < nCurves; ++i) {
+        sampledHausdorffGroup<ScalarTraits>(cubics, quadratics, i, distances);
+    }
+}
+}
@@ -0,0 +1,45 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/SIMD/KernelsImpl.h"
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadraticsScalar(const CubicSoA& cubics, size_t nCurves, float gamma,
+                                                    const QuadraticSoA& quadratics) {
+    convertCubicsToQuadraticsImpl<ScalarTraits>(cubics, nCurves, gamma, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::convertCubicsToQuadraticsScalar(const CubicSoA& cubics, size_t nCurves, const float* gammas,
+                                                    const QuadraticSoA& quadratics) {
+    convertCubicsToQuadraticsImpl<ScalarTraits>(cubics, nCurves, gammas, quadratics);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::powLengthsScalar(const float* lengthsSqr, size_t n, float alpha, float* powers) {
+    powLengthsImpl<ScalarTraits>(lengthsSqr, n, alpha, powers);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::l2ErrorsScalar(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves, float* errors) {
+    l2ErrorsImpl<ScalarTraits>(cubics, quadratics, nCurves, errors);
+}
+
+/****************************************************************************************************/
+void Core::Kernels::sampledHausdorffDistancesScalar(const CubicSoA& cubics, const QuadraticSoA& quadratics, size_t nCurves,
+                                                    float* distances) {
+    sampledHausdorffDistancesImpl<ScalarTraits>(cubics, quadratics, nCurves, distances);
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/****************************************************************************************************/
+/* Registry of objects by ID, for O(1) lookups from the IDs written to an object ID buffer.
+ *
+ * IDs start at 1, 0 being the background. The generation of a slot is incremented when its object is
+ * removed, so that a handle taken before no longer resolves, and free slots are reused last in first out.
+ */
+namespace Core {
+template<class T>
+class SlotRegistry {
+public:
+    /* An ID with the generation of its slot */
+    struct Handle {
+        uint32_t idx { 0 };
+        uint32_t generation { 0 };
+    };
+
+    /* Returns the ID of object */
+    uint32_t add(T* object) {
+        uint32_t slot;
+        if(!m_FreeSlots.empty()) {
+            slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(m_Slots.size());
+            m_Slots.emplace_back();
+        }
+        m_Slots[slot].object = object;
+        return slot + 1;
+    }
+
+    /* idx must be the ID of a registered object */
+    void remove(uint32_t idx) {
+        auto& slot = m_Slots[idx - 1];
+        assert(slot.object);
+        slot.object = nullptr;
+        ++slot.generation;
+        m_FreeSlots.push_back(idx - 1);
+        ++m_nRemovals;
+    }
+
+    /* nullptr for the background, a free ID or a stale handle */
+    T* get(uint32_t idx) const {
+        return (idx > 0 && idx <= m_Slots.size()) ? m_Slots[idx - 1].object : nullptr;
+    }
+    T* get(const Handle& handle) const {
+        const auto object = get(handle.idx);
+        return (object && m_Slots[handle.idx - 1].generation == handle.generation) ? object : nullptr;
+    }
+    Handle handle(uint32_t idx) const { return Handle{ idx, m_Slots[idx - 1].generation }; }
+
+    /* Call function(object) for each registered object, in ID order */
+    template<class Function>
+    void forEach(const Function& function) const {
+        for(const auto& slot : m_Slots) {
+            if(slot.object) {
+                function(slot.object);
+            }
+        }
+    }
+
+    size_t size() const { return m_Slots.size() - m_FreeSlots.size(); }
+
+    /* Number of remove() calls so far: an ID read while it had another value may name a newer object */
+    uint64_t removalCount() const { return m_nRemovals; }
+    void reserve(size_t nObjects) { m_Slots.reserve(nObjects); }
+
+private:
+    struct Slot {
+        T*       object { nullptr };
+        uint32_t generation { 0 };
+    };
+    std::vector<Slot>     m_Slots;
+    std::vector<uint32_t> m_FreeSlots;
+    uint64_t              m_nRemovals { 0 };
+};
+} // namespace Core
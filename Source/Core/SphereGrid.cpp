@@ -0,0 +1,203 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Core/SphereGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/****************************************************************************************************/
+namespace {
+/* Smallest t >= 0 where the ray hits the sphere, or infinity */
+float intersectSphere(const Core::Point3& origin, const Core::Point3& direction, float a,
+                      const Core::Point3& center, float radius) {
+    const auto oc = origin - center;
+    const auto b  = Core::dot(oc, direction);
+    const auto c  = Core::dot(oc, oc) - radius * radius;
+    const auto d  = b * b - a * c;
+    if(d < 0.0f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    const auto sqrtD = std::sqrt(d);
+    auto       t     = (-b - sqrtD) / a;
+    if(t < 0.0f) {
+        t = (-b + sqrtD) / a; /* origin inside the sphere */
+    }
+    return t >= 0.0f ? t : std::numeric_limits<float>::infinity();
+}
+
+float component(const Core::Point3& p, int axis) {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+}
+
+/****************************************************************************************************/
+void Core::SphereGrid::build(const Point3* centers, const float* radii, size_t nSpheres) {
+    m_Centers.assign(centers, centers + nSpheres);
+    m_Radii.assign(radii, radii + nSpheres);
+    m_CellStart.clear();
+    m_CellSpheres.clear();
+    m_Resolution[0] = m_Resolution[1] = m_Resolution[2] = 0;
+    if(nSpheres == 0) {
+        return;
+    }
+
+    Point3 lo = centers[0], hi = centers[0];
+    float  maxRadius = 0.0f;
+    for(size_t idx = 0; idx < nSpheres; ++idx) {
+        const auto& c = centers[idx];
+        const auto  r = radii[idx];
+        lo = { std::min(lo.x, c.x - r), std::min(lo.y, c.y - r), std::min(lo.z, c.z - r) };
+        hi = { std::max(hi.x, c.x + r), std::max(hi.y, c.y + r), std::max(hi.z, c.z + r) };
+        maxRadius = std::max(maxRadius, r);
+    }
+
+    /* About one cell per sphere, never smaller than the largest sphere. Flat extents are widened for the
+     * estimate, and the cell size grows until the cell count is bounded by the sphere count */
+    const auto extent    = hi - lo;
+    const auto maxExtent = std::max({ extent.x, extent.y, extent.z });
+    const auto minExtent = std::max(maxExtent * 1.0e-3f, 1.0e-6f);
+    const auto volume    = std::max(extent.x, minExtent) * std::max(extent.y, minExtent) * std::max(extent.z, minExtent);
+    m_CellSize = std::max({ std::cbrt(volume / static_cast<float>(nSpheres)), 2.0f * maxRadius, minExtent });
+    size_t nCells;
+    while(true) {
+        nCells = 1;
+        for(int axis = 0; axis < 3; ++axis) {
+            m_Resolution[axis] = std::max(1, static_cast<int>(std::ceil(component(extent, axis) / m_CellSize)));
+            nCells            *= static_cast<size_t>(m_Resolution[axis]);
+        }
+        if(nCells <= 8 * nSpheres + 64) {
+            break;
+        }
+        m_CellSize *= 1.25f;
+    }
+    m_Min = lo;
+
+    /* Counting sort of the (cell, sphere) pairs */
+    auto forEachCell = [&](size_t idx, auto&& f) {
+                           const auto& c = centers[idx];
+                           const auto  r = radii[idx];
+                           int         first[3], last[3];
+                           for(int axis = 0; axis < 3; ++axis) {
+                               const auto o = component(c, axis) - component(m_Min, axis);
+                               first[axis] = std::clamp(static_cast<int>((o - r) / m_CellSize), 0, m_Resolution[axis] - 1);
+                               last[axis]  = std::clamp(static_cast<int>((o + r) / m_CellSize), 0, m_Resolution[axis] - 1);
+                           }
+                           for(int z = first[2]; z <= last[2]; ++z) {
+                               for(int y = first[1]; y <= last[1]; ++y) {
+                                   for(int x = first[0]; x <= last[0]; ++x) {
+                                       f(cellIndex(x, y, z));
+                                   }
+                               }
+                           }
+                       };
+    m_CellStart.assign(nCells + 1, 0);
+    for(size_t idx = 0; idx < nSpheres; ++idx) {
+        forEachCell(idx, [&](size_t cell) { ++m_CellStart[cell + 1]; });
+    }
+    for(size_t cell = 0; cell < nCells; ++cell) {
+        m_CellStart[cell + 1] += m_CellStart[cell];
+    }
+    m_CellSpheres.resize(m_CellStart[nCells]);
+    std::vector<uint32_t> fill(m_CellStart.begin(), m_CellStart.end() - 1);
+    for(size_t idx = 0; idx < nSpheres; ++idx) {
+        forEachCell(idx, [&](size_t cell) { m_CellSpheres[fill[cell]++] = static_cast<uint32_t>(idx); });
+    }
+}
+
+/****************************************************************************************************/
+int64_t Core::SphereGrid::raycast(const Point3& origin, const Point3& direction) const {
+    const auto a = dot(direction, direction);
+    if(m_Centers.empty() || a == 0.0f) {
+        return -1;
+    }
+
+    /* Clip the ray to the grid bounds (slab test) */
+    float tEnter = 0.0f, tExit = std::numeric_limits<float>::infinity();
+    for(int axis = 0; axis < 3; ++axis) {
+        const auto o  = component(origin, axis);
+        const auto d  = component(direction, axis);
+        const auto lo = component(m_Min, axis);
+        const auto hi = lo + static_cast<float>(m_Resolution[axis]) * m_CellSize;
+        if(d == 0.0f) {
+            if(o < lo || o > hi) {
+                return -1;
+            }
+            continue;
+        }
+        auto t0 = (lo - o) / d, t1 = (hi - o) / d;
+        if(t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tEnter = std::max(tEnter, t0);
+        tExit  = std::min(tExit, t1);
+    }
+    if(tEnter > tExit) {
+        return -1;
+    }
+
+    /* Walk the cells along the ray (Amanatides and Woo) */
+    int   cell[3], step[3];
+    float tMax[3], tDelta[3];
+    const auto entry = origin + tEnter * direction;
+    for(int axis = 0; axis < 3; ++axis) {
+        const auto d = component(direction, axis);
+        cell[axis] = std::clamp(static_cast<int>((component(entry, axis) - component(m_Min, axis)) / m_CellSize), 0,
+                                m_Resolution[axis] - 1);
+        if(d > 0.0f) {
+            step[axis]   = 1;
+            tMax[axis]   = (component(m_Min, axis) + static_cast<float>(cell[axis] + 1) * m_CellSize - component(origin, axis)) / d;
+            tDelta[axis] = m_CellSize / d;
+        } else if(d < 0.0f) {
+            step[axis]   = -1;
+            tMax[axis]   = (component(m_Min, axis) + static_cast<float>(cell[axis]) * m_CellSize - component(origin, axis)) / d;
+            tDelta[axis] = -m_CellSize / d;
+        } else {
+            step[axis]   = 0;
+            tMax[axis]   = std::numeric_limits<float>::infinity();
+            tDelta[axis] = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    int64_t bestSphere = -1;
+    float   bestT      = std::numeric_limits<float>::infinity();
+    while(true) {
+        const auto c = cellIndex(cell[0], cell[1], cell[2]);
+        for(auto k = m_CellStart[c]; k < m_CellStart[c + 1]; ++k) {
+            const auto idx = m_CellSpheres[k];
+            const auto t   = intersectSphere(origin, direction, a, m_Centers[idx], m_Radii[idx]);
+            if(t < bestT) {
+                bestT      = t;
+                bestSphere = idx;
+            }
+        }
+
+        /* A hit inside this cell cannot be beaten by spheres of the following cells */
+        const auto axis     = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+        const auto tCellEnd = tMax[axis];
+        if(bestT <= tCellEnd || tCellEnd > tExit) {
+            break;
+        }
+        cell[axis] += step[axis];
+        if(cell[axis] < 0 || cell[axis] >= m_Resolution[axis]) {
+            break;
+        }
+        tMax[axis] += tDelta[axis];
+    }
+    return bestSphere;
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Core/CurveMath.h"
+
+#include <cstdint>
+#include <vector>
+
+/****************************************************************************************************/
+/* Uniform grid over spheres, for picking by ray casting without reading back the object ID buffer.
+ *
+ * Every sphere is listed in all cells overlapped by its bounding box. The cell size is at least the
+ * largest diameter, so that a sphere overlaps at most 8 cells, and the grid has about one cell per
+ * sphere. raycast() walks the cells pierced by the ray in order (3D DDA) and stops at the first cell
+ * containing the nearest hit, so a pick only tests the spheres near the ray.
+ */
+namespace Core {
+class SphereGrid {
+public:
+    /* Index the spheres, which are copied */
+    void build(const Point3* centers, const float* radii, size_t nSpheres);
+
+    /* Index of the sphere hit first by the ray origin + t * direction (t >= 0), -1 if none */
+    int64_t raycast(const Point3& origin, const Point3& direction) const;
+
+    size_t sphereCount() const { return m_Centers.size(); }
+
+private:
+    size_t cellIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * static_cast<size_t>(m_Resolution[1]) + static_cast<size_t>(y)) *
+               static_cast<size_t>(m_Resolution[0]) + static_cast<size_t>(x);
+    }
+
+    std::vector<Point3>   m_Centers;
+    std::vector<float>    m_Radii;
+    Point3                m_Min { 0.0f, 0.0f, 0.0f };
+    float                 m_CellSize { 1.0f };
+    int                   m_Resolution[3] { 0, 0, 0 };
+    std::vector<uint32_t> m_CellStart; /* spheres of cell c are m_CellSpheres[m_CellStart[c], m_CellStart[c + 1]) */
+    std::vector<uint32_t> m_CellSpheres;
+};
+} // namespace Core
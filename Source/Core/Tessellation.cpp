@@ -0,0 +1,274 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/PowerBasis.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+
+/****************************************************************************************************/
+namespace {
+using Core::Point3;
+using Core::TessellationMethod;
+
+using PowerBasis = Core::CubicPolynomial<Point3>;
+
+inline PowerBasis quadraticPowerBasis(const Point3* Q) {
+    return PowerBasis(Core::QuadraticPolynomial<Point3>(Q));
+}
+
+/****************************************************************************************************/
+/* Evaluate P at s0 + i * h for i in [0, count) */
+template<TessellationMethod method>
+void evaluateSpan(const PowerBasis& P, float s0, float h, int count, Point3* out) {
+    if constexpr (method == TessellationMethod::ForwardDifferencing) {
+        const auto h2 = h * h;
+        const auto h3 = h2 * h;
+        auto       p  = P.value(s0);
+        auto       d1 = (3.0f * s0 * s0 * h + 3.0f * s0 * h2 + h3) * P.a + (2.0f * s0 * h + h2) * P.b + h * P.c;
+        auto       d2 = (6.0f * s0 * h2 + 6.0f * h3) * P.a + 2.0f * h2 * P.b;
+        const auto d3 = 6.0f * h3 * P.a;
+        for(int i = 0; i < count; ++i) {
+            out[i] = p;
+            p     += d1;
+            d1    += d2;
+            d2    += d3;
+        }
+    } else {
+        for(int i = 0; i < count; ++i) {
+            out[i] = P.value(s0 + static_cast<float>(i) * h);
+        }
+    }
+}
+
+/****************************************************************************************************/
+template<TessellationMethod method>
+void tessellateCubic(const Point3* B, int subdivision, Point3* out) {
+    const auto step = 1.0f / static_cast<float>(subdivision);
+    if constexpr (method == TessellationMethod::Bernstein) {
+        for(int i = 0; i <= subdivision; ++i) {
+            out[i] = Core::evaluateCubic(B, static_cast<float>(i) * step);
+        }
+    } else {
+        evaluateSpan<method>(PowerBasis(B), 0.0f, step, subdivision + 1, out);
+        out[subdivision] = B[3];
+    }
+}
+
+/****************************************************************************************************/
+template<TessellationMethod method>
+void tessellateQuadraticPair(const Point3* Q, int subdivision, Point3* out) {
+    const auto step = 1.0f / static_cast<float>(subdivision);
+    if constexpr (method == TessellationMethod::Bernstein) {
+        for(int i = 0; i <= subdivision; ++i) {
+            out[i] = Core::evaluateQuadraticPair(Q, static_cast<float>(i) * step);
+        }
+    } else {
+        /* Samples with t < 0.5 are on the first quadratic, the others on the second one */
+        const int nFirstHalf = (subdivision + 1) / 2;
+        const int nLastHalf  = subdivision + 1 - nFirstHalf;
+        evaluateSpan<method>(quadraticPowerBasis(Q), 0.0f, 2.0f * step, nFirstHalf, out);
+        evaluateSpan<method>(quadraticPowerBasis(Q + 2),
+                             static_cast<float>(2 * nFirstHalf - subdivision) * step, 2.0f * step,
+                             nLastHalf, out + nFirstHalf);
+        out[subdivision] = Q[4];
+    }
+}
+
+/****************************************************************************************************/
+/* Maximum recursion depth of the adaptive cubic tessellation (at most 2^16 segments per curve) */
+constexpr int MaxAdaptiveDepth = 16;
+
+bool isFlatCubic(const Point3* B, float flatness) {
+    const auto u = 3.0f * B[1] - 2.0f * B[0] - B[3];
+    const auto v = 3.0f * B[2] - B[0] - 2.0f * B[3];
+    return std::max(u.x * u.x, v.x * v.x) +
+           std::max(u.y * u.y, v.y * v.y) +
+           std::max(u.z * u.z, v.z * v.z) <= flatness;
+}
+
+void appendAdaptiveCubic(const Point3* B, float tolerance, std::vector<Point3>& points) {
+    struct Piece {
+        Point3 B[4];
+        int    depth;
+    };
+    const auto flatness = 16.0f * tolerance * tolerance;
+    Piece      stack[MaxAdaptiveDepth + 2];
+    int        top = 0;
+    stack[0] = Piece{ { B[0], B[1], B[2], B[3] }, 0 };
+    points.push_back(B[0]);
+
+    /* Depth-first traversal, left pieces first, emitting the end point of every flat piece */
+    while(top >= 0) {
+        const Piece piece = stack[top--];
+        const auto* P     = piece.B;
+        if(piece.depth >= MaxAdaptiveDepth || isFlatCubic(P, flatness)) {
+            points.push_back(P[3]);
+            continue;
+        }
+
+        const auto P01   = 0.5f * (P[0] + P[1]);
+        const auto P12   = 0.5f * (P[1] + P[2]);
+        const auto P23   = 0.5f * (P[2] + P[3]);
+        const auto P012  = 0.5f * (P01 + P12);
+        const auto P123  = 0.5f * (P12 + P23);
+        const auto P0123 = 0.5f * (P012 + P123);
+        stack[++top] = Piece{ { P0123, P123, P23, P[3] }, piece.depth + 1 };
+        stack[++top] = Piece{ { P[0], P01, P012, P0123 }, piece.depth + 1 };
+    }
+}
+
+/* Uniform sampling of a quadratic with the smallest segment count meeting the tolerance, as the
+ * deviation of a quadratic from its chord is exactly |Q0 - 2Q1 + Q2| / 4 */
+void appendAdaptiveQuadratic(const Point3* Q, float tolerance, std::vector<Point3>& points) {
+    const auto deviation = length(Q[0] - 2.0f * Q[1] + Q[2]);
+    const auto n         = std::clamp(static_cast<int>(std::ceil(std::sqrt(deviation / (4.0f * tolerance)))),
+                                      1, 1 << MaxAdaptiveDepth);
+    const auto first     = points.size();
+    points.resize(first + static_cast<size_t>(n));
+    evaluateSpan<TessellationMethod::Horner>(quadraticPowerBasis(Q), 0.0f, 1.0f / static_cast<float>(n), n,
+                                             &points[first]);
+}
+
+/****************************************************************************************************/
+/* Number of generated points per task of the thread pool */
+constexpr size_t GrainPoints = 1 << 16;
+
+/* Number of curves per task of the adaptive tessellation, whose output sizes are not known upfront */
+constexpr size_t AdaptiveGrainSize = 1024;
+
+template<TessellationMethod method>
+void tessellateCurves(Core::CurveType type, const Point3* controlPoints, size_t begin, size_t end, int subdivision,
+                      Point3* points) {
+    const auto nPoints = static_cast<size_t>(subdivision + 1);
+    if(type == Core::CurveType::CubicBezier) {
+        for(size_t idx = begin; idx < end; ++idx) {
+            tessellateCubic<method>(&controlPoints[idx * 4], subdivision, &points[idx * nPoints]);
+        }
+    } else {
+        for(size_t idx = begin; idx < end; ++idx) {
+            tessellateQuadraticPair<method>(&controlPoints[idx * 5], subdivision, &points[idx * nPoints]);
+        }
+    }
+}
+
+template<TessellationMethod method>
+void tessellateCurves(Core::CurveType type, const Point3* controlPoints, size_t nCurves, int subdivision,
+                      Point3* points) {
+    /* Every curve writes its own (subdivision + 1) points */
+    const auto grainSize = std::max<size_t>(1, GrainPoints / static_cast<size_t>(subdivision + 1));
+    Core::threadPool()->parallelFor(0, nCurves, grainSize, [&](size_t begin, size_t end) {
+                                        tessellateCurves<method>(type, controlPoints, begin, end, subdivision, points);
+                                    });
+}
+}
+
+/****************************************************************************************************/
+void Core::tessellate(CurveType type, const Point3* controlPoints, size_t nCurves, int subdivision,
+                      Point3* points, TessellationMethod method /*= TessellationMethod::Horner*/) {
+    assert(subdivision > 0);
+    switch(method) {
+        case TessellationMethod::Bernstein:
+            tessellateCurves<TessellationMethod::Bernstein>(type, controlPoints, nCurves, subdivision, points);
+            break;
+        case TessellationMethod::Horner:
+            tessellateCurves<TessellationMethod::Horner>(type, controlPoints, nCurves, subdivision, points);
+            break;
+        case TessellationMethod::ForwardDifferencing:
+            tessellateCurves<TessellationMethod::ForwardDifferencing>(type, controlPoints, nCurves, subdivision, points);
+            break;
+    }
+}
+
+/****************************************************************************************************/
+void Core::tessellate(CurveType type, const Point3* controlPoints, size_t nCurves, int subdivision,
+                      std::vector<Point3>& points, TessellationMethod method /*= TessellationMethod::Horner*/) {
+    points.resize(tessellatedPointCount(nCurves, subdivision));
+    tessellate(type, controlPoints, nCurves, subdivision, points.data(), method);
+}
+
+/****************************************************************************************************/
+void Core::tessellateCurve(CurveType type, const Point3* controlPoints, int subdivision, Point3* points,
+                           TessellationMethod method /*= TessellationMethod::Horner*/) {
+    assert(subdivision > 0);
+    switch(method) {
+        case TessellationMethod::Bernstein:
+            tessellateCurves<TessellationMethod::Bernstein>(type, controlPoints, 0, 1, subdivision, points);
+            break;
+        case TessellationMethod::Horner:
+            tessellateCurves<TessellationMethod::Horner>(type, controlPoints, 0, 1, subdivision, points);
+            break;
+        case TessellationMethod::ForwardDifferencing:
+            tessellateCurves<TessellationMethod::ForwardDifferencing>(type, controlPoints, 0, 1, subdivision, points);
+            break;
+    }
+}
+
+/****************************************************************************************************/
+void Core::appendAdaptiveTessellation(CurveType type, const Point3* controlPoints, float tolerance,
+                                      std::vector<Point3>& points) {
+    assert(tolerance > 0.0f);
+    if(type == CurveType::CubicBezier) {
+        appendAdaptiveCubic(controlPoints, tolerance, points);
+    } else {
+        /* The end point of each half is the start point of the next one */
+        appendAdaptiveQuadratic(controlPoints, tolerance, points);
+        appendAdaptiveQuadratic(controlPoints + 2, tolerance, points);
+        points.push_back(controlPoints[4]);
+    }
+}
+
+/****************************************************************************************************/
+void Core::tessellateAdaptive(CurveType type, const Point3* controlPoints, size_t nCurves, float tolerance,
+                              std::vector<Point3>& points, std::vector<size_t>& offsets) {
+    const auto nControlPoints = controlPointCount(type);
+    offsets.resize(nCurves + 1);
+    offsets[0] = 0;
+
+    /* Fixed chunks tessellated into their own buffers, then concatenated at their prefix sum */
+    const auto nChunks = (nCurves + AdaptiveGrainSize - 1) / AdaptiveGrainSize;
+    std::vector<std::vector<Point3>> chunkPoints(nChunks);
+    threadPool()->parallelFor(0, nChunks, 1, [&](size_t begin, size_t end) {
+                                  for(size_t chunk = begin; chunk < end; ++chunk) {
+                                      const auto first = chunk * AdaptiveGrainSize;
+                                      const auto last  = std::min(first + AdaptiveGrainSize, nCurves);
+                                      for(size_t idx = first; idx < last; ++idx) {
+                                          appendAdaptiveTessellation(type, &controlPoints[idx * nControlPoints],
+                                                                     tolerance, chunkPoints[chunk]);
+                                          offsets[idx + 1] = chunkPoints[chunk].size();
+                                      }
+                                  }
+                              });
+
+    std::vector<size_t> chunkOffsets(nChunks + 1, 0);
+    for(size_t chunk = 0; chunk < nChunks; ++chunk) {
+        chunkOffsets[chunk + 1] = chunkOffsets[chunk] + chunkPoints[chunk].size();
+    }
+    points.resize(chunkOffsets[nChunks]);
+    threadPool()->parallelFor(0, nChunks, 1, [&](size_t begin, size_t end) {
+                                  for(size_t chunk = begin; chunk < end; ++chunk) {
+                                      std::copy(chunkPoints[chunk].begin(), chunkPoints[chunk].end(),
+                                                points.begin() + static_cast<std::ptrdiff_t>(chunkOffsets[chunk]));
+                                      const auto first = chunk * AdaptiveGrainSize;
+                                      const auto last  = std::min(first + AdaptiveGrainSize, nCurves);
+                                      for(size_t idx = first; idx < last; ++idx) {
+                                          offsets[idx + 1] += chunkOffsets[chunk];
+                                      }
+                                  }
+                              });
+}
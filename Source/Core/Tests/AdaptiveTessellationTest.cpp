@@ -0,0 +1,122 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* The adaptive tessellation meets its tolerance: dense samples of every curve lie within tolerance of
+ * the polyline, the polyline starts and ends at the curve end points, and the batch version matches
+ * the single-curve one */
+namespace {
+using Core::CurveType;
+using Core::Point3;
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 100.0f;
+
+/* Number of curve samples checked against the polyline */
+constexpr int CheckedSamples = 2048;
+
+float distanceToSegment(const Point3& p, const Point3& a, const Point3& b) {
+    const auto ab        = b - a;
+    const auto lengthSqr = lengthSquared(ab);
+    const auto t         = lengthSqr > 0.0f ? std::clamp(dot(p - a, ab) / lengthSqr, 0.0f, 1.0f) : 0.0f;
+    return length(p - (a + t * ab));
+}
+
+float distanceToPolyline(const Point3& p, const Point3* polyline, size_t nPoints) {
+    float distance = length(p - polyline[0]);
+    for(size_t i = 0; i + 1 < nPoints; ++i) {
+        distance = std::min(distance, distanceToSegment(p, polyline[i], polyline[i + 1]));
+    }
+    return distance;
+}
+
+/* Maximum distance from the curve samples to the polyline */
+float maxDeviation(CurveType type, const Point3* controlPoints, const Point3* polyline, size_t nPoints) {
+    float deviation = 0;
+    for(int i = 0; i <= CheckedSamples; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(CheckedSamples);
+        const auto p = type == CurveType::CubicBezier ? Core::evaluateCubic(controlPoints, t) :
+                       Core::evaluateQuadraticPair(controlPoints, t);
+        deviation = std::max(deviation, distanceToPolyline(p, polyline, nPoints));
+    }
+    return deviation;
+}
+
+bool samePoint(const Point3& a, const Point3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937                          rng(5);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+
+    const size_t nCurves = 40;
+    for(const auto type : { CurveType::CubicBezier, CurveType::QuadraticPair }) {
+        const auto          nControlPoints = Core::controlPointCount(type);
+        std::vector<Point3> controlPoints(nCurves * nControlPoints);
+        for(auto& p : controlPoints) {
+            p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        }
+        /* A straight curve needs a single segment per piece */
+        for(size_t k = 0; k < nControlPoints; ++k) {
+            controlPoints[k] = Point3{ static_cast<float>(k), 0.0f, 0.0f };
+        }
+
+        size_t previousCount = 0;
+        for(const float tolerance : { 10.0f, 1.0f, 0.1f, 0.01f }) {
+            std::vector<Point3> points;
+            std::vector<size_t> offsets;
+            Core::tessellateAdaptive(type, controlPoints.data(), nCurves, tolerance, points, offsets);
+            CHECK(offsets.size() == nCurves + 1);
+            CHECK(offsets.front() == 0 && offsets.back() == points.size());
+
+            for(size_t idx = 0; idx < nCurves; ++idx) {
+                const auto* P       = &controlPoints[idx * nControlPoints];
+                const auto* first   = &points[offsets[idx]];
+                const auto  nPoints = offsets[idx + 1] - offsets[idx];
+                CHECK(nPoints >= 2);
+                CHECK(samePoint(first[0], P[0]));
+                CHECK(samePoint(first[nPoints - 1], P[nControlPoints - 1]));
+
+                /* Rounding of the samples and of the distances */
+                CHECK(maxDeviation(type, P, first, nPoints) <= tolerance + 1.0e-5f * CoordinateRange);
+
+                /* The batch version writes the same points as the single-curve one */
+                std::vector<Point3> single;
+                Core::appendAdaptiveTessellation(type, P, tolerance, single);
+                CHECK(single.size() == nPoints);
+                CHECK(std::equal(single.begin(), single.end(), first, samePoint));
+            }
+            CHECK(offsets[1] == (type == CurveType::CubicBezier ? 2u : 3u));
+
+            /* Tighter tolerances give more points */
+            CHECK(points.size() > previousCount);
+            previousCount = points.size();
+        }
+    }
+
+    return Test::result();
+}
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CpuFeatures.h"
+#include "Core/CurveBatch.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/Tests/Check.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* The uniform, centripetal and chordal specializations of the Catmull-Rom conversion against the
+ * generic pow path and a double precision reference, and the powLengths kernels against std::pow */
+namespace {
+using Core::CatmullRomParameterization;
+using Core::Point3;
+using Core::SimdLevel;
+
+using PowKernel = void (*)(const float*, size_t, float, float*);
+
+PowKernel powKernel(SimdLevel level) {
+    switch(level) {
+        case SimdLevel::SSE: return Core::Kernels::powLengthsSSE;
+        case SimdLevel::AVX2: return Core::Kernels::powLengthsAVX2;
+        case SimdLevel::AVX512: return Core::Kernels::powLengthsAVX512;
+        default: return Core::Kernels::powLengthsScalar;
+    }
+}
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 100.0f;
+
+/* The control points divide by sums of segment powers, allow a few more rounding errors than the
+ * coordinate range alone would give */
+bool nearlyEqual(const std::vector<Point3>& a, const std::vector<Point3>& b) {
+    const float tolerance = 1.0e-5f * CoordinateRange;
+    if(a.size() != b.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < a.size(); ++i) {
+        if(std::abs(a[i].x - b[i].x) > tolerance || std::abs(a[i].y - b[i].y) > tolerance ||
+           std::abs(a[i].z - b[i].z) > tolerance) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Textbook conversion of the window P[0..3], with pow() for every distance and double arithmetic */
+void referenceCubic(const Point3* P, double alpha, Point3* B) {
+    double p[4][3];
+    for(size_t k = 0; k < 4; ++k) {
+        p[k][0] = P[k].x;
+        p[k][1] = P[k].y;
+        p[k][2] = P[k].z;
+    }
+    double d[3];
+    for(size_t s = 0; s < 3; ++s) {
+        double lengthSqr = 0;
+        for(size_t axis = 0; axis < 3; ++axis) {
+            lengthSqr += (p[s + 1][axis] - p[s][axis]) * (p[s + 1][axis] - p[s][axis]);
+        }
+        d[s] = std::pow(std::sqrt(lengthSqr), alpha);
+    }
+    double b1[3], b2[3];
+    for(size_t axis = 0; axis < 3; ++axis) {
+        b1[axis] = (d[0] * d[0] * p[2][axis] - d[1] * d[1] * p[0][axis] +
+                    (2.0 * d[0] * d[0] + 3.0 * d[0] * d[1] + d[1] * d[1]) * p[1][axis]) /
+                   (3.0 * d[0] * (d[0] + d[1]));
+        b2[axis] = (d[2] * d[2] * p[1][axis] - d[1] * d[1] * p[3][axis] +
+                    (2.0 * d[2] * d[2] + 3.0 * d[2] * d[1] + d[1] * d[1]) * p[2][axis]) /
+                   (3.0 * d[2] * (d[2] + d[1]));
+    }
+    B[0] = P[1];
+    B[1] = Point3{ static_cast<float>(b1[0]), static_cast<float>(b1[1]), static_cast<float>(b1[2]) };
+    B[2] = Point3{ static_cast<float>(b2[0]), static_cast<float>(b2[1]), static_cast<float>(b2[2]) };
+    B[3] = P[2];
+}
+
+std::vector<Point3> reference(const std::vector<Point3>& points, double alpha) {
+    const auto          nCurves = Core::catmullRomCurveCount(points.size());
+    std::vector<Point3> cubics(nCurves * 4);
+    for(size_t idx = 0; idx < nCurves; ++idx) {
+        referenceCubic(&points[idx], alpha, &cubics[idx * 4]);
+    }
+    return cubics;
+}
+
+template<CatmullRomParameterization parameterization>
+std::vector<Point3> convert(const std::vector<Point3>& points, float alpha) {
+    std::vector<Point3> cubics(Core::catmullRomCurveCount(points.size()) * 4);
+    CHECK(Core::catmullRomToCubics<parameterization>(points.data(), points.size(), alpha, cubics.data()) ==
+          Core::catmullRomCurveCount(points.size()));
+    return cubics;
+}
+
+std::vector<Point3> convert(const std::vector<Point3>& points, float alpha) {
+    std::vector<Point3> cubics(Core::catmullRomCurveCount(points.size()) * 4);
+    CHECK(Core::catmullRomToCubics(points.data(), points.size(), alpha, cubics.data()) ==
+          Core::catmullRomCurveCount(points.size()));
+    return cubics;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    const auto detected = Core::detectSimdLevel();
+
+    std::mt19937                          rng(3);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+
+    /* Too few points give no curve */
+    for(size_t nPoints = 0; nPoints < 4; ++nPoints) {
+        std::vector<Point3> points(nPoints);
+        CHECK(Core::catmullRomToCubics(points.data(), nPoints, 0.5f, nullptr) == 0);
+    }
+
+    /* Point counts around the conversion blocks of 256 curves and the tasks of 4096 curves */
+    for(const size_t nPoints : { 4, 5, 19, 258, 259, 260, 1000, 4096 + 3, 4096 + 4, 3 * 4096 + 100 }) {
+        std::vector<Point3> points(nPoints);
+        for(auto& p : points) {
+            p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        }
+
+        for(const auto level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+            if(level > detected) {
+                continue;
+            }
+            Core::setSimdLevel(level);
+
+            /* Specializations, directly and through the alpha dispatch */
+            const auto uniform     = reference(points, 0.0);
+            const auto centripetal = reference(points, 0.5);
+            const auto chordal     = reference(points, 1.0);
+            CHECK(nearlyEqual(convert<CatmullRomParameterization::Uniform>(points, 0.0f), uniform));
+            CHECK(nearlyEqual(convert<CatmullRomParameterization::Centripetal>(points, 0.5f), centripetal));
+            CHECK(nearlyEqual(convert<CatmullRomParameterization::Chordal>(points, 1.0f), chordal));
+            CHECK(nearlyEqual(convert(points, 0.0f), uniform));
+            CHECK(nearlyEqual(convert(points, 0.5f), centripetal));
+            CHECK(nearlyEqual(convert(points, 1.0f), chordal));
+
+            /* The generic pow path agrees with the specializations */
+            CHECK(nearlyEqual(convert<CatmullRomParameterization::Generic>(points, 0.5f),
+                              convert<CatmullRomParameterization::Centripetal>(points, 0.5f)));
+            CHECK(nearlyEqual(convert<CatmullRomParameterization::Generic>(points, 1.0f),
+                              convert<CatmullRomParameterization::Chordal>(points, 1.0f)));
+            CHECK(nearlyEqual(convert(points, 0.25f), reference(points, 0.25)));
+            CHECK(nearlyEqual(convert(points, 0.75f), reference(points, 0.75)));
+        }
+        Core::setSimdLevel(detected);
+    }
+
+    /* powLengths kernels, including zero lengths and the remainders of every SIMD width */
+    std::uniform_real_distribution<float> lengthSqr(1.0e-6f, 1.0e6f);
+    for(const size_t n : { 1, 3, 5, 9, 17, 33, 100 }) {
+        std::vector<float> lengthsSqr(n), powers(n);
+        for(auto& x : lengthsSqr) {
+            x = lengthSqr(rng);
+        }
+        lengthsSqr[n / 2] = 0.0f;
+        for(const auto level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+            if(level > detected) {
+                continue;
+            }
+            for(const float alpha : { 0.25f, 0.5f, 1.0f, 1.5f }) {
+                powKernel(level)(lengthsSqr.data(), n, alpha, powers.data());
+                for(size_t i = 0; i < n; ++i) {
+                    const double expected = std::pow(static_cast<double>(lengthsSqr[i]), 0.5 * alpha);
+                    CHECK(std::abs(powers[i] - expected) <= 1.0e-6 * expected);
+                }
+            }
+        }
+    }
+
+    return Test::result();
+}
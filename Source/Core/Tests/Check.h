@@ -0,0 +1,55 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/****************************************************************************************************/
+/* Checks of the core library tests, one executable per test source run by CTest. A failed check is
+ * reported and the test goes on, main() returns Test::result() */
+namespace Test {
+inline std::atomic<int>& failureCount() {
+    static std::atomic<int> s_nFailures { 0 };
+    return s_nFailures;
+}
+
+inline bool check(bool bCondition, const char* expression, const char* file, int line) {
+    if(!bCondition) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        ++failureCount();
+    }
+    return bCondition;
+}
+
+inline int result() {
+    if(failureCount() > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failureCount().load());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Path of a scratch file in the working directory of the test */
+inline std::string scratchPath(const std::string& name) {
+    return "QATest_" + name;
+}
+} // namespace Test
+
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
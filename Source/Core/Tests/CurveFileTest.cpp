@@ -0,0 +1,173 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveFile.h"
+#include "Core/Tests/Check.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::CurveFileWriter and Core::MappedCurveFile round trips, and rejection of damaged files */
+namespace {
+using Core::Point3;
+
+/* Write points in several appends of the given sizes */
+bool writeFile(const std::string& path, Core::CurveFileTopology topology, Core::CurveFilePrecision precision,
+               const std::vector<Point3>& points, const std::vector<size_t>& appendSizes) {
+    Core::CurveFileWriter writer;
+    bool                  bWritten = writer.open(path, topology, precision, 0.25f);
+    size_t                first    = 0;
+    for(const auto count : appendSizes) {
+        bWritten = bWritten && writer.append(points.data() + first, count);
+        first   += count;
+    }
+    return writer.close() && bWritten && first == points.size();
+}
+
+void checkRoundTrip(Core::CurveFileTopology topology, Core::CurveFilePrecision precision,
+                    const std::vector<Point3>& points, const std::vector<size_t>& appendSizes) {
+    const auto path = Test::scratchPath("curves.qac");
+    CHECK(writeFile(path, topology, precision, points, appendSizes));
+    CHECK(Core::isCurveFile(path));
+
+    Core::MappedCurveFile file;
+    if(!CHECK(file.open(path))) {
+        std::fprintf(stderr, "%s\n", file.error().c_str());
+        return;
+    }
+    const auto& header = file.header();
+    CHECK(header.version == Core::CurveFileVersion);
+    CHECK(header.topology == topology);
+    CHECK(header.precision == precision);
+    CHECK(header.catmullRomAlpha == 0.25f);
+    CHECK(header.dataOffset % Core::CurveFileAlignment == 0);
+    CHECK(file.pointCount() == points.size());
+
+    /* Float32 files are mapped as Point3, Float64 files hold the exact float values */
+    if(precision == Core::CurveFilePrecision::Float32) {
+        CHECK(file.pointsDouble() == nullptr);
+        CHECK(points.empty() || std::memcmp(file.points(), points.data(), points.size() * sizeof(Point3)) == 0);
+    } else {
+        CHECK(file.points() == nullptr);
+        size_t nWrong = 0;
+        for(size_t idx = 0; idx < points.size(); ++idx) {
+            const auto* xyz = file.pointsDouble() + 3 * idx;
+            nWrong += (xyz[0] == double(points[idx].x) && xyz[1] == double(points[idx].y) &&
+                       xyz[2] == double(points[idx].z)) ? 0 : 1;
+        }
+        CHECK(nWrong == 0);
+    }
+
+    /* Copies of sub-ranges */
+    if(points.size() > 10) {
+        std::vector<Point3> copy(points.size() - 10);
+        file.copyPoints(7, copy.size(), copy.data());
+        CHECK(std::memcmp(copy.data(), points.data() + 7, copy.size() * sizeof(Point3)) == 0);
+    }
+    file.close();
+    std::remove(path.c_str());
+}
+
+/* Overwrite size bytes at offset of a valid file and check that it no longer opens */
+void checkRejected(size_t offset, const void* bytes, size_t size, size_t truncatedSize = 0) {
+    const auto          path = Test::scratchPath("damaged.qac");
+    std::vector<Point3> points(100, Point3{ 1.0f, 2.0f, 3.0f });
+    CHECK(writeFile(path, Core::CurveFileTopology::CubicBezier, Core::CurveFilePrecision::Float32, points,
+                    { points.size() }));
+
+    std::vector<unsigned char> data(Core::CurveFileAlignment + points.size() * sizeof(Point3));
+    FILE*                      file = std::fopen(path.c_str(), "rb");
+    CHECK(file && std::fread(data.data(), 1, data.size(), file) == data.size());
+    if(file) {
+        std::fclose(file);
+    }
+    std::memcpy(data.data() + offset, bytes, size);
+    if(truncatedSize > 0) {
+        data.resize(truncatedSize);
+    }
+    file = std::fopen(path.c_str(), "wb");
+    CHECK(file && std::fwrite(data.data(), 1, data.size(), file) == data.size());
+    if(file) {
+        std::fclose(file);
+    }
+
+    Core::MappedCurveFile mapped;
+    CHECK(!mapped.open(path));
+    CHECK(!mapped.error().empty());
+    std::remove(path.c_str());
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937                          rng(13);
+    std::uniform_real_distribution<float> coordinate(-1.0e4f, 1.0e4f);
+    std::vector<Point3>                   points(10000);
+    for(auto& p : points) {
+        p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+    }
+
+    for(const auto precision : { Core::CurveFilePrecision::Float32, Core::CurveFilePrecision::Float64 }) {
+        /* Float64 appends larger than the conversion batch of the writer */
+        checkRoundTrip(Core::CurveFileTopology::CubicBezier, precision, points, { 0, 1, 4999, 5000 });
+        checkRoundTrip(Core::CurveFileTopology::QuadraticPair, precision, points, { points.size() });
+        checkRoundTrip(Core::CurveFileTopology::CatmullRom, precision, {}, {});
+    }
+
+    /* Damaged headers and data */
+    const char     magic[8]   = { 'N', 'O', 'T', 'C', 'U', 'R', 'V', 'E' };
+    const uint32_t version    = Core::CurveFileVersion + 1;
+    const uint32_t topology   = 7;
+    const uint32_t precision  = 2;
+    const uint64_t pointCount = 101;
+    const uint64_t dataOffset = 32;
+    checkRejected(offsetof(Core::CurveFileHeader, magic), magic, sizeof(magic));
+    checkRejected(offsetof(Core::CurveFileHeader, version), &version, sizeof(version));
+    checkRejected(offsetof(Core::CurveFileHeader, topology), &topology, sizeof(topology));
+    checkRejected(offsetof(Core::CurveFileHeader, precision), &precision, sizeof(precision));
+    checkRejected(offsetof(Core::CurveFileHeader, pointCount), &pointCount, sizeof(pointCount));
+    checkRejected(offsetof(Core::CurveFileHeader, dataOffset), &dataOffset, sizeof(dataOffset));
+    checkRejected(0, magic, 0, Core::CurveFileAlignment + 99 * sizeof(Point3));
+    checkRejected(0, magic, 0, 40);
+
+    /* Files of another format */
+    const auto path = Test::scratchPath("points.txt");
+    FILE*      file = std::fopen(path.c_str(), "wb");
+    CHECK(file && std::fputs("1 2 3\n4 5 6\n7 8 9\n1 2 3\n4 5 6\n7 8 9\n1 2 3\n4 5 6\n7 8 9\n1 2 3\n", file) >= 0);
+    if(file) {
+        std::fclose(file);
+    }
+    CHECK(!Core::isCurveFile(path));
+    Core::MappedCurveFile mapped;
+    CHECK(!mapped.open(path));
+    std::remove(path.c_str());
+    CHECK(!Core::isCurveFile(Test::scratchPath("missing.qac")));
+    CHECK(!mapped.open(Test::scratchPath("missing.qac")));
+
+    /* Writers failing to open report it on every later call */
+    Core::CurveFileWriter writer;
+    CHECK(!writer.open(Test::scratchPath("missing/curves.qac"), Core::CurveFileTopology::CubicBezier));
+    CHECK(!writer.error().empty());
+    const Point3 point { 1.0f, 2.0f, 3.0f };
+    CHECK(!writer.append(&point, 1));
+    CHECK(!writer.close());
+
+    return Test::result();
+}
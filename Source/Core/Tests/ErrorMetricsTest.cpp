@@ -0,0 +1,160 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CpuFeatures.h"
+#include "Core/CurveBatch.h"
+#include "Core/ErrorMetrics.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Error metrics against brute-force dense sampling: the L2 error on the [0, gamma], [gamma, 1]
+ * parameterization of the pairs, and the exact and sampled Hausdorff distances against each other and
+ * against the distance between dense point sets of both curves */
+namespace {
+using Core::HausdorffMethod;
+using Core::Point3;
+using Core::SimdLevel;
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 10.0f;
+
+/* Samples of each curve in the brute-force references */
+constexpr int DenseSamples = 2048;
+
+double bruteForceL2(const Point3* B, const Point3* Q, float gamma) {
+    double sum = 0;
+    for(int i = 0; i < DenseSamples; ++i) {
+        const auto t        = (static_cast<float>(i) + 0.5f) / static_cast<float>(DenseSamples);
+        const auto distance = length(Core::evaluateCubic(B, t) - Core::evaluateQuadraticPair(Q, gamma, t));
+        sum += static_cast<double>(distance) * static_cast<double>(distance);
+    }
+    return std::sqrt(sum / DenseSamples);
+}
+
+/* Maximum distance at corresponding parameters */
+float parametricDistance(const Point3* B, const Point3* Q, float gamma) {
+    float result = 0;
+    for(int i = 0; i <= DenseSamples; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(DenseSamples);
+        result = std::max(result, length(Core::evaluateCubic(B, t) - Core::evaluateQuadraticPair(Q, gamma, t)));
+    }
+    return result;
+}
+
+/* Farthest distance from the samples of a to the point set b */
+float farthestDistance(const std::vector<Point3>& a, const std::vector<Point3>& b) {
+    float result = 0;
+    for(const auto& p : a) {
+        float minDistSqr = lengthSquared(p - b[0]);
+        for(const auto& q : b) {
+            minDistSqr = std::min(minDistSqr, lengthSquared(p - q));
+        }
+        result = std::max(result, minDistSqr);
+    }
+    return std::sqrt(result);
+}
+
+float bruteForceHausdorff(const Point3* B, const Point3* Q) {
+    std::vector<Point3> cubic(DenseSamples + 1), quadratic(DenseSamples + 1);
+    for(int i = 0; i <= DenseSamples; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(DenseSamples);
+        cubic[i]     = Core::evaluateCubic(B, t);
+        quadratic[i] = Core::evaluateQuadraticPair(Q, t);
+    }
+    return std::max(farthestDistance(cubic, quadratic), farthestDistance(quadratic, cubic));
+}
+
+/* Largest spacing of dense samples along the curves, bounding the error of the brute-force distance */
+float sampleSpacing(const Point3* B) {
+    float speed = 0;
+    for(int k = 0; k < 3; ++k) {
+        speed = std::max(speed, 3.0f * length(B[k + 1] - B[k]));
+    }
+    return 2.0f * speed / static_cast<float>(DenseSamples);
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    const auto detected = Core::detectSimdLevel();
+
+    std::mt19937                          rng(8);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+
+    for(const float gamma : { 0.5f, 0.3f, 0.7f }) {
+        /* Not a multiple of the SIMD widths, for the remainder loops */
+        const size_t        nCurves = 37;
+        std::vector<Point3> cubics(nCurves * 4), quadratics(nCurves * 5);
+        for(auto& p : cubics) {
+            p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        }
+        Core::convertCubicsToQuadratics(cubics.data(), nCurves, gamma, quadratics.data());
+
+        std::vector<double> expectedL2(nCurves);
+        for(size_t idx = 0; idx < nCurves; ++idx) {
+            expectedL2[idx] = bruteForceL2(&cubics[idx * 4], &quadratics[idx * 5], gamma);
+        }
+        for(const auto level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+            if(level > detected) {
+                continue;
+            }
+            Core::setSimdLevel(level);
+            std::vector<float> errors(nCurves);
+            Core::l2Errors(cubics.data(), quadratics.data(), nCurves, errors.data());
+            for(size_t idx = 0; idx < nCurves; ++idx) {
+                CHECK(std::abs(errors[idx] - expectedL2[idx]) <= 1.0e-3 * expectedL2[idx] + 1.0e-5);
+            }
+        }
+        Core::setSimdLevel(detected);
+
+        /* Hausdorff distances of the first curves, the exact one is slow */
+        for(size_t idx = 0; idx < 12; ++idx) {
+            const auto* B         = &cubics[idx * 4];
+            const auto* Q         = &quadratics[idx * 5];
+            const auto  exact     = Core::hausdorffDistance(B, Q, HausdorffMethod::Exact);
+            const auto  sampled   = Core::hausdorffDistance(B, Q, HausdorffMethod::Sampled);
+            const auto  reference = bruteForceHausdorff(B, Q);
+
+            /* The Hausdorff distance never exceeds the distance at corresponding parameters */
+            CHECK(exact <= parametricDistance(B, Q, gamma) + 1.0e-5f * CoordinateRange);
+            CHECK(std::abs(exact - reference) <= sampleSpacing(B) + 1.0e-5f * CoordinateRange);
+
+            /* 32 segments per curve: chord deviations of a few percent of the distance */
+            CHECK(std::abs(sampled - exact) <= 0.05f * exact + 1.0e-3f * CoordinateRange);
+        }
+    }
+
+    /* An elevated quadratic is reproduced exactly by its pairs */
+    const Point3 P[3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 0.0f }, { 3.0f, 0.0f, 1.0f } };
+    const Point3 B[4] = { P[0], (1.0f / 3.0f) * P[0] + (2.0f / 3.0f) * P[1],
+                          (2.0f / 3.0f) * P[1] + (1.0f / 3.0f) * P[2], P[2] };
+    for(const float gamma : { 0.2f, 0.5f, 0.9f }) {
+        Point3 Q[5];
+        Core::convertCubicToQuadratics(B, gamma, Q);
+        CHECK(Core::l2Error(B, Q) <= 1.0e-5f);
+        CHECK(Core::hausdorffDistance(B, Q, HausdorffMethod::Exact) <= 1.0e-5f);
+        /* Samples of the cubic and of the pair differ for gamma != 0.5, up to the chord deviation of
+         * the polylines */
+        CHECK(Core::hausdorffDistance(B, Q, HausdorffMethod::Sampled) <= 1.0e-2f);
+    }
+
+    return Test::result();
+}
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/GammaSolver.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* The optimal gammas against a brute-force sampling of gamma, with both objectives measured
+ * independently of the solver by dense sampling of the cubic parameter */
+namespace {
+using Core::GammaObjective;
+using Core::Point3;
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 100.0f;
+
+/* Gamma samples of the brute-force search, and cubic parameter samples of the objectives */
+constexpr int GammaSamples = 1000;
+constexpr int CurveSamples = 1024;
+
+/* Mean squared or maximum distance between the cubic at t and its quadratic pair at the same point
+ * of the pair parameterization, over uniform samples of t */
+double objective(const Point3* B, float gamma, GammaObjective objective) {
+    Point3 Q[5];
+    Core::convertCubicToQuadratics(B, gamma, Q);
+    double error = 0;
+    for(int i = 0; i <= CurveSamples; ++i) {
+        const auto t        = static_cast<float>(i) / static_cast<float>(CurveSamples);
+        const auto distance = static_cast<double>(length(Core::evaluateCubic(B, t) -
+                                                         Core::evaluateQuadraticPair(Q, gamma, t)));
+        error = objective == GammaObjective::L2 ? error + distance * distance / (CurveSamples + 1) :
+                std::max(error, distance);
+    }
+    return error;
+}
+
+double bruteForceMinimum(const Point3* B, GammaObjective gammaObjective) {
+    double minError = objective(B, 0.0f, gammaObjective);
+    for(int i = 1; i <= GammaSamples; ++i) {
+        minError = std::min(minError, objective(B, static_cast<float>(i) / GammaSamples, gammaObjective));
+    }
+    return minError;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937                          rng(6);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+
+    const size_t        nCurves = 50;
+    std::vector<Point3> cubics(nCurves * 4);
+    for(auto& p : cubics) {
+        p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+    }
+
+    for(const auto gammaObjective : { GammaObjective::L2, GammaObjective::MaxDistance }) {
+        std::vector<float> gammas(nCurves);
+        Core::optimalGammas(cubics.data(), nCurves, gammaObjective, gammas.data());
+        for(size_t idx = 0; idx < nCurves; ++idx) {
+            const auto* B     = &cubics[idx * 4];
+            const auto  gamma = Core::optimalGamma(B, gammaObjective);
+            CHECK(gammas[idx] == gamma);
+            CHECK(gamma >= 0.0f && gamma <= 1.0f);
+
+            /* No sampled gamma does noticeably better than the solver */
+            CHECK(objective(B, gamma, gammaObjective) <= 1.001 * bruteForceMinimum(B, gammaObjective));
+        }
+    }
+
+    /* A cubic that is an elevated quadratic is reproduced exactly by every gamma */
+    const Point3 P[3] = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 2.0f, 0.0f }, { 3.0f, 0.0f, 1.0f } };
+    const Point3 B[4] = { P[0], (1.0f / 3.0f) * P[0] + (2.0f / 3.0f) * P[1],
+                          (2.0f / 3.0f) * P[1] + (1.0f / 3.0f) * P[2], P[2] };
+    for(const float gamma : { 0.1f, 0.5f, 0.9f }) {
+        CHECK(objective(B, gamma, GammaObjective::MaxDistance) <= 1.0e-5);
+    }
+
+    return Test::result();
+}
@@ -0,0 +1,208 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/ImageFile.h"
+#include "Core/Tests/Check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::writeImage() round trips: the files are decoded here, independently of the writer */
+namespace {
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+uint32_t readBigEndian(const uint8_t* data) {
+    return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+}
+
+/* Bitwise CRC-32 of PNG chunks */
+uint32_t crc32(const uint8_t* data, size_t size) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for(size_t i = 0; i < size; ++i) {
+        crc ^= data[i];
+        for(int k = 0; k < 8; ++k) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+/* Decode a PPM (P6) into top-down RGB rows, false if malformed */
+bool decodePpm(const std::vector<uint8_t>& file, size_t& width, size_t& height, std::vector<uint8_t>& rgb) {
+    std::istringstream stream(std::string(file.begin(), file.end()));
+    std::string        magic;
+    int                maxValue;
+    if(!(stream >> magic >> width >> height >> maxValue) || magic != "P6" || maxValue != 255 || stream.get() != '\n') {
+        return false;
+    }
+    const auto offset = static_cast<size_t>(stream.tellg());
+    if(file.size() != offset + width * height * 3) {
+        return false;
+    }
+    rgb.assign(file.begin() + static_cast<std::ptrdiff_t>(offset), file.end());
+    return true;
+}
+
+/* Decode a PNG with uncompressed (stored) deflate blocks and unfiltered 8-bit RGB scanlines, as written
+ * by Core::writeImage(), checking every CRC and the Adler-32 of the zlib stream */
+bool decodePng(const std::vector<uint8_t>& file, size_t& width, size_t& height, std::vector<uint8_t>& rgb) {
+    const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if(file.size() < 8 || !std::equal(signature, signature + 8, file.begin())) {
+        return false;
+    }
+    std::vector<uint8_t> zlib;
+    bool                 bHeader = false, bEnd = false;
+    for(size_t pos = 8; pos < file.size();) {
+        if(pos + 12 > file.size()) {
+            return false;
+        }
+        const auto length = readBigEndian(&file[pos]);
+        if(pos + 12 + length > file.size() ||
+           crc32(&file[pos + 4], length + 4) != readBigEndian(&file[pos + 8 + length])) {
+            return false;
+        }
+        const std::string type(file.begin() + static_cast<std::ptrdiff_t>(pos + 4),
+                               file.begin() + static_cast<std::ptrdiff_t>(pos + 8));
+        const uint8_t*    data = &file[pos + 8];
+        if(type == "IHDR") {
+            if(length != 13 || data[8] != 8 || data[9] != 2 || data[10] != 0 || data[11] != 0 || data[12] != 0) {
+                return false;
+            }
+            width   = readBigEndian(data);
+            height  = readBigEndian(data + 4);
+            bHeader = true;
+        } else if(type == "IDAT") {
+            zlib.insert(zlib.end(), data, data + length);
+        } else if(type == "IEND") {
+            bEnd = true;
+        }
+        pos += 12 + length;
+    }
+    if(!bHeader || !bEnd || zlib.size() < 6 || (zlib[0] & 0x0F) != 8 || ((zlib[0] << 8) | zlib[1]) % 31 != 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> scanlines;
+    size_t               pos = 2;
+    for(bool bFinal = false; !bFinal;) {
+        if(pos + 5 > zlib.size() || (zlib[pos] & 0x06) != 0) {
+            return false; /* only stored blocks */
+        }
+        bFinal = (zlib[pos] & 1) != 0;
+        const size_t length  = zlib[pos + 1] | (zlib[pos + 2] << 8);
+        const size_t nlength = zlib[pos + 3] | (zlib[pos + 4] << 8);
+        if((length ^ 0xFFFF) != nlength || pos + 5 + length > zlib.size()) {
+            return false;
+        }
+        scanlines.insert(scanlines.end(), zlib.begin() + static_cast<std::ptrdiff_t>(pos + 5),
+                         zlib.begin() + static_cast<std::ptrdiff_t>(pos + 5 + length));
+        pos += 5 + length;
+    }
+    uint32_t a = 1, b = 0;
+    for(const auto byte : scanlines) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    if(pos + 4 != zlib.size() || readBigEndian(&zlib[pos]) != ((b << 16) | a) ||
+       scanlines.size() != height * (width * 3 + 1)) {
+        return false;
+    }
+
+    rgb.clear();
+    for(size_t y = 0; y < height; ++y) {
+        const auto row = scanlines.begin() + static_cast<std::ptrdiff_t>(y * (width * 3 + 1));
+        if(*row != 0) {
+            return false;
+        }
+        rgb.insert(rgb.end(), row + 1, row + 1 + static_cast<std::ptrdiff_t>(width * 3));
+    }
+    return true;
+}
+
+/* Write pixels, decode the file and compare with the expected top-down RGB rows */
+void checkRoundTrip(Core::ImageFormat format, const std::vector<uint8_t>& pixels, size_t width, size_t height,
+                    size_t nChannels, bool bBottomUp) {
+    std::vector<uint8_t> expected;
+    for(size_t y = 0; y < height; ++y) {
+        const auto row = bBottomUp ? height - 1 - y : y;
+        for(size_t x = 0; x < width; ++x) {
+            const auto pixel = &pixels[(row * width + x) * nChannels];
+            expected.insert(expected.end(), pixel, pixel + 3);
+        }
+    }
+
+    const auto  path = Test::scratchPath(format == Core::ImageFormat::Png ? "image.png" : "image.ppm");
+    std::string error;
+    if(!CHECK(Core::writeImage(path, format, pixels.data(), width, height, nChannels, bBottomUp, error))) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return;
+    }
+    size_t               decodedWidth = 0, decodedHeight = 0;
+    std::vector<uint8_t> rgb;
+    const auto           file     = readFile(path);
+    const auto           bDecoded = format == Core::ImageFormat::Png ?
+                                    decodePng(file, decodedWidth, decodedHeight, rgb) :
+                                    decodePpm(file, decodedWidth, decodedHeight, rgb);
+    CHECK(bDecoded);
+    CHECK(decodedWidth == width);
+    CHECK(decodedHeight == height);
+    CHECK(rgb == expected);
+    std::remove(path.c_str());
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    Core::ImageFormat format = Core::ImageFormat::Ppm;
+    CHECK(Core::imageFormatFromPath("frame.PNG", format) && format == Core::ImageFormat::Png);
+    CHECK(Core::imageFormatFromPath("dir.v2/frame.ppm", format) && format == Core::ImageFormat::Ppm);
+    CHECK(!Core::imageFormatFromPath("frame.jpg", format));
+    CHECK(!Core::imageFormatFromPath("frame", format));
+
+    /* Small images, and one whose scanlines span several stored deflate blocks */
+    std::mt19937 rng(3);
+    for(const auto& [width, height] : { std::pair<size_t, size_t>{ 1, 1 }, { 3, 2 }, { 257, 301 } }) {
+        for(const size_t nChannels : { 3, 4 }) {
+            std::vector<uint8_t> pixels(width * height * nChannels);
+            for(auto& byte : pixels) {
+                byte = static_cast<uint8_t>(rng());
+            }
+            for(const auto bBottomUp : { false, true }) {
+                checkRoundTrip(Core::ImageFormat::Png, pixels, width, height, nChannels, bBottomUp);
+                checkRoundTrip(Core::ImageFormat::Ppm, pixels, width, height, nChannels, bBottomUp);
+            }
+        }
+    }
+
+    /* Invalid images are rejected with an error */
+    std::string   error;
+    const uint8_t pixel[4] = {};
+    CHECK(!Core::writeImage(Test::scratchPath("invalid.png"), Core::ImageFormat::Png, pixel, 1, 1, 2, false, error));
+    CHECK(!error.empty());
+    error.clear();
+    CHECK(!Core::writeImage(Test::scratchPath("invalid.png"), Core::ImageFormat::Png, pixel, 0, 1, 3, false, error));
+    CHECK(!error.empty());
+
+    return Test::result();
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/ObjectPool.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::ObjectPool against a list of the live objects */
+namespace {
+struct Counted {
+    explicit Counted(int value_) : value(value_) { ++s_nLive; }
+    ~Counted() { --s_nLive; }
+    Counted(const Counted&) = delete;
+    Counted& operator=(const Counted&) = delete;
+
+    static inline int s_nLive { 0 };
+    int               value;
+    double            padding[3] {};
+};
+
+constexpr size_t BlockSize = 8;
+}
+
+/****************************************************************************************************/
+int main() {
+    {
+        Core::ObjectPool<Counted, BlockSize> pool;
+        CHECK(pool.size() == 0);
+        CHECK(pool.capacity() == 0);
+
+        /* Objects are allocated in blocks and keep their address */
+        std::vector<Counted*> objects;
+        for(int idx = 0; idx < 20; ++idx) {
+            objects.push_back(pool.create(idx));
+        }
+        CHECK(pool.size() == 20);
+        CHECK(Counted::s_nLive == 20);
+        CHECK(pool.capacity() == 24);
+        CHECK(pool.allocatedBytes() >= pool.capacity() * sizeof(Counted));
+        for(int idx = 0; idx < 20; ++idx) {
+            CHECK(objects[static_cast<size_t>(idx)]->value == idx);
+        }
+        auto sorted = objects;
+        std::sort(sorted.begin(), sorted.end());
+        CHECK(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+
+        /* Destroyed slots are reused last in first out, without new blocks */
+        pool.destroy(objects[3]);
+        pool.destroy(objects[11]);
+        CHECK(pool.size() == 18);
+        CHECK(Counted::s_nLive == 18);
+        CHECK(pool.create(100) == objects[11]);
+        CHECK(pool.create(101) == objects[3]);
+        CHECK(pool.capacity() == 24);
+
+        /* clear() destroys all objects and keeps the blocks */
+        pool.clear();
+        CHECK(pool.size() == 0);
+        CHECK(Counted::s_nLive == 0);
+        CHECK(pool.capacity() == 24);
+        for(int idx = 0; idx < 24; ++idx) {
+            pool.create(idx);
+        }
+        CHECK(pool.capacity() == 24);
+
+        pool.reserve(100);
+        CHECK(pool.capacity() >= 100);
+        CHECK(pool.capacity() % BlockSize == 0);
+        CHECK(pool.size() == 24);
+    }
+    /* The pool destroys its remaining objects */
+    CHECK(Counted::s_nLive == 0);
+
+    /* Random creations and destructions */
+    {
+        Core::ObjectPool<Counted, BlockSize>  pool;
+        std::vector<std::pair<Counted*, int>> live;
+        std::set<Counted*>                    addresses;
+        std::mt19937                          rng(7);
+        size_t                                maxLive = 0;
+        for(int step = 0; step < 100000; ++step) {
+            if(live.empty() || rng() % 3 != 0) {
+                const auto object = pool.create(step);
+                CHECK(addresses.insert(object).second);
+                live.emplace_back(object, step);
+            } else {
+                const auto k = rng() % live.size();
+                pool.destroy(live[k].first);
+                addresses.erase(live[k].first);
+                live[k] = live.back();
+                live.pop_back();
+            }
+            maxLive = std::max(maxLive, live.size());
+        }
+        CHECK(pool.size() == live.size());
+        CHECK(Counted::s_nLive == static_cast<int>(live.size()));
+        CHECK(pool.capacity() == (maxLive + BlockSize - 1) / BlockSize * BlockSize);
+        size_t nWrong = 0;
+        for(const auto& [object, value] : live) {
+            nWrong += object->value == value ? 0 : 1;
+        }
+        CHECK(nWrong == 0);
+    }
+    CHECK(Counted::s_nLive == 0);
+
+    return Test::result();
+}
@@ -0,0 +1,157 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/PointIO.h"
+#include "Core/Tests/Check.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::parseTextPoints() against the streaming Core::TextPointReader, on inputs of several parsing
+ * chunks (1 MiB each) with lines around the chunk boundaries */
+namespace {
+using Core::Point3;
+
+constexpr size_t ParseChunkSize = 1 << 20;
+
+struct Parsed {
+    std::vector<Point3> points;
+    std::string         error;
+};
+
+Parsed readStream(const std::string& text) {
+    std::istringstream    stream(text);
+    Core::TextPointReader reader(stream);
+    Parsed                parsed;
+    std::vector<Point3>   batch(1000);
+    size_t                n;
+    while((n = reader.read(batch.data(), batch.size())) > 0) {
+        parsed.points.insert(parsed.points.end(), batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+    parsed.error = reader.error();
+    if(reader.failed()) {
+        parsed.points.clear();
+    }
+    return parsed;
+}
+
+bool samePoints(const std::vector<Point3>& a, const std::vector<Point3>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(Point3)) == 0);
+}
+
+void checkParse(const std::string& text) {
+    const auto expected = readStream(text);
+    Parsed     parsed;
+    const auto bParsed = Core::parseTextPoints(text.data(), text.size(), parsed.points, parsed.error);
+    CHECK(bParsed == expected.error.empty());
+    CHECK(parsed.error == expected.error);
+    CHECK(samePoints(parsed.points, expected.points));
+}
+
+/* Random lines of points, comments and empty lines, until the text holds size bytes */
+void appendLines(std::string& text, size_t size, std::mt19937& rng, std::vector<Point3>* points = nullptr) {
+    std::uniform_real_distribution<float> coordinate(-1.0e3f, 1.0e3f);
+    char                                  line[128];
+    while(text.size() < size) {
+        switch(rng() % 8) {
+            case 0:
+                text += "// curve " + std::to_string(rng() % 1000) + "\n";
+                break;
+            case 1:
+                text += (rng() % 2) ? "\n" : " \t\n";
+                break;
+            default: {
+                const Point3 p{ coordinate(rng), coordinate(rng), coordinate(rng) };
+                std::snprintf(line, sizeof(line), (rng() % 2) ? "%.9g %.9g %.9g\n" : "  %+.9g\t%.9g  %.9e\n",
+                              double(p.x), double(p.y), double(p.z));
+                text += line;
+                if(points) {
+                    points->push_back(p);
+                }
+            }
+        }
+    }
+}
+
+/* Comment line padded so that the text ends with a newline at byte newlineOffset */
+void padToNewline(std::string& text, size_t newlineOffset) {
+    text += "//";
+    text.append(newlineOffset - text.size(), 'x');
+    text += '\n';
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937 rng(5);
+
+    /* Round trip of the printed coordinates, over three chunks */
+    {
+        std::string         text;
+        std::vector<Point3> points;
+        appendLines(text, 3 * ParseChunkSize + 12345, rng, &points);
+        std::vector<Point3> parsed;
+        std::string         error;
+        CHECK(Core::parseTextPoints(text.data(), text.size(), parsed, error));
+        CHECK(samePoints(parsed, points));
+        checkParse(text);
+
+        /* Without the last newline */
+        text.pop_back();
+        checkParse(text);
+    }
+
+    /* Line ends right before, at and after the chunk boundary */
+    for(size_t newlineOffset = ParseChunkSize - 3; newlineOffset <= ParseChunkSize + 2; ++newlineOffset) {
+        std::string text;
+        appendLines(text, ParseChunkSize - 200, rng);
+        padToNewline(text, newlineOffset);
+        appendLines(text, ParseChunkSize + 5000, rng);
+        checkParse(text);
+    }
+
+    /* Chunks of comments and empty lines only */
+    {
+        std::string text;
+        appendLines(text, 1000, rng);
+        while(text.size() < 2 * ParseChunkSize + 100) {
+            text += (text.size() % 3) ? "\n" : "// comment\n";
+        }
+        appendLines(text, text.size() + 1000, rng);
+        checkParse(text);
+    }
+
+    /* Malformed lines, reported with their line number as by the reader */
+    for(const auto offset : { size_t(10), ParseChunkSize - 1, ParseChunkSize + 777, 2 * ParseChunkSize + 5 }) {
+        std::string text;
+        appendLines(text, offset, rng);
+        text += "1.0 2.0 abc\n";
+        appendLines(text, offset + ParseChunkSize, rng);
+        text += "1 2\n";
+        checkParse(text);
+    }
+
+    /* Small inputs */
+    for(const char* text : { "", "\n", "// only a comment", "1 2 3", "1 2 3\n4 5 6\n", "\n\n1 2 3", "1 2", "x y z\n" }) {
+        checkParse(text);
+    }
+
+    return Test::result();
+}
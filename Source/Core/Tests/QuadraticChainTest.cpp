@@ -0,0 +1,147 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/QuadraticChain.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::approximateCubicsWithQuadratics(): the chains meet the tolerance, measured by dense sampling of
+ * the parametric distance, and the curves missing it are reported */
+namespace {
+using Core::Point3;
+
+/* Point of the chain at the cubic parameter t. Piece k covers [k / nPairs, (k + 1) / nPairs], and the
+ * quadratics of a pair the parameters before and after gamma of their piece */
+Point3 evaluateChain(const Point3* chain, size_t nPairs, float gamma, float t) {
+    const auto k = std::min(static_cast<size_t>(t * static_cast<float>(nPairs)), nPairs - 1);
+    const auto s = t * static_cast<float>(nPairs) - static_cast<float>(k);
+    return Core::evaluateQuadraticPair(&chain[4 * k], gamma, s);
+}
+
+float sampledError(const Point3* B, const Point3* chain, size_t nPairs, float gamma) {
+    constexpr int nSamples = 2048;
+    float         error    = 0.0f;
+    for(int i = 0; i <= nSamples; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(nSamples);
+        error = std::max(error, length(Core::evaluateCubic(B, t) - evaluateChain(chain, nPairs, gamma, t)));
+    }
+    return error;
+}
+
+float extent(const Point3* B) {
+    float result = 0.0f;
+    for(int k = 0; k < 4; ++k) {
+        result = std::max({ result, std::abs(B[k].x), std::abs(B[k].y), std::abs(B[k].z) });
+    }
+    return result;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937                          rng(9);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    for(const auto gamma : { 0.5f, 0.3f, 0.8f }) {
+        for(const auto tolerance : { 1.0e-1f, 1.0e-2f, 1.0e-3f }) {
+            /* Cubics of several scales, including degenerate ones */
+            std::vector<Point3> cubics;
+            for(int idx = 0; idx < 500; ++idx) {
+                const auto scale = std::pow(10.0f, static_cast<float>(idx % 4) - 1.0f);
+                for(int k = 0; k < 4; ++k) {
+                    cubics.push_back(scale * Point3{ unit(rng), unit(rng), unit(rng) });
+                }
+            }
+            cubics.insert(cubics.end(), 4, Point3{ 1.0f, 2.0f, 3.0f });
+            cubics.insert(cubics.end(), { Point3{ 0.0f, 0.0f, 0.0f }, Point3{ 1.0f, 0.0f, 0.0f },
+                                          Point3{ 2.0f, 0.0f, 0.0f }, Point3{ 3.0f, 0.0f, 0.0f } });
+            const auto nCurves = cubics.size() / 4;
+
+            Core::QuadraticChains chains;
+            const auto            nClamped = Core::approximateCubicsWithQuadratics(cubics.data(), nCurves, tolerance,
+                                                                                   chains, gamma);
+            CHECK(nClamped == 0);
+            CHECK(chains.clampedCurves.empty());
+            CHECK(chains.offsets.size() == nCurves + 1);
+            CHECK(chains.points.size() == chains.offsets[nCurves]);
+
+            size_t nWrong = 0, nAboveTolerance = 0;
+            for(size_t idx = 0; idx < nCurves; ++idx) {
+                const auto* B       = &cubics[idx * 4];
+                const auto* chain   = &chains.points[chains.offsets[idx]];
+                const auto  nPoints = chains.offsets[idx + 1] - chains.offsets[idx];
+                const auto  nPairs  = (nPoints - 1) / 4;
+                bool        bClamped;
+                nWrong += (nPoints % 4 != 1 || Core::quadraticPairCount(B, tolerance, gamma, &bClamped) != nPairs ||
+                           bClamped) ? 1 : 0;
+
+                /* The chain interpolates the end points of the cubic */
+                nWrong += (length(chain[0] - B[0]) != 0.0f || length(chain[nPoints - 1] - B[3]) != 0.0f) ? 1 : 0;
+
+                /* Float rounding of the evaluations grows with the extent of the curve */
+                const auto slack = 1.0e-5f * extent(B);
+                nAboveTolerance += sampledError(B, chain, nPairs, gamma) > tolerance * 1.001f + slack ? 1 : 0;
+            }
+            CHECK(nWrong == 0);
+            CHECK(nAboveTolerance == 0);
+        }
+    }
+
+    /* Curves whose pair count would exceed the limit are clamped and reported in ascending order */
+    {
+        const auto          big = 1.0e12f;
+        std::vector<Point3> cubics;
+        std::vector<size_t> expected;
+        for(size_t idx = 0; idx < 50; ++idx) {
+            const auto bHuge = idx % 7 == 3;
+            const auto scale = bHuge ? big : 1.0f;
+            for(int k = 0; k < 4; ++k) {
+                cubics.push_back(scale * Point3{ unit(rng), unit(rng), unit(rng) });
+            }
+            if(bHuge) {
+                expected.push_back(idx);
+            }
+        }
+        /* Non-finite control points are clamped too */
+        cubics.insert(cubics.end(), { Point3{ 0.0f, 0.0f, 0.0f }, Point3{ 0.0f, 0.0f, 0.0f },
+                                      Point3{ std::numeric_limits<float>::infinity(), 0.0f, 0.0f },
+                                      Point3{ 1.0f, 0.0f, 0.0f } });
+        expected.push_back(50);
+
+        const auto            tolerance = 1.0e-3f;
+        Core::QuadraticChains chains;
+        CHECK(Core::approximateCubicsWithQuadratics(cubics.data(), 51, tolerance, chains) == expected.size());
+        CHECK(chains.clampedCurves == expected);
+        size_t nWrong = 0;
+        for(size_t idx = 0; idx < 51; ++idx) {
+            bool       bClamped;
+            const auto nPairs   = Core::quadraticPairCount(&cubics[idx * 4], tolerance, 0.5f, &bClamped);
+            const auto bListed  = std::binary_search(expected.begin(), expected.end(), idx);
+            nWrong += (bClamped != bListed ||
+                       (bClamped && nPairs != Core::MaxQuadraticPairsPerCubic) ||
+                       chains.offsets[idx + 1] - chains.offsets[idx] != 4 * nPairs + 1) ? 1 : 0;
+        }
+        CHECK(nWrong == 0);
+    }
+
+    return Test::result();
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CpuFeatures.h"
+#include "Core/CurveBatch.h"
+#include "Core/CurveSoA.h"
+#include "Core/SIMD/Kernels.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* The SSE, AVX2 and AVX-512 conversion kernels against the scalar one, for every level supported by
+ * the CPU. Curve counts are not multiples of the SIMD widths nor of the conversion blocks, so that the
+ * remainder loops run too */
+namespace {
+using Core::Point3;
+using Core::SimdLevel;
+
+using ConvertKernel  = void (*)(const Core::CubicSoA&, size_t, float, const Core::QuadraticSoA&);
+using ConvertKernels = void (*)(const Core::CubicSoA&, size_t, const float*, const Core::QuadraticSoA&);
+
+ConvertKernel convertKernel(SimdLevel level) {
+    switch(level) {
+        case SimdLevel::SSE: return Core::Kernels::convertCubicsToQuadraticsSSE;
+        case SimdLevel::AVX2: return Core::Kernels::convertCubicsToQuadraticsAVX2;
+        case SimdLevel::AVX512: return Core::Kernels::convertCubicsToQuadraticsAVX512;
+        default: return Core::Kernels::convertCubicsToQuadraticsScalar;
+    }
+}
+
+ConvertKernels convertKernels(SimdLevel level) {
+    switch(level) {
+        case SimdLevel::SSE: return Core::Kernels::convertCubicsToQuadraticsSSE;
+        case SimdLevel::AVX2: return Core::Kernels::convertCubicsToQuadraticsAVX2;
+        case SimdLevel::AVX512: return Core::Kernels::convertCubicsToQuadraticsAVX512;
+        default: return Core::Kernels::convertCubicsToQuadraticsScalar;
+    }
+}
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 100.0f;
+
+/* Equal up to a few rounding errors at the coordinate range, as the compiler may contract the
+ * products and sums of each path into different fused multiply-adds */
+bool nearlyEqual(float a, float b) {
+    return std::abs(a - b) <= 4.0f * std::numeric_limits<float>::epsilon() * CoordinateRange;
+}
+
+bool nearlyEqual(const std::vector<Point3>& a, const std::vector<Point3>& b) {
+    if(a.size() != b.size()) {
+        return false;
+    }
+    for(size_t i = 0; i < a.size(); ++i) {
+        if(!nearlyEqual(a[i].x, b[i].x) || !nearlyEqual(a[i].y, b[i].y) || !nearlyEqual(a[i].z, b[i].z)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Run a kernel on a SoA copy of the cubics, gammas is either a single gamma or one per curve */
+template<class Kernel, class Gammas>
+std::vector<Point3> convertSoA(Kernel kernel, const std::vector<Point3>& cubics, Gammas gammas) {
+    const auto     nCurves = cubics.size() / 4;
+    Core::CurveSoA cubicSoA(Core::CurveType::CubicBezier, nCurves);
+    Core::CurveSoA quadraticSoA(Core::CurveType::QuadraticPair, nCurves);
+    cubicSoA.fromPoints(cubics.data());
+    kernel(cubicSoA.cubicView(), nCurves, gammas, quadraticSoA.quadraticView());
+    std::vector<Point3> quadratics(nCurves * 5);
+    quadraticSoA.toPoints(quadratics.data());
+    return quadratics;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    const auto detected = Core::detectSimdLevel();
+    std::printf("detected SIMD level: %s\n", Core::simdLevelName(detected));
+
+    std::mt19937                          rng(17);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+    std::uniform_real_distribution<float> gamma(0.05f, 0.95f);
+    for(const size_t nCurves : { 1, 3, 7, 15, 17, 31, 33, 255, 257, 1000, 16384 + 5 }) {
+        std::vector<Point3> cubics(nCurves * 4);
+        std::vector<float>  gammas(nCurves);
+        for(auto& p : cubics) {
+            p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        }
+        for(auto& g : gammas) {
+            g = gamma(rng);
+        }
+
+        /* Reference: the single-curve conversion */
+        std::vector<Point3> expected(nCurves * 5), expectedPerCurve(nCurves * 5);
+        for(size_t idx = 0; idx < nCurves; ++idx) {
+            Core::convertCubicToQuadratics(&cubics[idx * 4], 0.4f, &expected[idx * 5]);
+            Core::convertCubicToQuadratics(&cubics[idx * 4], gammas[idx], &expectedPerCurve[idx * 5]);
+        }
+
+        for(const auto level : { SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+            if(level > detected) {
+                continue;
+            }
+            /* Kernels of each ISA */
+            CHECK(nearlyEqual(convertSoA(convertKernel(level), cubics, 0.4f), expected));
+            CHECK(nearlyEqual(convertSoA(convertKernels(level), cubics, gammas.data()), expectedPerCurve));
+
+            /* Batch entry points, through the blocked transposition and the thread pool */
+            Core::setSimdLevel(level);
+            CHECK(Core::simdLevel() == level);
+            std::vector<Point3> quadratics(nCurves * 5);
+            Core::convertCubicsToQuadratics(cubics.data(), nCurves, 0.4f, quadratics.data());
+            CHECK(nearlyEqual(quadratics, expected));
+            Core::convertCubicsToQuadratics(cubics.data(), nCurves, gammas.data(), quadratics.data());
+            CHECK(nearlyEqual(quadratics, expectedPerCurve));
+        }
+        Core::setSimdLevel(detected);
+    }
+
+    return Test::result();
+}
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/SlotRegistry.h"
+#include "Core/Tests/Check.h"
+
+#include <map>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::SlotRegistry, the ID registry of the pickable objects, against a model of its slots */
+namespace {
+struct Object {
+    int value;
+};
+using Registry = Core::SlotRegistry<Object>;
+}
+
+/****************************************************************************************************/
+int main() {
+    {
+        Registry registry;
+        Object   a{ 1 }, b{ 2 }, c{ 3 };
+
+        /* IDs start at 1, 0 is the background */
+        CHECK(registry.add(&a) == 1);
+        CHECK(registry.add(&b) == 2);
+        CHECK(registry.add(&c) == 3);
+        CHECK(registry.size() == 3);
+        CHECK(registry.get(0u) == nullptr);
+        CHECK(registry.get(4u) == nullptr);
+        CHECK(registry.get(2u) == &b);
+
+        /* Removing an object makes its handle stale, the slots are reused last in first out */
+        const auto handleA = registry.handle(1);
+        const auto handleB = registry.handle(2);
+        CHECK(registry.get(handleA) == &a);
+        CHECK(registry.removalCount() == 0);
+        registry.remove(1);
+        registry.remove(2);
+        CHECK(registry.removalCount() == 2);
+        CHECK(registry.size() == 1);
+        CHECK(registry.get(1u) == nullptr);
+        CHECK(registry.get(handleA) == nullptr);
+        CHECK(registry.get(handleB) == nullptr);
+
+        Object d{ 4 }, e{ 5 };
+        CHECK(registry.add(&d) == 2);
+        CHECK(registry.add(&e) == 1);
+        CHECK(registry.get(2u) == &d);
+
+        /* The old handles still do not resolve to the new objects of their slots */
+        CHECK(registry.get(handleA) == nullptr);
+        CHECK(registry.get(handleB) == nullptr);
+        CHECK(registry.get(registry.handle(2)) == &d);
+        CHECK(registry.handle(2).generation == handleB.generation + 1);
+
+        /* A default handle is the background */
+        CHECK(registry.get(Registry::Handle{}) == nullptr);
+
+        std::vector<Object*> visited;
+        registry.forEach([&](Object* object) { visited.push_back(object); });
+        CHECK((visited == std::vector<Object*>{ &e, &d, &c }));
+    }
+
+    /* Random additions and removals, with handles kept across them */
+    {
+        struct SlotModel {
+            Object*  object { nullptr };
+            uint32_t generation { 0 };
+        };
+        Registry                                          registry;
+        std::vector<SlotModel>                            slots;
+        std::vector<std::pair<Registry::Handle, Object*>> handles;
+        std::vector<Object>                               objects(1000);
+        std::map<uint32_t, Object*>                       live;
+        std::mt19937                                      rng(11);
+        size_t                                            nWrong = 0;
+        for(int step = 0; step < 100000; ++step) {
+            if(live.empty() || rng() % 2 == 0) {
+                const auto object = &objects[rng() % objects.size()];
+                const auto idx    = registry.add(object);
+                nWrong += (idx == 0 || live.count(idx) != 0) ? 1 : 0;
+                if(idx > slots.size()) {
+                    slots.resize(idx);
+                }
+                slots[idx - 1].object = object;
+                live[idx]             = object;
+                handles.emplace_back(registry.handle(idx), object);
+            } else {
+                auto it = live.begin();
+                std::advance(it, static_cast<std::ptrdiff_t>(rng() % live.size()));
+                registry.remove(it->first);
+                slots[it->first - 1].object = nullptr;
+                ++slots[it->first - 1].generation;
+                live.erase(it);
+            }
+            if(handles.size() > 64) {
+                handles.erase(handles.begin());
+            }
+
+            /* A handle resolves if and only if its slot was not freed since it was taken */
+            for(const auto& [handle, object] : handles) {
+                const auto& slot     = slots[handle.idx - 1];
+                const auto  expected = slot.generation == handle.generation ? object : nullptr;
+                nWrong += registry.get(handle) == expected ? 0 : 1;
+            }
+        }
+        CHECK(nWrong == 0);
+        CHECK(registry.size() == live.size());
+        for(uint32_t idx = 0; idx <= slots.size() + 1; ++idx) {
+            const auto it = live.find(idx);
+            nWrong += registry.get(idx) == (it == live.end() ? nullptr : it->second) ? 0 : 1;
+        }
+        CHECK(nWrong == 0);
+    }
+
+    return Test::result();
+}
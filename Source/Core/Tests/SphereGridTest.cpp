@@ -0,0 +1,140 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/SphereGrid.h"
+#include "Core/Tests/Check.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* SphereGrid::raycast() against a brute-force loop over all spheres */
+namespace {
+using Core::Point3;
+
+/* Same intersection as the grid, so that both agree to the bit */
+float intersectSphere(const Point3& origin, const Point3& direction, const Point3& center, float radius) {
+    const auto a  = Core::dot(direction, direction);
+    const auto oc = origin - center;
+    const auto b  = Core::dot(oc, direction);
+    const auto c  = Core::dot(oc, oc) - radius * radius;
+    const auto d  = b * b - a * c;
+    if(d < 0.0f) {
+        return std::numeric_limits<float>::infinity();
+    }
+    const auto sqrtD = std::sqrt(d);
+    auto       t     = (-b - sqrtD) / a;
+    if(t < 0.0f) {
+        t = (-b + sqrtD) / a;
+    }
+    return t >= 0.0f ? t : std::numeric_limits<float>::infinity();
+}
+
+/* Distance along the ray to the first sphere hit, infinity if none */
+float bruteForceHit(const std::vector<Point3>& centers, const std::vector<float>& radii,
+                    const Point3& origin, const Point3& direction) {
+    auto bestT = std::numeric_limits<float>::infinity();
+    for(size_t idx = 0; idx < centers.size(); ++idx) {
+        bestT = std::min(bestT, intersectSphere(origin, direction, centers[idx], radii[idx]));
+    }
+    return bestT;
+}
+
+/* Cast nRays rays, from around the spheres or from inside their bounds, some of them along the axes */
+void checkRays(const std::vector<Point3>& centers, const std::vector<float>& radii, std::mt19937& rng,
+               size_t nRays) {
+    Core::SphereGrid grid;
+    grid.build(centers.data(), radii.data(), centers.size());
+    CHECK(grid.sphereCount() == centers.size());
+
+    std::uniform_real_distribution<float> coordinate(-12.0f, 12.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int>    axis(0, 5);
+    size_t nMismatches = 0, nHits = 0;
+    for(size_t ray = 0; ray < nRays; ++ray) {
+        const Point3 origin{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        Point3       direction;
+        if(ray % 4 == 0) {
+            const auto k    = axis(rng);
+            const auto sign = k < 3 ? 1.0f : -1.0f;
+            direction = Point3{ k % 3 == 0 ? sign : 0.0f, k % 3 == 1 ? sign : 0.0f, k % 3 == 2 ? sign : 0.0f };
+        } else if(ray % 4 == 1 && !centers.empty()) {
+            /* Aimed at a sphere, so that most of these rays hit */
+            direction = centers[ray % centers.size()] - origin;
+        } else {
+            direction = Point3{ unit(rng), unit(rng), unit(rng) };
+        }
+
+        const auto expected = bruteForceHit(centers, radii, origin, direction);
+        const auto hit      = grid.raycast(origin, direction);
+        const auto t        = hit < 0 ? std::numeric_limits<float>::infinity() :
+                              intersectSphere(origin, direction, centers[static_cast<size_t>(hit)],
+                                              radii[static_cast<size_t>(hit)]);
+        nMismatches += (t != expected) ? 1 : 0;
+        nHits       += hit < 0 ? 0 : 1;
+    }
+    CHECK(nMismatches == 0);
+    CHECK(centers.empty() || nHits > 0);
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937 rng(20200101);
+    std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> radius(0.01f, 1.0f);
+
+    /* Scattered spheres of various sizes */
+    std::vector<Point3> centers;
+    std::vector<float>  radii;
+    for(int idx = 0; idx < 2000; ++idx) {
+        centers.push_back(Point3{ coordinate(rng), coordinate(rng), coordinate(rng) });
+        radii.push_back(radius(rng));
+    }
+    checkRays(centers, radii, rng, 20000);
+
+    /* A few large spheres among small ones, forcing large cells */
+    radii[0] = 6.0f;
+    radii[1] = 3.0f;
+    checkRays(centers, radii, rng, 20000);
+
+    /* Flat set, all centers in the plane z = 0 */
+    for(auto& center : centers) {
+        center.z = 0.0f;
+    }
+    for(auto& r : radii) {
+        r = radius(rng);
+    }
+    checkRays(centers, radii, rng, 20000);
+
+    /* Coincident spheres, a single sphere and no sphere */
+    checkRays(std::vector<Point3>(50, Point3{ 1.0f, 2.0f, 3.0f }), std::vector<float>(50, 0.5f), rng, 2000);
+    checkRays({ Point3{ 0.0f, 0.0f, 0.0f } }, { 2.0f }, rng, 2000);
+    checkRays({}, {}, rng, 100);
+
+    /* Rays starting inside a sphere hit it, zero directions hit nothing */
+    Core::SphereGrid grid;
+    const Point3     center{ 0.0f, 0.0f, 0.0f };
+    const float      r = 1.0f;
+    grid.build(&center, &r, 1);
+    CHECK(grid.raycast(Point3{ 0.1f, 0.2f, 0.3f }, Point3{ 0.0f, 1.0f, 0.0f }) == 0);
+    CHECK(grid.raycast(Point3{ 0.0f, 0.0f, 5.0f }, Point3{ 0.0f, 0.0f, 1.0f }) == -1);
+    CHECK(grid.raycast(Point3{ 0.0f, 0.0f, 5.0f }, Point3{ 0.0f, 0.0f, 0.0f }) == -1);
+
+    return Test::result();
+}
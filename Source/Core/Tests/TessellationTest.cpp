@@ -0,0 +1,111 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Horner and forward differencing tessellations against the Bernstein evaluation, for cubics and
+ * quadratic pairs, with even and odd subdivisions */
+namespace {
+using Core::CurveType;
+using Core::Point3;
+using Core::TessellationMethod;
+
+/* Coordinates are in [-CoordinateRange, CoordinateRange] */
+constexpr float CoordinateRange = 100.0f;
+
+/* The power basis coefficients reach 8 times the coordinates, and forward differencing accumulates
+ * one rounding error per step, so the allowed error grows with the subdivision */
+float tolerance(TessellationMethod method, int subdivision) {
+    const float perStep = 4.0f * std::numeric_limits<float>::epsilon() * 8.0f * CoordinateRange;
+    return method == TessellationMethod::ForwardDifferencing ? perStep * static_cast<float>(subdivision) : perStep;
+}
+
+bool samePoint(const Point3& a, const Point3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+float maxDistance(const std::vector<Point3>& a, const std::vector<Point3>& b) {
+    float distance = 0;
+    for(size_t i = 0; i < a.size(); ++i) {
+        distance = std::max(distance, length(a[i] - b[i]));
+    }
+    return distance;
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    std::mt19937                          rng(4);
+    std::uniform_real_distribution<float> coordinate(-CoordinateRange, CoordinateRange);
+
+    const size_t nCurves = 37;
+    for(const auto type : { CurveType::CubicBezier, CurveType::QuadraticPair }) {
+        const auto          nControlPoints = Core::controlPointCount(type);
+        std::vector<Point3> controlPoints(nCurves * nControlPoints);
+        for(auto& p : controlPoints) {
+            p = Point3{ coordinate(rng), coordinate(rng), coordinate(rng) };
+        }
+
+        for(const int subdivision : { 1, 2, 3, 7, 8, 64, 255 }) {
+            std::vector<Point3> expected;
+            Core::tessellate(type, controlPoints.data(), nCurves, subdivision, expected, TessellationMethod::Bernstein);
+            CHECK(expected.size() == Core::tessellatedPointCount(nCurves, subdivision));
+
+            /* The Bernstein reference itself samples the curves at i / subdivision */
+            for(size_t idx = 0; idx < nCurves; ++idx) {
+                const auto* P = &controlPoints[idx * nControlPoints];
+                for(int i = 0; i <= subdivision; ++i) {
+                    const auto t = static_cast<float>(i) / static_cast<float>(subdivision);
+                    const auto p = type == CurveType::CubicBezier ? Core::evaluateCubic(P, t) :
+                                   Core::evaluateQuadraticPair(P, t);
+                    CHECK(length(expected[idx * static_cast<size_t>(subdivision + 1) + static_cast<size_t>(i)] - p) <=
+                          tolerance(TessellationMethod::Bernstein, subdivision));
+                }
+            }
+
+            for(const auto method : { TessellationMethod::Horner, TessellationMethod::ForwardDifferencing }) {
+                std::vector<Point3> points;
+                Core::tessellate(type, controlPoints.data(), nCurves, subdivision, points, method);
+                CHECK(points.size() == expected.size());
+                CHECK(maxDistance(points, expected) <= tolerance(method, subdivision));
+
+                /* Single curves on the calling thread give the same points */
+                std::vector<Point3> single(static_cast<size_t>(subdivision + 1));
+                for(size_t idx = 0; idx < nCurves; ++idx) {
+                    Core::tessellateCurve(type, &controlPoints[idx * nControlPoints], subdivision, single.data(), method);
+                    CHECK(std::equal(single.begin(), single.end(), &points[idx * single.size()], samePoint));
+                }
+
+                /* End points are exact */
+                for(size_t idx = 0; idx < nCurves; ++idx) {
+                    const auto* first = &points[idx * static_cast<size_t>(subdivision + 1)];
+                    CHECK(samePoint(first[0], controlPoints[idx * nControlPoints]));
+                    CHECK(samePoint(first[subdivision], controlPoints[(idx + 1) * nControlPoints - 1]));
+                }
+            }
+        }
+    }
+
+    return Test::result();
+}
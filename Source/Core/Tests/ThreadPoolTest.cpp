@@ -0,0 +1,154 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/ThreadPool.h"
+#include "Core/Tests/Check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/****************************************************************************************************/
+/* Core::ThreadPool::parallelFor() calls every index exactly once, in subranges of at most the grain size,
+ * and rethrows the exceptions of its tasks */
+namespace {
+void checkCoverage(Core::ThreadPool& pool, size_t begin, size_t end, size_t grainSize) {
+    std::unique_ptr<std::atomic<int>[]> counts(new std::atomic<int>[end]);
+    for(size_t idx = 0; idx < end; ++idx) {
+        counts[idx] = 0;
+    }
+    std::atomic<size_t> nBadRanges { 0 };
+    pool.parallelFor(begin, end, grainSize, [&](size_t rangeBegin, size_t rangeEnd) {
+                         if(rangeBegin < begin || rangeEnd > end || rangeBegin >= rangeEnd ||
+                            rangeEnd - rangeBegin > grainSize) {
+                             ++nBadRanges;
+                             return;
+                         }
+                         for(size_t idx = rangeBegin; idx < rangeEnd; ++idx) {
+                             ++counts[idx];
+                         }
+                     });
+    size_t nWrong = 0;
+    for(size_t idx = 0; idx < end; ++idx) {
+        nWrong += counts[idx] == (idx >= begin ? 1 : 0) ? 0 : 1;
+    }
+    CHECK(nBadRanges == 0);
+    CHECK(nWrong == 0);
+}
+
+/* Number of threads running the tasks of a call with slow tasks, more than one unless the calling
+ * thread wrongly believes to be inside a task */
+size_t runningThreadCount(Core::ThreadPool& pool) {
+    std::mutex                mutex;
+    std::set<std::thread::id> threads;
+    pool.parallelFor(0, 64, 1, [&](size_t, size_t) {
+                         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                         std::lock_guard<std::mutex> lock(mutex);
+                         threads.insert(std::this_thread::get_id());
+                     });
+    return threads.size();
+}
+
+void checkException(Core::ThreadPool& pool) {
+    for(const size_t failing : { size_t(0), size_t(4999), size_t(9999) }) {
+        bool bThrown = false;
+        try {
+            pool.parallelFor(0, 10000, 10, [&](size_t rangeBegin, size_t rangeEnd) {
+                                 if(failing >= rangeBegin && failing < rangeEnd) {
+                                     throw std::runtime_error("task " + std::to_string(failing));
+                                 }
+                             });
+        } catch(const std::runtime_error& e) {
+            bThrown = std::string(e.what()) == "task " + std::to_string(failing);
+        }
+        CHECK(bThrown);
+
+        /* The pool is still usable, from the workers' side and from the calling thread */
+        checkCoverage(pool, 0, 10000, 10);
+        if(pool.threadCount() > 1) {
+            CHECK(runningThreadCount(pool) > 1);
+        }
+    }
+}
+}
+
+/****************************************************************************************************/
+int main() {
+    for(const size_t nThreads : { 1, 2, 4, 8 }) {
+        Core::ThreadPool pool(nThreads);
+        CHECK(pool.threadCount() == nThreads);
+        for(const auto& [begin, end] : { std::pair<size_t, size_t>{ 0, 0 }, { 5, 5 }, { 0, 1 }, { 3, 1000 },
+                                         { 0, 100000 } }) {
+            for(const size_t grainSize : { 1, 7, 1000, 1 << 20 }) {
+                checkCoverage(pool, begin, end, grainSize);
+            }
+        }
+
+        checkException(pool);
+
+        /* Nested calls run serially inside the task */
+        checkCoverage(pool, 0, 1000, 10);
+        std::atomic<size_t> nNested { 0 };
+        pool.parallelFor(0, 100, 1, [&](size_t, size_t) {
+                             const auto thread = std::this_thread::get_id();
+                             bool       bSame  = true;
+                             pool.parallelFor(0, 100, 1, [&](size_t, size_t) {
+                                                  bSame = bSame && std::this_thread::get_id() == thread;
+                                              });
+                             nNested += bSame ? 1 : 0;
+                         });
+        CHECK(nNested == 100);
+
+        /* Concurrent callers share the pool */
+        std::vector<std::thread> callers;
+        for(int caller = 0; caller < 4; ++caller) {
+            callers.emplace_back([&pool] {
+                                     for(int iter = 0; iter < 50; ++iter) {
+                                         checkCoverage(pool, 0, 5000, 64);
+                                     }
+                                 });
+        }
+        for(auto& caller : callers) {
+            caller.join();
+        }
+    }
+
+    /* The shared pool can be replaced while it is in use */
+    Core::setThreadCount(3);
+    CHECK(Core::threadCount() == 3);
+    std::atomic<bool> bStop { false };
+    std::thread       user([&bStop] {
+                               while(!bStop) {
+                                   checkCoverage(*Core::threadPool(), 0, 10000, 100);
+                               }
+                           });
+    for(size_t iter = 0; iter < 200; ++iter) {
+        Core::setThreadCount(1 + iter % 4);
+    }
+    bStop = true;
+    user.join();
+    Core::setThreadCount(0);
+    CHECK(Core::threadCount() == std::max(1u, std::thread::hardware_concurrency()));
+
+    return Test::result();
+}
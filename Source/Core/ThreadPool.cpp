@@ -0,0 +1,244 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+/****************************************************************************************************/
+namespace {
+/* Set while a thread executes tasks, so that nested calls run serially instead of deadlocking */
+thread_local bool t_bInsideTask = false;
+
+/* Marks the calling thread as executing tasks for its lifetime, restoring the previous state on exit */
+struct InsideTaskScope {
+    InsideTaskScope() : bPrevious(t_bInsideTask) { t_bInsideTask = true; }
+    ~InsideTaskScope() { t_bInsideTask = bPrevious; }
+    bool bPrevious;
+};
+
+/* Ranges are split in halves, a queue never holds more than one piece per split level */
+constexpr size_t QueueCapacity = 64;
+
+/* Shared pool. Callers hold a reference for the duration of their call, so that setThreadCount() can
+ * replace it while other threads still run batch functions on the previous one */
+std::shared_ptr<Core::ThreadPool> g_ThreadPool;
+std::mutex                        g_ThreadPoolMutex;
+}
+
+/****************************************************************************************************/
+/* Ring buffer of ranges: the owner pushes and pops at the tail, thieves take from the head */
+struct alignas(64) Core::ThreadPool::Queue {
+    std::mutex mutex;
+    Range      ranges[QueueCapacity];
+    size_t     head { 0 };
+    size_t     tail { 0 };
+};
+
+/****************************************************************************************************/
+Core::ThreadPool::ThreadPool(size_t nThreads /*= 0*/) {
+    if(nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_Queues.reset(new Queue[nThreads]);
+    m_Workers.reserve(nThreads - 1);
+    for(size_t idx = 1; idx < nThreads; ++idx) {
+        m_Workers.emplace_back([this, idx] { workerLoop(idx); });
+    }
+}
+
+/****************************************************************************************************/
+Core::ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_bStop = true;
+    }
+    m_Wake.notify_all();
+    for(auto& worker : m_Workers) {
+        worker.join();
+    }
+}
+
+/****************************************************************************************************/
+void Core::ThreadPool::run(size_t begin, size_t end, size_t grainSize, Task task, const void* context) {
+    if(begin >= end) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+    if(m_Workers.empty() || t_bInsideTask || end - begin <= grainSize) {
+        /* Serially, in the same subranges of at most grainSize indices */
+        for(size_t first = begin; first < end;) {
+            const auto last = end - first > grainSize ? first + grainSize : end;
+            task(context, first, last);
+            first = last;
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> runLock(m_RunMutex);
+    Job job;
+    job.task      = task;
+    job.context   = context;
+    job.grainSize = grainSize;
+    job.remaining.store(end - begin, std::memory_order_relaxed);
+
+    /* One contiguous part per thread, the queues are empty between jobs */
+    const auto nThreads = threadCount();
+    const auto nParts   = std::min(nThreads, (end - begin + grainSize - 1) / grainSize);
+    for(size_t part = 0; part < nParts; ++part) {
+        auto& queue = m_Queues[part];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.ranges[queue.tail++ % QueueCapacity] = Range{ begin + (end - begin) * part / nParts,
+                                                            begin + (end - begin) * (part + 1) / nParts };
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Job = &job;
+        ++m_JobId;
+    }
+    m_Wake.notify_all();
+
+    {
+        InsideTaskScope insideTask;
+        work(0, job);
+    }
+
+    /* Workers still holding a pointer to the job must leave before it goes out of scope */
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Job = nullptr;
+        m_Done.wait(lock, [this] { return m_nActiveWorkers == 0; });
+    }
+    if(job.exception) {
+        std::rethrow_exception(job.exception);
+    }
+}
+
+/****************************************************************************************************/
+void Core::ThreadPool::work(size_t queueIdx, Job& job) {
+    while(job.remaining.load(std::memory_order_acquire) > 0) {
+        /* Ranges are only pushed by the thread holding them, which pops them back itself: with the own
+         * queue empty and nothing left to steal, the rest of the job is in the hands of other threads */
+        Range range;
+        if(!pop(queueIdx, range) && !steal(queueIdx, range, false) && !steal(queueIdx, range, true)) {
+            return;
+        }
+
+        /* Keep the upper halves available to thieves */
+        while(range.end - range.begin > job.grainSize) {
+            const auto middle = range.begin + (range.end - range.begin) / 2;
+            auto&      queue  = m_Queues[queueIdx];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.ranges[queue.tail++ % QueueCapacity] = Range{ middle, range.end };
+            range.end = middle;
+        }
+        /* After a failure the remaining ranges are only counted down */
+        if(!job.bFailed.load(std::memory_order_relaxed)) {
+            try {
+                job.task(job.context, range.begin, range.end);
+            } catch(...) {
+                if(!job.bFailed.exchange(true)) {
+                    job.exception = std::current_exception();
+                }
+            }
+        }
+        job.remaining.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+    }
+}
+
+/****************************************************************************************************/
+void Core::ThreadPool::workerLoop(size_t queueIdx) {
+    t_bInsideTask = true;
+    uint64_t lastJobId = 0;
+    while(true) {
+        Job* job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Wake.wait(lock, [&] { return m_bStop || m_JobId != lastJobId; });
+            if(m_bStop) {
+                return;
+            }
+            lastJobId = m_JobId;
+            job       = m_Job;
+            if(job == nullptr) {
+                continue; /* woke up after the job finished */
+            }
+            ++m_nActiveWorkers;
+        }
+
+        work(queueIdx, *job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            --m_nActiveWorkers;
+        }
+        m_Done.notify_one();
+    }
+}
+
+/****************************************************************************************************/
+bool Core::ThreadPool::pop(size_t queueIdx, Range& range) {
+    auto&                       queue = m_Queues[queueIdx];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if(queue.head == queue.tail) {
+        return false;
+    }
+    range = queue.ranges[--queue.tail % QueueCapacity];
+    return true;
+}
+
+/****************************************************************************************************/
+bool Core::ThreadPool::steal(size_t queueIdx, Range& range, bool bWait) {
+    const auto nThreads = threadCount();
+    for(size_t k = 1; k < nThreads; ++k) {
+        auto&                        queue = m_Queues[(queueIdx + k) % nThreads];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::defer_lock);
+        if(bWait) {
+            lock.lock();
+        } else if(!lock.try_lock()) {
+            continue;
+        }
+        if(queue.head == queue.tail) {
+            continue;
+        }
+        range = queue.ranges[queue.head++ % QueueCapacity];
+        return true;
+    }
+    return false;
+}
+
+/****************************************************************************************************/
+std::shared_ptr<Core::ThreadPool> Core::threadPool() {
+    std::lock_guard<std::mutex> lock(g_ThreadPoolMutex);
+    if(!g_ThreadPool) {
+        g_ThreadPool = std::make_shared<ThreadPool>();
+    }
+    return g_ThreadPool;
+}
+
+/****************************************************************************************************/
+void Core::setThreadCount(size_t nThreads) {
+    /* Create the new pool outside of the lock, the previous one is destroyed by its last user */
+    auto                        pool = std::make_shared<ThreadPool>(nThreads);
+    std::lock_guard<std::mutex> lock(g_ThreadPoolMutex);
+    g_ThreadPool.swap(pool);
+}
+
+/****************************************************************************************************/
+size_t Core::threadCount() {
+    return threadPool()->threadCount();
+}
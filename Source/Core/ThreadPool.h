@@ -0,0 +1,108 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/****************************************************************************************************/
+/* Work-stealing thread pool for the batch functions of the core library.
+ *
+ * parallelFor() hands one contiguous part of the range to every thread (the calling thread included).
+ * A thread splits its current range in halves down to the grain size, keeping the upper halves in its
+ * own queue: the owner pops the smallest pieces from the back, idle threads steal the largest ones from
+ * the front. Callers write the results of each index into disjoint, preallocated outputs, so the tasks
+ * themselves need no locks.
+ *
+ * Threads finding no range to pop or steal leave the job, the calling thread then blocks until the
+ * workers still running tasks are done. An exception thrown by a task keeps the ranges not started yet
+ * from running, and is rethrown by parallelFor() once the other threads have left the job.
+ *
+ * Calls made from inside a task, or with a single thread, run serially on the calling thread.
+ */
+namespace Core {
+class ThreadPool {
+public:
+    /* nThreads includes the calling thread, 0 selects std::thread::hardware_concurrency() */
+    explicit ThreadPool(size_t nThreads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t threadCount() const { return m_Workers.size() + 1; }
+
+    /* Call function(rangeBegin, rangeEnd) on subranges of [begin, end) of at most grainSize indices,
+     * and return once all of them are done */
+    template<class Function>
+    void parallelFor(size_t begin, size_t end, size_t grainSize, const Function& function) {
+        run(begin, end, grainSize,
+            [](const void* context, size_t rangeBegin, size_t rangeEnd) {
+                (*static_cast<const Function*>(context))(rangeBegin, rangeEnd);
+            }, &function);
+    }
+
+private:
+    using Task = void (*)(const void* context, size_t begin, size_t end);
+    struct Range {
+        size_t begin, end;
+    };
+    struct Job {
+        Task                task;
+        const void*         context;
+        size_t              grainSize;
+        std::atomic<size_t> remaining;
+        std::atomic<bool>   bFailed { false };
+        std::exception_ptr  exception; /* first exception thrown by a task */
+    };
+    struct Queue;
+
+    void run(size_t begin, size_t end, size_t grainSize, Task task, const void* context);
+    void work(size_t queueIdx, Job& job);
+    void workerLoop(size_t queueIdx);
+    bool pop(size_t queueIdx, Range& range);
+    /* Take a range from the queue of another thread, skipping the busy queues unless bWait is set */
+    bool steal(size_t queueIdx, Range& range, bool bWait);
+
+    std::vector<std::thread> m_Workers;
+    std::unique_ptr<Queue[]> m_Queues;
+
+    std::mutex              m_RunMutex; /* one parallelFor at a time */
+    std::mutex              m_Mutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Done;
+    Job*                    m_Job { nullptr };
+    uint64_t                m_JobId { 0 };
+    size_t                  m_nActiveWorkers { 0 };
+    bool                    m_bStop { false };
+};
+
+/* Pool shared by the batch functions. setThreadCount() replaces it, 0 selects
+ * std::thread::hardware_concurrency(). It may be called while other threads run batch functions: the
+ * returned pointer keeps the previous pool alive until those calls return, as it does in
+ * threadPool()->parallelFor(...) until the end of the statement. Calls made from inside a task would
+ * destroy the pool running them and are not allowed */
+std::shared_ptr<ThreadPool> threadPool();
+void setThreadCount(size_t nThreads);
+size_t threadCount();
+} // namespace Core
@@ -0,0 +1,156 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DrawableObjects/Curves/BatchedCurveRenderer.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/Shaders/Generic.h>
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+/****************************************************************************************************/
+BatchedCurveRenderer& BatchedCurveRenderer::draw(LineShader& shader, const Matrix4& transformationProjectionMatrix,
+                                                 const Vector2i& viewport, const Color3& color, float thickness,
+                                                 float miterLimit) {
+    uploadChanges();
+
+    /* One view per enabled, non-empty curve, all drawn at once */
+    m_DrawList.clear();
+    for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+        if(m_Curves[idx]->enabled() && m_Offsets[idx + 1] > m_Offsets[idx]) {
+            m_DrawList.emplace_back(m_Views[idx]);
+        }
+    }
+    if(m_DrawList.empty()) {
+        return *this;
+    }
+
+    shader.setTransformationProjectionMatrix(transformationProjectionMatrix)
+        .setColor(color)
+        .setThickness(thickness)
+        .setMiterLimit(miterLimit)
+        .setViewport(viewport);
+    shader.draw(Containers::arrayView(m_DrawList));
+    m_Ring.fence();
+    return *this;
+}
+
+/****************************************************************************************************/
+void BatchedCurveRenderer::relayout() {
+    m_Offsets.resize(m_Curves.size() + 1);
+    m_Offsets[0] = 0;
+    for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+        m_Offsets[idx + 1] = m_Offsets[idx] + m_Curves[idx]->pointCount();
+    }
+    if(m_Ring.reserve(m_Offsets.back() * sizeof(Vector3))) {
+        m_Mesh = GL::Mesh{ GL::MeshPrimitive::LineStripAdjacency };
+        m_Mesh.addVertexBuffer(m_Ring.buffer(), 0, Shaders::Generic3D::Position{});
+    }
+
+    /* Every region misses all vertices */
+    for(size_t region = 0; region < RingBuffer::RegionCount; ++region) {
+        auto& ranges = m_RegionRanges[region];
+        auto& curves = m_RegionCurves[region];
+        ranges.resize(m_Curves.size());
+        curves.clear();
+        for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+            ranges[idx] = DirtyRange{ 0, m_Offsets[idx + 1] - m_Offsets[idx] };
+            if(ranges[idx].end > 0) {
+                curves.push_back(idx);
+            }
+        }
+    }
+    for(const auto curve : m_Curves) {
+        curve->markUploaded();
+    }
+    m_ChangedCurves.clear();
+
+    m_Views.clear();
+    m_Views.reserve(m_Curves.size());
+    for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+        m_Views.emplace_back(m_Mesh);
+        m_Views.back().setCount(static_cast<Int>(m_Offsets[idx + 1] - m_Offsets[idx]));
+    }
+    m_bRelayout = false;
+}
+
+/****************************************************************************************************/
+void BatchedCurveRenderer::uploadChanges() {
+    /* Any change of vertex count moves the following curves: rebuild everything */
+    bool bChanged = m_bRelayout;
+    for(size_t k = 0; k < m_ChangedCurves.size() && !m_bRelayout; ++k) {
+        const auto idx = m_ChangedCurves[k];
+        m_bRelayout = m_Curves[idx]->pointCount() != m_Offsets[idx + 1] - m_Offsets[idx];
+    }
+    if(m_bRelayout) {
+        relayout();
+        bChanged = true;
+    }
+
+    /* Every region misses the changed vertices */
+    for(const auto idx : m_ChangedCurves) {
+        auto&            curve = *m_Curves[idx];
+        const DirtyRange range = curve.bufferInvalidated() ?
+                                 DirtyRange{ 0, curve.pointCount() } :
+                                 DirtyRange{ curve.dirtyFirst(), curve.dirtyFirst() + curve.dirtyCount() };
+        curve.markUploaded();
+        if(range.begin == range.end) {
+            continue;
+        }
+        for(size_t region = 0; region < RingBuffer::RegionCount; ++region) {
+            auto& missing = m_RegionRanges[region][idx];
+            if(missing.begin == missing.end) {
+                missing = range;
+                m_RegionCurves[region].push_back(idx);
+            } else {
+                missing.begin = std::min(missing.begin, range.begin);
+                missing.end   = std::max(missing.end, range.end);
+            }
+        }
+        bChanged = true;
+    }
+    m_ChangedCurves.clear();
+    if(!bChanged || m_Offsets.back() == 0) {
+        return;
+    }
+
+    /* Bring the next region up to date, it may miss the changes of the last RegionCount - 1 writes */
+    const auto vertices = reinterpret_cast<Vector3*>(m_Ring.beginWrite());
+    auto&      ranges   = m_RegionRanges[m_Ring.writeRegion()];
+    auto&      curves   = m_RegionCurves[m_Ring.writeRegion()];
+    Core::threadPool()->parallelFor(0, curves.size(), 64, [&](size_t first, size_t last) {
+                                        for(size_t k = first; k < last; ++k) {
+                                            const auto idx    = curves[k];
+                                            auto&      range  = ranges[idx];
+                                            const auto points = m_Curves[idx]->points().data();
+                                            std::copy(points + range.begin, points + range.end,
+                                                      vertices + m_Offsets[idx] + range.begin);
+                                            range = DirtyRange{};
+                                        }
+                                    });
+    curves.clear();
+    m_Ring.endWrite();
+
+    const auto baseVertex = m_Ring.currentOffset() / sizeof(Vector3);
+    for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+        m_Views[idx].setBaseVertex(static_cast<Int>(baseVertex + m_Offsets[idx]));
+    }
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "DrawableObjects/Curves/Curve.h"
+#include "DrawableObjects/RingBuffer.h"
+#include "Shaders/LineShader.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/GL/MeshView.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/****************************************************************************************************/
+/* Draws the lines of many curves sharing one style with a single multi-draw call (glMultiDrawArrays).
+ *
+ * The tessellated vertices of all curves are packed in one vertex buffer, curve i owning the vertices
+ * [offsets[i], offsets[i + 1]) of a region of a RingBuffer. When curves changed since the last draw, the
+ * renderer writes the next region and draws from it: the vertices are copied (in parallel) straight from
+ * the curves into the mapped region. Curves report their first change after an upload to the renderer,
+ * and each region keeps the list of curves it misses with the vertex range of each, so a write only
+ * visits and copies the changed vertices. A change of vertex count moves the following curves and
+ * rewrites everything.
+ */
+class BatchedCurveRenderer {
+public:
+
+    /* Curves drawn by this renderer, the buffer is rebuilt on the next draw */
+    template<class CurvePtr>
+    BatchedCurveRenderer& setCurves(const std::vector<CurvePtr>& curves) {
+        m_Curves.assign(curves.begin(), curves.end());
+        for(size_t idx = 0; idx < m_Curves.size(); ++idx) {
+            m_Curves[idx]->setRenderer(this, idx);
+        }
+        m_bRelayout = true;
+        return *this;
+    }
+
+    /* Called by curve idx on its first change since the last upload. Curves removed by setCurves() may
+     * still call it, they are ignored */
+    void curveChanged(const Curve* curve, size_t idx) {
+        if(idx < m_Curves.size() && m_Curves[idx] == curve) {
+            m_ChangedCurves.push_back(idx);
+        }
+    }
+
+    /* miterLimit is the LineShader one (see Curve::miterLimit()) */
+    BatchedCurveRenderer& draw(LineShader& shader, const Matrix4& transformationProjectionMatrix,
+                               const Vector2i& viewport, const Color3& color, float thickness, float miterLimit);
+
+    size_t vertexCount() const { return m_Offsets.empty() ? 0 : m_Offsets.back(); }
+    const RingBuffer& ringBuffer() const { return m_Ring; }
+
+private:
+    void relayout();
+    void uploadChanges();
+
+    std::vector<Curve*> m_Curves;
+    std::vector<size_t> m_Offsets;
+    bool                m_bRelayout { true };
+
+    /* Curves changed since the last upload */
+    std::vector<size_t> m_ChangedCurves;
+
+    /* Vertices of every curve (relative to its first one) that each region misses, and the curves of each
+     * region with a non-empty range */
+    struct DirtyRange {
+        size_t begin { 0 };
+        size_t end { 0 };
+    };
+    std::array<std::vector<DirtyRange>, RingBuffer::RegionCount> m_RegionRanges;
+    std::array<std::vector<size_t>, RingBuffer::RegionCount>     m_RegionCurves;
+
+    std::vector<GL::MeshView>                         m_Views;
+    std::vector<Containers::Reference<GL::MeshView>> m_DrawList;
+
+    RingBuffer m_Ring;
+    GL::Mesh   m_Mesh{ GL::MeshPrimitive::LineStripAdjacency };
+};
@@ -35,27 +35,6 @@ protected:
             Fatal() << "Cubic Bezier requires 4 control points, currently has"
                     << m_ControlPoints.size();
         }
-        const auto B0 = m_ControlPoints[0];
-        const auto B1 = m_ControlPoints[1];
-        const auto B2 = m_ControlPoints[2];
-        const auto B3 = m_ControlPoints[3];
-
-        const auto step = 1.0f / static_cast<float>(m_Subdivision);
-        for(int i = 0; i <= m_Subdivision; ++i) {
-            const auto t           = static_cast<float>(i) * step;
-            const auto t_sqr       = t * t;
-            const auto one_m_t     = 1.0f - t;
-            const auto one_m_t_sqr = one_m_t * one_m_t;
-
-            const auto position = one_m_t * one_m_t_sqr * B0 +
-                                  3.0f * one_m_t_sqr * t * B1 +
-                                  3.0f * one_m_t * t_sqr * B2 +
-                                  t * t_sqr * B3;
-            m_Points.push_back(position);
-
-            if(i == 0 || i == m_Subdivision) {
-                m_Points.push_back(position);
-            }
-        }
+        tessellateControlPoints(Core::CurveType::CubicBezier);
     }
 };
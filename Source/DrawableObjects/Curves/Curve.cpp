@@ -15,13 +15,13 @@
  */
 
 #include "DrawableObjects/Curves/Curve.h"
+#include "DrawableObjects/Curves/BatchedCurveRenderer.h"
 #include "DrawableObjects/PickableObject.h"
 
 #include <Corrade/Utility/Assert.h>
-#include <Corrade/Containers/ArrayView.h>
-#include <Magnum/MeshTools/Compile.h>
-#include <Magnum/Primitives/Icosphere.h>
-#include <Magnum/Trade/MeshData.h>
+
+#include <algorithm>
+#include <cstring>
 
 /****************************************************************************************************/
 Curve::Curve(Scene3D* const scene,
@@ -32,83 +32,134 @@ Curve::Curve(Scene3D* const scene,
              bool           editableControlPoints /*= true*/,
              float          controlPointRadius /*= 0.05f*/) :
     m_Subdivision(subdivision),  m_Color(color), m_Thickness(thickness),
-    m_MeshLines{GL::MeshPrimitive::LineStripAdjacency},
     m_Scene(scene),
     m_bRenderControlPoints(renderControlPoints),
     m_bEditableControlPoints(editableControlPoints),
     m_ControlPointRadius(controlPointRadius) {
     /* Make sure to have control points */
     CORRADE_INTERNAL_ASSERT(m_Scene);
-
-    /* Setup mesh for line rendering */
-    m_MeshLines.addVertexBuffer(m_BufferLines, 0, Shaders::Generic3D::Position{});
-
-    /* Setup point rendering variables */
-    m_MeshSphere = MeshTools::compile(Primitives::icosphereSolid(3));
 }
 
 /****************************************************************************************************/
-Curve::~Curve() {} /* Must define in .cpp file to have complete types */
+Curve::~Curve() {
+    for(const auto point : m_DrawablePoints) {
+        PickableObject::release(point);
+    }
+}
 
 /****************************************************************************************************/
 Curve& Curve::recomputeCurve() {
+    return computePoints().invalidateBuffer();
+}
+
+/****************************************************************************************************/
+Curve& Curve::computePoints() {
     m_Points.resize(0);
-    m_BufferLines.invalidateData();
     computeLines();
-    m_bDirty = true;
     return *this;
 }
 
 /****************************************************************************************************/
-Curve& Curve::setControlPoints(const Curve::VPoints& points) {
+Curve& Curve::invalidateBuffer() {
+    const bool bWasUploaded = !m_bDirty && m_DirtyBegin == m_DirtyEnd;
+    m_bDirty     = true;
+    m_DirtyBegin = m_DirtyEnd = 0;
+    notifyRenderer(bWasUploaded);
+    return *this;
+}
+
+/****************************************************************************************************/
+Curve& Curve::setControlPoints(const Curve::VPoints& points, bool bRecompute /*= true*/) {
     m_ControlPoints = points;
     size_t oldSize = m_DrawablePoints.size();
+    for(size_t i = points.size(); i < oldSize; ++i) {
+        PickableObject::release(m_DrawablePoints[i]);
+    }
     m_DrawablePoints.resize(points.size());
 
     for(size_t i = oldSize; i < points.size(); ++i) {
         auto& newPoint = m_DrawablePoints[i];
-        newPoint = new PickableObject(m_SphereShader,
-                                      m_Color,
-                                      m_MeshSphere,
-                                      m_Scene,
-                                      &m_Drawables);
+        newPoint = PickableObject::create(m_Color, m_Scene);
         newPoint->setSelectable(m_bEditableControlPoints);
     }
 
-    for(size_t i = 0; i < m_DrawablePoints.size(); ++i) {
-        m_DrawablePoints[i]->setTransformation(Matrix4::translation(m_ControlPoints[i]) *
-                                               Matrix4::scaling(Vector3(m_ControlPointRadius)));
-    }
+    updateDrawablePoints(0, m_DrawablePoints.size());
 
     /* Recompute lines */
-    recomputeCurve();
+    if(bRecompute) {
+        recomputeCurve();
+    }
     return *this;
 }
 
 /****************************************************************************************************/
-Curve& Curve::draw(SceneGraph::Camera3D& camera, const Vector2i& viewport) {
-    if(!m_bEnable || m_Points.empty()) {
-        return *this;
-    }
+size_t Curve::memoryUsage() const {
+    return sizeof(Point) * (m_ControlPoints.capacity() + m_Points.capacity()) +
+           sizeof(Core::Point3) * m_AdaptivePoints.capacity() +
+           sizeof(PickableObject*) * m_DrawablePoints.capacity();
+}
 
-    if(m_bDirty) {
-        Containers::ArrayView<const float> data(reinterpret_cast<const float*>(&m_Points[0]), m_Points.size() * 3);
-        m_BufferLines.setData(data);
-        m_MeshLines.setCount(static_cast<int>(m_Points.size()));
-        m_bDirty = false;
+/****************************************************************************************************/
+void Curve::updateDrawablePoints(size_t first, size_t count) {
+    for(size_t i = first; i < first + count; ++i) {
+        m_DrawablePoints[i]->setTransformation(Matrix4::translation(m_ControlPoints[i]) *
+                                               Matrix4::scaling(Vector3(m_ControlPointRadius)));
     }
+}
 
-    const auto transformPrjMat = camera.projectionMatrix() * camera.cameraMatrix();
-    m_LineShader.setTransformationProjectionMatrix(transformPrjMat)
-        .setColor(m_Color)
-        .setThickness(m_Thickness)
-        .setMiterLimit(m_MiterLimit)
-        .setViewport(viewport)
-        .draw(m_MeshLines);
+/****************************************************************************************************/
+void Curve::invalidateBufferRange(size_t first, size_t count) {
+    if(m_bDirty || count == 0) {
+        return; /* the whole buffer is uploaded anyway */
+    }
+    if(m_DirtyBegin == m_DirtyEnd) {
+        m_DirtyBegin = first;
+        m_DirtyEnd   = first + count;
+        notifyRenderer(true);
+    } else {
+        m_DirtyBegin = std::min(m_DirtyBegin, first);
+        m_DirtyEnd   = std::max(m_DirtyEnd, first + count);
+    }
+}
 
-    if(m_bRenderControlPoints) {
-        camera.draw(m_Drawables);
+/****************************************************************************************************/
+void Curve::notifyRenderer(bool bWasUploaded) {
+    if(bWasUploaded && m_Renderer) {
+        m_Renderer->curveChanged(this, m_RendererIdx);
     }
+}
 
-    return *this;
+/****************************************************************************************************/
+void Curve::tessellateControlPoints(Core::CurveType type) {
+    static_assert(sizeof(Vector3) == sizeof(Core::Point3), "Vector3 and Core::Point3 layouts must match");
+    const auto controlPoints = reinterpret_cast<const Core::Point3*>(m_ControlPoints.data());
+
+    /* A chain of quadratic pairs (4N + 1 points) is tessellated pair by pair, the pairs share end points */
+    const size_t nPieces = (type == Core::CurveType::CubicBezier) ? 1 : (m_ControlPoints.size() - 1) / 4;
+    if(m_bAdaptiveTessellation) {
+        m_AdaptivePoints.resize(0);
+        for(size_t k = 0; k < nPieces; ++k) {
+            if(k > 0) {
+                m_AdaptivePoints.pop_back();
+            }
+            Core::appendAdaptiveTessellation(type, controlPoints + 4 * k, m_TessellationTolerance, m_AdaptivePoints);
+        }
+        m_Points.resize(m_AdaptivePoints.size() + 2);
+        std::memcpy(&m_Points[1], m_AdaptivePoints.data(), m_AdaptivePoints.size() * sizeof(Vector3));
+    } else {
+        /* The subdivision is spread over the pairs, each pair keeps an even count of at least 2 segments
+         * so that its joint Q2 is a vertex: the vertex count grows with the pair count past that point */
+        const auto nPairs      = static_cast<int>(nPieces);
+        const int  subdivision = (type == Core::CurveType::CubicBezier) ?
+                                 std::max(1, m_Subdivision) :
+                                 2 * std::max(1, (m_Subdivision + 2 * nPairs - 1) / (2 * nPairs));
+        m_Points.resize(nPieces * static_cast<size_t>(subdivision) + 3);
+        for(size_t k = 0; k < nPieces; ++k) {
+            Core::tessellateCurve(type, controlPoints + 4 * k, subdivision,
+                                  reinterpret_cast<Core::Point3*>(&m_Points[1 + k * static_cast<size_t>(subdivision)]),
+                                  m_TessellationMethod);
+        }
+    }
+    m_Points.front() = m_Points[1];
+    m_Points.back()  = m_Points[m_Points.size() - 2];
 }
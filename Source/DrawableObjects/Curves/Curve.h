@@ -16,13 +16,11 @@
 
 #pragma once
 
-#include "Shaders/LineShader.h"
+#include "Core/CurveBatch.h"
 
-#include <Magnum/GL/Buffer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Math/Color.h>
 #include <Magnum/SceneGraph/Camera.h>
-#include <Magnum/Shaders/Phong.h>
 #include <Magnum/SceneGraph/Drawable.h>
 
 #include <vector>
@@ -30,9 +28,12 @@
 using namespace Corrade;
 using namespace Magnum;
 using Scene3D = SceneGraph::Scene<SceneGraph::MatrixTransformation3D>;
+class BatchedCurveRenderer;
 class PickableObject;
 
 /****************************************************************************************************/
+/* Control points and tessellated vertices of a curve. The lines of all curves are drawn by a
+ * BatchedCurveRenderer from one shared vertex buffer, a curve only tracks which of its vertices changed */
 class Curve {
 public:
     using Point          = Vector3;
@@ -46,12 +47,30 @@ public:
                    bool           renderControlPoints   = true,
                    bool           editableControlPoints = true,
                    float          controlPointRadius    = 0.05f);
+    /* Releases the drawables of the control points */
     virtual ~Curve();
 
     /* Operations */
-    Curve& draw(SceneGraph::Camera3D& camera, const Vector2i& viewport);
     Curve& recomputeCurve();
-    Curve& setControlPoints(const VPoints& points);
+    Curve& setControlPoints(const VPoints& points, bool bRecompute = true);
+
+    /* The two halves of recomputeCurve(): computePoints() only touches this curve's CPU data and may run
+     * concurrently for different curves, invalidateBuffer() marks all vertices for upload */
+    Curve& computePoints();
+    Curve& invalidateBuffer();
+
+    /* Tessellated vertices, with duplicated end points for line strip adjacency */
+    const VPoints& points() const { return m_Points; }
+
+    /* Vertices changed since the last upload: all of them, or the range [first, first + count) */
+    bool bufferInvalidated() const { return m_bDirty; }
+    size_t dirtyFirst() const { return m_DirtyBegin; }
+    size_t dirtyCount() const { return m_DirtyEnd - m_DirtyBegin; }
+    void markUploaded() { m_bDirty = false; m_DirtyBegin = m_DirtyEnd = 0; }
+
+    /* Renderer drawing this curve as its curve idx, told about the first change after each upload so that
+     * it does not scan its curves. Invalidations must then come from one thread at a time */
+    void setRenderer(BatchedCurveRenderer* renderer, size_t idx) { m_Renderer = renderer; m_RendererIdx = idx; }
 
     /* General curve data */
     int& subdivision() { return m_Subdivision; }
@@ -59,36 +78,64 @@ public:
     Color3& color() { return m_Color; }
     float& thickness() { return m_Thickness; }
     float& miterLimit() { return m_MiterLimit; }
+    Core::TessellationMethod& tessellationMethod() { return m_TessellationMethod; }
+    size_t pointCount() const { return m_Points.size(); }
+
+    /* Heap memory of the point vectors in bytes, without the pooled drawables of the control points */
+    size_t memoryUsage() const;
+
+    /* Adaptive tessellation: ignore the subdivision and keep the chord deviation below the tolerance */
+    bool& adaptiveTessellation() { return m_bAdaptiveTessellation; }
+    float& tessellationTolerance() { return m_TessellationTolerance; }
 
-    /* Control point data */
+    /* Control point data, the spheres are drawn by an InstancedSphereRenderer */
+    const DrawablePoints& drawablePoints() const { return m_DrawablePoints; }
     bool& renderControlPoints() { return m_bRenderControlPoints; }
     float& controlPointRadius() { return m_ControlPointRadius; }
 
 protected:
     virtual void computeLines() = 0;
 
+    /* Tessellate m_ControlPoints into m_Points, with duplicated end points for line strip adjacency */
+    void tessellateControlPoints(Core::CurveType type);
+
+    /* Move the drawables of control points [first, first + count) to their positions */
+    void updateDrawablePoints(size_t first, size_t count);
+
+    /* Upload only the vertices [first, first + count) of m_Points, the vertex count must not have changed
+     * since the last upload */
+    void invalidateBufferRange(size_t first, size_t count);
+
+private:
+    /* Tell the renderer when the curve changes for the first time since the last upload */
+    void notifyRenderer(bool bWasUploaded);
+
+protected:
     /* Main variables */
     bool m_bEnable { true };
-    bool m_bDirty { false };
+    bool m_bDirty { true };
 
     /* Main points of line segments */
-    int     m_Subdivision { 128 };
-    VPoints m_Points;
-    Color3  m_Color { 1.0f };
-    float   m_Thickness { 1.0f };
-    float   m_MiterLimit { 0.1f };
-
-    /* Render variables for line segments */
-    GL::Buffer m_BufferLines;
-    GL::Mesh   m_MeshLines;
-    LineShader m_LineShader;
+    int                       m_Subdivision { 128 };
+    Core::TessellationMethod  m_TessellationMethod { Core::TessellationMethod::Horner };
+    bool                      m_bAdaptiveTessellation { false };
+    float                     m_TessellationTolerance { 1.0e-3f };
+    std::vector<Core::Point3> m_AdaptivePoints;
+    VPoints                   m_Points;
+    Color3                    m_Color { 1.0f };
+    float                     m_Thickness { 1.0f };
+    float                     m_MiterLimit { 0.1f };
+
+    /* Vertex range of a partial upload */
+    size_t m_DirtyBegin { 0 };
+    size_t m_DirtyEnd { 0 };
+
+    BatchedCurveRenderer* m_Renderer { nullptr };
+    size_t                m_RendererIdx { 0 };
 
     /* Scene variable for rendering control points */
-    Scene3D* const              m_Scene;
-    SceneGraph::DrawableGroup3D m_Drawables;
-    Shaders::Phong              m_SphereShader{ Shaders::Phong::Flag::ObjectId };
-    GL::Mesh                    m_MeshSphere{ NoCreate };
-    DrawablePoints              m_DrawablePoints;
+    Scene3D* const m_Scene;
+    DrawablePoints m_DrawablePoints;
 
     VPoints m_ControlPoints;
     bool    m_bRenderControlPoints { true };
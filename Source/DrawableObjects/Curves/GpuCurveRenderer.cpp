@@ -0,0 +1,104 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DrawableObjects/Curves/GpuCurveRenderer.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/BufferTextureFormat.h>
+
+/****************************************************************************************************/
+GpuCurveRenderer::GpuCurveRenderer(Core::CurveType type) : m_Type(type) {
+    m_PointTexture.setBuffer(GL::BufferTextureFormat::R32F, m_PointBuffer);
+    m_Mesh.addVertexBufferInstanced(m_FirstPointBuffer, 1, 0, CurveEvaluationShader::FirstPoint{});
+    m_StrokeMesh.setCount(QuadraticStrokeShader::VertexCount)
+        .addVertexBufferInstanced(m_FirstPointBuffer, 1, 0, QuadraticStrokeShader::FirstPoint{});
+}
+
+/****************************************************************************************************/
+GpuCurveRenderer& GpuCurveRenderer::setControlPoints(const Vector3* points, size_t nPoints, size_t stride) {
+    m_FirstPoints.resize(nPoints / stride);
+    for(size_t idx = 0; idx < m_FirstPoints.size(); ++idx) {
+        m_FirstPoints[idx] = static_cast<UnsignedInt>(idx * stride);
+    }
+    uploadPoints(points, nPoints);
+    return *this;
+}
+
+/****************************************************************************************************/
+GpuCurveRenderer& GpuCurveRenderer::setControlPoints(const Vector3* points, size_t nPoints,
+                                                     const std::vector<size_t>& offsets) {
+    m_FirstPoints.clear();
+    for(size_t idx = 0; idx + 1 < offsets.size(); ++idx) {
+        for(size_t first = offsets[idx]; first + 4 < offsets[idx + 1]; first += 4) {
+            m_FirstPoints.push_back(static_cast<UnsignedInt>(first));
+        }
+    }
+    uploadPoints(points, nPoints);
+    return *this;
+}
+
+/****************************************************************************************************/
+GpuCurveRenderer& GpuCurveRenderer::updateControlPoints(size_t first, const Vector3* points, size_t count) {
+    m_PointBuffer.setSubData(static_cast<GLintptr>(first * sizeof(Vector3)), Containers::arrayView(points, count));
+    return *this;
+}
+
+/****************************************************************************************************/
+GpuCurveRenderer& GpuCurveRenderer::draw(CurveEvaluationShader& shader, const Matrix4& transformationProjectionMatrix,
+                                         const Vector2i& viewport, const Color3& color, float thickness, int segments) {
+    if(m_FirstPoints.empty()) {
+        return *this;
+    }
+    m_Mesh.setCount(segments + 3)
+        .setInstanceCount(static_cast<Int>(m_FirstPoints.size()));
+
+    shader.setCurveType(m_Type)
+        .setSegments(segments)
+        .bindControlPoints(m_PointTexture)
+        .setTransformationProjectionMatrix(transformationProjectionMatrix)
+        .setColor(color)
+        .setThickness(thickness)
+        .setViewport(viewport);
+    shader.draw(m_Mesh);
+    return *this;
+}
+
+/****************************************************************************************************/
+GpuCurveRenderer& GpuCurveRenderer::drawStrokes(QuadraticStrokeShader& shader, const Matrix4& transformationProjectionMatrix,
+                                                const Vector2i& viewport, const Color3& color, float thickness) {
+    CORRADE_INTERNAL_ASSERT(m_Type == Core::CurveType::QuadraticPair);
+    if(m_FirstPoints.empty()) {
+        return *this;
+    }
+    m_StrokeMesh.setInstanceCount(static_cast<Int>(m_FirstPoints.size()));
+
+    shader.bindControlPoints(m_PointTexture)
+        .setTransformationProjectionMatrix(transformationProjectionMatrix)
+        .setColor(color)
+        .setThickness(thickness)
+        .setViewport(viewport)
+        .draw(m_StrokeMesh);
+    return *this;
+}
+
+/****************************************************************************************************/
+void GpuCurveRenderer::uploadPoints(const Vector3* points, size_t nPoints) {
+    m_PointBuffer.setData(Containers::arrayView(points, nPoints), GL::BufferUsage::DynamicDraw);
+    m_FirstPointBuffer.setData(Containers::arrayView(m_FirstPoints), GL::BufferUsage::DynamicDraw);
+}
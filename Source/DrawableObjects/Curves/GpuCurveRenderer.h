@@ -0,0 +1,73 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Shaders/CurveEvaluationShader.h"
+#include "Shaders/QuadraticStrokeShader.h"
+#include "Core/CurveBatch.h"
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/BufferTexture.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include <vector>
+
+/****************************************************************************************************/
+/* Draws curves of one style from their control points only, the CurveEvaluationShader evaluating the
+ * vertices on the GPU. The vertex count is a draw parameter: changing the segment count uploads nothing,
+ * and changing control points uploads only the changed points (3 floats each).
+ *
+ * Every piece (cubic curve or quadratic pair) is one instance. The pieces are given either by a fixed
+ * stride (4 points per cubic, 5 per quadratic pair), or by the offsets of chains of quadratic pairs
+ * sharing end points (Core::QuadraticChains).
+ *
+ * Quadratic pairs can also be stroked analytically by the QuadraticStrokeShader, from the same buffers.
+ */
+class GpuCurveRenderer {
+public:
+    explicit GpuCurveRenderer(Core::CurveType type);
+
+    /* All control points, a piece starting every stride points */
+    GpuCurveRenderer& setControlPoints(const Vector3* points, size_t nPoints, size_t stride);
+    /* All control points, curve i being the chain of quadratic pairs [offsets[i], offsets[i + 1]) */
+    GpuCurveRenderer& setControlPoints(const Vector3* points, size_t nPoints, const std::vector<size_t>& offsets);
+    /* Control points [first, first + count), the piece layout must not have changed */
+    GpuCurveRenderer& updateControlPoints(size_t first, const Vector3* points, size_t count);
+
+    GpuCurveRenderer& draw(CurveEvaluationShader& shader, const Matrix4& transformationProjectionMatrix,
+                           const Vector2i& viewport, const Color3& color, float thickness, int segments);
+
+    /* Quadratic pairs only, see QuadraticStrokeShader */
+    GpuCurveRenderer& drawStrokes(QuadraticStrokeShader& shader, const Matrix4& transformationProjectionMatrix,
+                                  const Vector2i& viewport, const Color3& color, float thickness);
+
+    size_t pieceCount() const { return m_FirstPoints.size(); }
+
+private:
+    void uploadPoints(const Vector3* points, size_t nPoints);
+
+    Core::CurveType           m_Type;
+    std::vector<UnsignedInt>  m_FirstPoints;
+    GL::Buffer                m_PointBuffer;
+    GL::Buffer                m_FirstPointBuffer;
+    GL::BufferTexture         m_PointTexture;
+    GL::Mesh                  m_Mesh{ GL::MeshPrimitive::LineStripAdjacency };
+    GL::Mesh                  m_StrokeMesh{ GL::MeshPrimitive::Triangles };
+};
@@ -17,6 +17,8 @@
 #pragma once
 #include "DrawableObjects/Curves/Curve.h"
 
+#include <algorithm>
+
 /****************************************************************************************************/
 class Polyline : public Curve {
 public:
@@ -28,6 +30,32 @@ public:
                       float          controlPointRadius    = 0.05f) :
         Curve(scene, 1, color, thickness, renderControlPoints, editableControlPoints, controlPointRadius) {}
 
+    /* Replace control points [first, first + count), updating only the matching vertices and their part of
+     * the line buffer */
+    Polyline& updateControlPoints(size_t first, const Vector3* points, size_t count) {
+        std::copy(points, points + count, m_ControlPoints.begin() + static_cast<std::ptrdiff_t>(first));
+        updateDrawablePoints(first, count);
+        if(m_Points.size() != m_ControlPoints.size() + 2) {
+            recomputeCurve();
+            return *this;
+        }
+
+        /* m_Points is the control polygon with duplicated end points */
+        std::copy(points, points + count, m_Points.begin() + static_cast<std::ptrdiff_t>(first + 1));
+        size_t begin = first + 1;
+        size_t end   = first + 1 + count;
+        if(first == 0) {
+            m_Points.front() = m_Points[1];
+            begin = 0;
+        }
+        if(first + count == m_ControlPoints.size()) {
+            m_Points.back() = m_Points[m_Points.size() - 2];
+            end = m_Points.size();
+        }
+        invalidateBufferRange(begin, end - begin);
+        return *this;
+    }
+
 protected:
     virtual void computeLines() override {
         if(m_ControlPoints.size() == 0) {
@@ -18,6 +18,8 @@
 #include "DrawableObjects/Curves/Curve.h"
 
 /****************************************************************************************************/
+/* C1 quadratic pair approximating a cubic (5 control points), or a chain of N such pairs sharing end
+ * points (4N + 1 control points) from the tolerance-driven approximation */
 class QuadraticApproximatingCubic : public Curve {
 public:
     explicit QuadraticApproximatingCubic(Scene3D* const scene,
@@ -29,34 +31,18 @@ public:
                                          float          controlPointRadius    = 0.05f) :
         Curve(scene, subdivision, color, thickness, renderControlPoints,
               editableControlPoints, controlPointRadius) {}
+
+    /* Gamma used to compute the control points of this curve */
+    float& gamma() { return m_Gamma; }
+
 protected:
     virtual void computeLines() override {
-        if(m_ControlPoints.size() != 5) {
-            Fatal() << "Quadratic Approximation Bezier requires 5 control points, currently has"
+        if(m_ControlPoints.size() < 5 || (m_ControlPoints.size() - 1) % 4 != 0) {
+            Fatal() << "Quadratic Approximation Bezier requires 4N + 1 control points, currently has"
                     << m_ControlPoints.size();
         }
-        const auto Q0 = m_ControlPoints[0];
-        const auto Q1 = m_ControlPoints[1];
-        const auto Q2 = m_ControlPoints[2];
-        const auto Q3 = m_ControlPoints[3];
-        const auto Q4 = m_ControlPoints[4];
-
-        const auto step = 1.0f / static_cast<float>(m_Subdivision);
-        for(int i = 0; i <= m_Subdivision; ++i) {
-            const auto t           = static_cast<float>(i) * step;
-            const auto s           = (t < 0.5f) ? 2.0f * t : 2.0f * (t - 0.5f);
-            const auto s_sqr       = s * s;
-            const auto one_m_s     = 1.0f - s;
-            const auto one_m_s_sqr = one_m_s * one_m_s;
-
-            const auto position = (t < 0.5f) ?
-                                  one_m_s_sqr * Q0 + 2.0f * one_m_s * s * Q1 + s_sqr * Q2 :
-                                  one_m_s_sqr * Q2 + 2.0f * one_m_s * s * Q3 + s_sqr * Q4;
-            m_Points.push_back(position);
-
-            if(i == 0 || i == m_Subdivision) {
-                m_Points.push_back(position);
-            }
-        }
+        tessellateControlPoints(Core::CurveType::QuadraticPair);
     }
+
+    float m_Gamma { 0.5f };
 };
@@ -0,0 +1,90 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DrawableObjects/InstancedSphereRenderer.h"
+#include "DrawableObjects/PickableObject.h"
+
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Matrix4.h>
+
+#include <algorithm>
+#include <cstring>
+
+/****************************************************************************************************/
+InstancedSphereRenderer::InstancedSphereRenderer(ResourceCache::SphereGeometry& sphere) {
+    static_assert(sizeof(Instance) == sizeof(Vector4) + sizeof(Color3) + sizeof(UnsignedInt),
+                  "Instance attributes must be tightly packed");
+    m_Mesh.setCount(sphere.indexCount)
+        .addVertexBuffer(sphere.vertices, 0,
+                         InstancedSphereShader::Position{},
+                         InstancedSphereShader::Normal{})
+        .setIndexBuffer(sphere.indices, 0, MeshIndexType::UnsignedInt)
+        .addVertexBufferInstanced(m_InstanceBuffer, 1, 0,
+                                  InstancedSphereShader::CenterRadius{},
+                                  InstancedSphereShader::Color{},
+                                  InstancedSphereShader::ObjectId{});
+}
+
+/****************************************************************************************************/
+InstancedSphereRenderer& InstancedSphereRenderer::addObjects(const std::vector<PickableObject*>& objects) {
+    /* Grown geometrically, so that adding objects one by one does not reallocate the buffer each frame */
+    if(m_nInstances + objects.size() > m_Instances.size()) {
+        m_Instances.resize(std::max(m_nInstances + objects.size(), 2 * m_Instances.size()));
+    }
+    for(const auto object : objects) {
+        /* The selected sphere is highlighted by a brighter color, as there is no per-instance ambient color */
+        const auto& transformation = object->transformation();
+        const Instance instance{ Vector4{ transformation.translation(), transformation.scaling().max() },
+                                 object->color() * (object->isSelected() ? 2.0f : 1.0f),
+                                 object->idx() };
+        const auto idx = m_nInstances++;
+        if(std::memcmp(&m_Instances[idx], &instance, sizeof(Instance)) != 0) {
+            m_Instances[idx] = instance;
+            m_DirtyBegin     = m_DirtyBegin < m_DirtyEnd ? std::min(m_DirtyBegin, idx) : idx;
+            m_DirtyEnd       = std::max(m_DirtyEnd, idx + 1);
+        }
+    }
+    return *this;
+}
+
+/****************************************************************************************************/
+InstancedSphereRenderer& InstancedSphereRenderer::draw(SceneGraph::Camera3D& camera) {
+    if(m_nInstances == 0) {
+        return *this;
+    }
+
+    /* Reallocate when the buffer is too small, otherwise upload the changed instances only */
+    if(m_Instances.size() > m_nBufferInstances) {
+        m_InstanceBuffer.setData(Containers::arrayView(m_Instances), GL::BufferUsage::DynamicDraw);
+        m_nBufferInstances = m_Instances.size();
+    } else if(m_DirtyBegin < m_DirtyEnd) {
+        m_InstanceBuffer.setSubData(static_cast<GLintptr>(m_DirtyBegin * sizeof(Instance)),
+                                    Containers::arrayView(m_Instances.data() + m_DirtyBegin,
+                                                          m_DirtyEnd - m_DirtyBegin));
+    }
+    m_DirtyBegin = m_DirtyEnd = 0;
+    m_Mesh.setInstanceCount(static_cast<Int>(m_nInstances));
+
+    /* Instances are in world space, the uniforms bring them to the camera */
+    ResourceCache::instancedSphereShader()
+        .setCameraMatrix(camera.cameraMatrix())
+        .setProjectionMatrix(camera.projectionMatrix())
+    /* relative to the camera */
+        .setLightPosition({ 13.0f, 2.0f, 5.0f })
+        .draw(m_Mesh);
+    return *this;
+}
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "DrawableObjects/ResourceCache.h"
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/Mesh.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Vector4.h>
+#include <Magnum/SceneGraph/Camera.h>
+
+#include <vector>
+
+using namespace Corrade;
+using namespace Magnum;
+class PickableObject;
+
+/****************************************************************************************************/
+/* Draws many pickable spheres with a single instanced draw call.
+ *
+ * Every sphere is packed as its center, radius, color and object ID into an instance buffer, and the
+ * shader builds the transformation from them. The buffer is kept between frames: objects are added in
+ * the same order after each clear(), and only the instances that differ from the previous frame (added,
+ * moved, selected or recolored) are uploaded on draw. The shader writes the ID of each instance to the
+ * object ID attachment, so picking works as with spheres drawn one by one.
+ */
+class InstancedSphereRenderer {
+public:
+    /* Per-instance attributes, in the layout of the instance buffer */
+    struct Instance {
+        Vector4     centerRadius;
+        Color3      color;
+        UnsignedInt objectId;
+    };
+
+    explicit InstancedSphereRenderer(ResourceCache::SphereGeometry& sphere);
+
+    InstancedSphereRenderer& clear() { m_nInstances = 0; return *this; }
+    InstancedSphereRenderer& addObjects(const std::vector<PickableObject*>& objects);
+    InstancedSphereRenderer& draw(SceneGraph::Camera3D& camera);
+
+    size_t instanceCount() const { return m_nInstances; }
+
+private:
+    /* Copy of the buffer content, of which the first m_nInstances are drawn. Instances in
+     * [m_DirtyBegin, m_DirtyEnd) changed since the last upload */
+    std::vector<Instance> m_Instances;
+    size_t                m_nInstances { 0 };
+    size_t                m_nBufferInstances { 0 };
+    size_t                m_DirtyBegin { 0 };
+    size_t                m_DirtyEnd { 0 };
+    GL::Buffer            m_InstanceBuffer;
+    GL::Mesh              m_Mesh;
+};
@@ -16,65 +16,95 @@
 
 #include "DrawableObjects/PickableObject.h"
 
-#include <Magnum/SceneGraph/Camera.h>
 #include <Magnum/SceneGraph/Scene.h>
-#include <Magnum/GL/Mesh.h>
+
+#include "Core/ObjectPool.h"
+
+/****************************************************************************************************/
+namespace {
+Core::ObjectPool<PickableObject>& pool() {
+    static Core::ObjectPool<PickableObject> s_Pool;
+    return s_Pool;
+}
+}
 
 /****************************************************************************************************/
-PickableObject::PickableObject(Shaders::Phong& shader, const Color3& color,
-                               GL::Mesh& mesh, Scene3D* parent,
-                               SceneGraph::DrawableGroup3D* drawables) :
+PickableObject::PickableObject(const Color3& color, Scene3D* parent) :
     Object3D{parent},
-    SceneGraph::Drawable3D{*this, drawables},
+    SceneGraph::AbstractFeature3D{*this},
     m_bSelected{false},
-    m_idx{getUniqueID()},
-    m_Shader(shader),
-    m_Color{color},
-    m_Mesh(mesh) {
-    /* Register this object into the global list */
-    s_GeneratedObjs.push_back(this);
+    m_idx{s_Registry.add(this)},
+    m_Color{color} {
+    s_bPickGridDirty = true;
 }
 
 /****************************************************************************************************/
 PickableObject::~PickableObject() {
-    /* Remove this object from the global list */
-    for(size_t i = 0; i < s_GeneratedObjs.size(); ++i) {
-        if(s_GeneratedObjs[i] == this) {
-            s_GeneratedObjs[i] = s_GeneratedObjs.back();
-            s_GeneratedObjs.resize(s_GeneratedObjs.size() - 1);
-            break;
-        }
+    /* The selection handle goes stale with the slot generation */
+    s_Registry.remove(m_idx);
+    s_bPickGridDirty = true;
+}
+
+/****************************************************************************************************/
+void PickableObject::updateSelectedObject(uint32_t selectedIdx) {
+    if(const auto previous = selectedObj()) {
+        previous->setSelected(false);
     }
+    const auto object = fromIdx(selectedIdx);
+    if(object) {
+        object->setSelected(object->isSelectable());
+    }
+    s_SelectedObj = object ? object->handle() : Handle{};
 }
 
 /****************************************************************************************************/
-void PickableObject::draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) {
-    m_Shader.setTransformationMatrix(transformationMatrix)
-        .setNormalMatrix(transformationMatrix.normalMatrix())
-        .setProjectionMatrix(camera.projectionMatrix())
-        .setAmbientColor(m_bSelected ? m_Color * 0.3f : Color3{})
-        .setDiffuseColor(m_Color * (m_bSelected ? 2.0f : 1.0f))
-    /* relative to the camera */
-        .setLightPosition({ 13.0f, 2.0f, 5.0f })
-        .setObjectId(m_idx)
-        .draw(m_Mesh);
+PickableObject* PickableObject::create(const Color3& color, Scene3D* parent) {
+    return pool().create(color, parent);
 }
 
 /****************************************************************************************************/
-void PickableObject::updateSelectedObject(uint32_t selectedIdx) {
-    s_SelectedObj = nullptr;
-    for(size_t i = 0; i < s_GeneratedObjs.size(); ++i) {
-        s_GeneratedObjs[i]->setSelected((selectedIdx == s_GeneratedObjs[i]->idx())
-                                        && s_GeneratedObjs[i]->isSelectable());
-        if(selectedIdx == s_GeneratedObjs[i]->idx()) {
-            s_SelectedObj = s_GeneratedObjs[i];
-            break;
-        }
-    }
+void PickableObject::release(PickableObject* object) {
+    pool().destroy(object);
 }
 
 /****************************************************************************************************/
-uint32_t PickableObject::getUniqueID() {
-    static uint32_t s_nObjects = 0;
-    return ++s_nObjects;
+void PickableObject::reserve(size_t nObjects) {
+    pool().reserve(pool().size() + nObjects);
+    s_Registry.reserve(objectCount() + nObjects);
+}
+
+/****************************************************************************************************/
+size_t PickableObject::pooledCount() {
+    return pool().size();
+}
+
+/****************************************************************************************************/
+size_t PickableObject::pooledBytes() {
+    return pool().allocatedBytes();
+}
+
+/****************************************************************************************************/
+PickableObject* PickableObject::pickByRay(const Vector3& origin, const Vector3& direction) {
+    if(s_bPickGridDirty) {
+        std::vector<Vector3> centers;
+        std::vector<float>   radii;
+        s_PickGridObjs.clear();
+        s_Registry.forEach([&](PickableObject* obj) {
+                               /* Cleaning the object makes the scene graph report its next transformation change */
+                               obj->setClean();
+                               if(obj->isSelectable()) {
+                                   const auto& transformation = obj->transformation();
+                                   s_PickGridObjs.push_back(obj);
+                                   centers.push_back(transformation.translation());
+                                   radii.push_back(transformation.scaling().max());
+                               }
+                           });
+        static_assert(sizeof(Vector3) == sizeof(Core::Point3), "Vector3 and Core::Point3 layouts must match");
+        s_PickGrid.build(reinterpret_cast<const Core::Point3*>(centers.data()), radii.data(), centers.size());
+        s_bPickGridDirty = false;
+    }
+
+    const auto hit = s_PickGrid.raycast(Core::Point3{ origin.x(), origin.y(), origin.z() },
+                                        Core::Point3{ direction.x(), direction.y(), direction.z() });
+    return hit < 0 ? nullptr : s_PickGridObjs[static_cast<size_t>(hit)];
 }
@@ -17,10 +17,14 @@
 #pragma once
 
 #include <Corrade/Containers/Array.h>
-#include <Magnum/SceneGraph/Drawable.h>
+#include <Magnum/SceneGraph/AbstractFeature.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
 #include <Magnum/Math/Color.h>
-#include <Magnum/Shaders/Phong.h>
+
+#include "Core/SlotRegistry.h"
+#include "Core/SphereGrid.h"
+
+#include <vector>
 
 using namespace Corrade;
 using namespace Magnum;
@@ -28,40 +32,67 @@ using Object3D = SceneGraph::Object<SceneGraph::MatrixTransformation3D>;
 using Scene3D  = SceneGraph::Scene<SceneGraph::MatrixTransformation3D>;
 
 /****************************************************************************************************/
-class PickableObject : public Object3D, SceneGraph::Drawable3D {
+/* Sphere that can be picked and moved. Objects are not drawn by the scene graph but by an
+ * InstancedSphereRenderer, the feature only tracks transformation changes for the pick grid */
+class PickableObject : public Object3D, SceneGraph::AbstractFeature3D {
 public:
-    explicit PickableObject(Shaders::Phong& shader, const Color3& color,
-                            GL::Mesh& mesh,
-                            Scene3D* parent,
-                            SceneGraph::DrawableGroup3D* drawables);
+    explicit PickableObject(const Color3& color, Scene3D* parent);
     virtual ~PickableObject() override;
 
-    virtual void draw(const Matrix4& transformationMatrix, SceneGraph::Camera3D& camera) override;
-
     PickableObject& setSelected(bool bState) { m_bSelected = bState; return *this; }
     PickableObject& setMovable(bool bState) { m_bMovable = bState; return *this; }
     PickableObject& setColor(const Color3& color) { m_Color = color; return *this; }
-    PickableObject& setSelectable(bool bStatus) { m_bSelectable = bStatus; return *this; }
+    PickableObject& setSelectable(bool bStatus) { m_bSelectable = bStatus; s_bPickGridDirty = true; return *this; }
 
+    /* Object ID written to the object ID buffer, 0 is the background. IDs of destroyed objects are reused */
     uint32_t idx() const { return m_idx; }
+    const Color3& color() const { return m_Color; }
     bool isSelectable() const { return m_bSelectable; }
     bool isSelected() const { return m_bSelected; }
     bool isMovable() const { return m_bMovable; }
 
+    /* An ID with the generation of its slot, which no longer resolves once the object is destroyed */
+    using Handle = Core::SlotRegistry<PickableObject>::Handle;
+    Handle handle() const { return s_Registry.handle(m_idx); }
+
+    /* O(1) lookups, nullptr for the background, a free ID or a stale handle */
+    static PickableObject* fromIdx(uint32_t idx) { return s_Registry.get(idx); }
+    static PickableObject* fromHandle(const Handle& handle) { return s_Registry.get(handle); }
+    static size_t objectCount() { return s_Registry.size(); }
+
+    /* Number of objects destroyed so far, IDs read before it changed may name newer objects */
+    static uint64_t destructionCount() { return s_Registry.removalCount(); }
+
+    /* Objects drawn by an InstancedSphereRenderer, allocated from a pool in blocks. They must be released
+     * before their scene is destroyed, which would otherwise delete them */
+    static PickableObject* create(const Color3& color, Scene3D* parent);
+    static void release(PickableObject* object);
+    static void reserve(size_t nObjects); /* room for nObjects more pooled objects */
+    static size_t pooledCount();
+    static size_t pooledBytes();
+
     static void updateSelectedObject(uint32_t selectedIdx);
-    static PickableObject* selectedObj() { return s_SelectedObj; }
+    static PickableObject* selectedObj() { return fromHandle(s_SelectedObj); }
+
+    /* Nearest selectable object hit by the ray origin + t * direction (t >= 0), or nullptr. Objects are
+     * unit spheres scaled by their transformation, indexed by a Core::SphereGrid that is rebuilt after
+     * an object moved, was added or removed */
+    static PickableObject* pickByRay(const Vector3& origin, const Vector3& direction);
 
 private:
-    static uint32_t getUniqueID();
-    static inline std::vector<PickableObject*> s_GeneratedObjs;
-    static inline PickableObject*              s_SelectedObj { nullptr };
+    /* Called by the scene graph when the transformation of a clean object changes */
+    void markDirty() override { s_bPickGridDirty = true; }
+
+    /* Registry of all objects by ID */
+    static inline Core::SlotRegistry<PickableObject> s_Registry;
+    static inline Handle                             s_SelectedObj;
+    static inline Core::SphereGrid                   s_PickGrid;
+    static inline std::vector<PickableObject*>       s_PickGridObjs;
+    static inline bool                               s_bPickGridDirty { true };
 
     bool     m_bSelectable { true };
     bool     m_bSelected { false };
     bool     m_bMovable { true };
     uint32_t m_idx;
-
-    Shaders::Phong& m_Shader;
-    Color3          m_Color;
-    GL::Mesh&       m_Mesh;
+    Color3   m_Color;
 };
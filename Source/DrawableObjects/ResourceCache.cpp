@@ -0,0 +1,133 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DrawableObjects/ResourceCache.h"
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+#include <Magnum/Math/Vector3.h>
+#include <Magnum/Primitives/Icosphere.h>
+#include <Magnum/Primitives/UVSphere.h>
+#include <Magnum/Trade/MeshData.h>
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+/****************************************************************************************************/
+namespace {
+enum MeshType { Icosphere, UVSphere };
+
+/* Create a program and add the time it took to total, in milliseconds */
+template<class Program, class ... Args>
+Program* createProgram(double& total, Args&& ... args) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const auto program   = new Program{ std::forward<Args>(args)... };
+    total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return program;
+}
+}
+
+/****************************************************************************************************/
+InstancedSphereShader& ResourceCache::instancedSphereShader() {
+    auto& shader = resources().instancedSphereShader;
+    if(!shader) {
+        shader.reset(createProgram<InstancedSphereShader>(s_ProgramTime));
+        ++s_nPrograms;
+    }
+    return *shader;
+}
+
+/****************************************************************************************************/
+LineShader& ResourceCache::lineShader() {
+    auto& shader = resources().lineShader;
+    if(!shader) {
+        shader.reset(createProgram<LineShader>(s_ProgramTime));
+        ++s_nPrograms;
+    }
+    return *shader;
+}
+
+/****************************************************************************************************/
+CurveEvaluationShader& ResourceCache::curveEvaluationShader() {
+    auto& shader = resources().curveEvaluationShader;
+    if(!shader) {
+        shader.reset(createProgram<CurveEvaluationShader>(s_ProgramTime));
+        ++s_nPrograms;
+    }
+    return *shader;
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& ResourceCache::quadraticStrokeShader() {
+    auto& shader = resources().quadraticStrokeShader;
+    if(!shader) {
+        shader.reset(createProgram<QuadraticStrokeShader>(s_ProgramTime));
+        ++s_nPrograms;
+    }
+    return *shader;
+}
+
+/****************************************************************************************************/
+ResourceCache::SphereGeometry& ResourceCache::icosphere(UnsignedInt subdivisions) {
+    return sphere(Icosphere, subdivisions, 0);
+}
+
+/****************************************************************************************************/
+ResourceCache::SphereGeometry& ResourceCache::uvSphere(UnsignedInt rings, UnsignedInt segments) {
+    return sphere(UVSphere, rings, segments);
+}
+
+/****************************************************************************************************/
+void ResourceCache::release() {
+    s_Resources.reset();
+}
+
+/****************************************************************************************************/
+ResourceCache::Resources& ResourceCache::resources() {
+    if(!s_Resources) {
+        s_Resources.reset(new Resources);
+    }
+    return *s_Resources;
+}
+
+/****************************************************************************************************/
+ResourceCache::SphereGeometry& ResourceCache::sphere(int type, UnsignedInt a, UnsignedInt b) {
+    auto&      spheres = resources().spheres;
+    const auto key     = std::make_tuple(type, a, b);
+    auto       it      = spheres.find(key);
+    if(it == spheres.end()) {
+        const auto data      = type == Icosphere ? Primitives::icosphereSolid(a) : Primitives::uvSphereSolid(a, b);
+        const auto positions = data.positions3DAsArray();
+        const auto normals   = data.normalsAsArray();
+        const auto indices   = data.indicesAsArray();
+
+        /* Position and normal of each vertex, interleaved */
+        std::vector<Vector3> vertices;
+        vertices.reserve(2 * positions.size());
+        for(size_t idx = 0; idx < positions.size(); ++idx) {
+            vertices.push_back(positions[idx]);
+            vertices.push_back(normals[idx]);
+        }
+
+        it = spheres.emplace(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple()).first;
+        it->second.vertices.setData(Containers::arrayView(vertices), GL::BufferUsage::StaticDraw);
+        it->second.indices.setData(Containers::arrayView(indices), GL::BufferUsage::StaticDraw);
+        it->second.indexCount = static_cast<Int>(indices.size());
+        ++s_nSpheres;
+    }
+    return it->second;
+}
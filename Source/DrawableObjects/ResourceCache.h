@@ -0,0 +1,80 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Shaders/CurveEvaluationShader.h"
+#include "Shaders/InstancedSphereShader.h"
+#include "Shaders/LineShader.h"
+#include "Shaders/QuadraticStrokeShader.h"
+
+#include <Magnum/GL/Buffer.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <tuple>
+
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Process-wide cache of shader programs and sphere geometry. Every resource is created on first use and
+ * shared by all objects afterwards, so the number of curves does not change the number of programs to
+ * compile. release() must be called while the GL context is still alive */
+class ResourceCache {
+public:
+    /* Unit sphere with interleaved InstancedSphereShader positions and normals, and indices. Meshes
+     * referencing the buffers must not outlive release() */
+    struct SphereGeometry {
+        GL::Buffer vertices;
+        GL::Buffer indices;
+        Int        indexCount { 0 };
+    };
+
+    static InstancedSphereShader& instancedSphereShader();
+    static LineShader& lineShader();
+    static CurveEvaluationShader& curveEvaluationShader();
+    static QuadraticStrokeShader& quadraticStrokeShader();
+
+    /* Solid sphere geometry */
+    static SphereGeometry& icosphere(UnsignedInt subdivisions);
+    static SphereGeometry& uvSphere(UnsignedInt rings, UnsignedInt segments);
+
+    /* Number of programs and sphere geometries created since the start and the time spent creating the
+     * programs (in milliseconds), for startup statistics */
+    static size_t programCount() { return s_nPrograms; }
+    static size_t sphereCount() { return s_nSpheres; }
+    static double programTime() { return s_ProgramTime; }
+
+    static void release();
+
+private:
+    struct Resources {
+        std::unique_ptr<InstancedSphereShader>                              instancedSphereShader;
+        std::unique_ptr<LineShader>                                         lineShader;
+        std::unique_ptr<CurveEvaluationShader>                              curveEvaluationShader;
+        std::unique_ptr<QuadraticStrokeShader>                              quadraticStrokeShader;
+        std::map<std::tuple<int, UnsignedInt, UnsignedInt>, SphereGeometry> spheres;
+    };
+    static Resources& resources();
+    static SphereGeometry& sphere(int type, UnsignedInt a, UnsignedInt b);
+
+    static inline std::unique_ptr<Resources> s_Resources;
+    static inline size_t                     s_nPrograms { 0 };
+    static inline size_t                     s_nSpheres { 0 };
+    static inline double                     s_ProgramTime { 0.0 };
+};
@@ -0,0 +1,116 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DrawableObjects/RingBuffer.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+
+#include <algorithm>
+
+/****************************************************************************************************/
+namespace {
+/* Region sizes are multiples of this, so that region offsets are whole Vector3 vertices and 64-byte aligned */
+constexpr size_t RegionAlignment = 192;
+}
+
+/****************************************************************************************************/
+RingBuffer::RingBuffer() :
+    m_bPersistent(GL::Context::current().isExtensionSupported<GL::Extensions::ARB::buffer_storage>()) {}
+
+/****************************************************************************************************/
+RingBuffer::~RingBuffer() {
+    releaseFences(); /* a mapped buffer is unmapped when deleted */
+}
+
+/****************************************************************************************************/
+bool RingBuffer::reserve(size_t regionSize) {
+    if(regionSize <= m_RegionSize) {
+        return false;
+    }
+
+    /* The old buffer is only deleted by the driver once the GPU is done with it, its fences are not needed */
+    releaseFences();
+    regionSize   = std::max(regionSize, m_RegionSize + m_RegionSize / 2);
+    m_RegionSize = (regionSize + RegionAlignment - 1) / RegionAlignment * RegionAlignment;
+    m_Buffer     = GL::Buffer{};
+    m_Current    = 0;
+
+    const auto size = RegionCount * m_RegionSize;
+    if(m_bPersistent) {
+        m_Buffer.setStorage({ nullptr, size }, GL::Buffer::StorageFlag::MapWrite |
+                            GL::Buffer::StorageFlag::MapPersistent | GL::Buffer::StorageFlag::MapCoherent);
+        m_Mapped = m_Buffer.map(0, static_cast<GLsizeiptr>(size), GL::Buffer::MapFlag::Write |
+                                GL::Buffer::MapFlag::Persistent | GL::Buffer::MapFlag::Coherent).data();
+    } else {
+        m_Buffer.setData({ nullptr, size }, GL::BufferUsage::StreamDraw);
+    }
+    return true;
+}
+
+/****************************************************************************************************/
+char* RingBuffer::beginWrite() {
+    m_WriteRegion = (m_Current + 1) % RegionCount;
+    wait(m_WriteRegion);
+    const auto offset = m_WriteRegion * m_RegionSize;
+    if(m_bPersistent) {
+        return m_Mapped + offset;
+    }
+    return m_Buffer.map(static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(m_RegionSize),
+                        GL::Buffer::MapFlag::Write | GL::Buffer::MapFlag::Unsynchronized).data();
+}
+
+/****************************************************************************************************/
+void RingBuffer::endWrite() {
+    if(!m_bPersistent) {
+        m_Buffer.unmap();
+    }
+    m_Current = m_WriteRegion;
+}
+
+/****************************************************************************************************/
+void RingBuffer::fence() {
+    if(m_Fences[m_Current]) {
+        glDeleteSync(m_Fences[m_Current]);
+    }
+    m_Fences[m_Current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/****************************************************************************************************/
+void RingBuffer::wait(size_t region) {
+    auto& fence = m_Fences[region];
+    if(!fence) {
+        return;
+    }
+    if(glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        ++m_nStalls;
+        while(glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+/****************************************************************************************************/
+void RingBuffer::releaseFences() {
+    for(auto& fence : m_Fences) {
+        if(fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
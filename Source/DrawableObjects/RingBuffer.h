@@ -0,0 +1,79 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <Magnum/GL/Buffer.h>
+#include <Magnum/GL/OpenGL.h>
+
+#include <array>
+#include <cstddef>
+
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Vertex buffer split into RegionCount regions written in turn, so that the CPU writes one region while
+ * the GPU may still read the others.
+ *
+ * With ARB_buffer_storage (GL 4.4) the buffer is immutable and mapped once, persistently and coherently,
+ * and writers fill the mapping directly. Otherwise each write maps its region unsynchronized. In both
+ * cases a fence placed after the draws reading a region is waited on before the region is written
+ * again, which only blocks when the GPU is more than RegionCount - 1 uploads behind.
+ */
+class RingBuffer {
+public:
+    static constexpr size_t RegionCount = 3;
+
+    RingBuffer();
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /* Grow the regions to hold at least regionSize bytes. Growing replaces the buffer object, returns
+     * true if it did (meshes using buffer() must add it again) */
+    bool reserve(size_t regionSize);
+
+    /* Write the region following the current one, which becomes current at endWrite() */
+    char* beginWrite();
+    void endWrite();
+    size_t writeRegion() const { return m_WriteRegion; }
+
+    /* Place the fence of the current region, after the draws reading it */
+    void fence();
+
+    GL::Buffer& buffer() { return m_Buffer; }
+    size_t currentOffset() const { return m_Current * m_RegionSize; }
+    bool persistent() const { return m_bPersistent; }
+
+    /* Number of writes that had to wait for the GPU */
+    size_t stallCount() const { return m_nStalls; }
+
+private:
+    void wait(size_t region);
+    void releaseFences();
+
+    GL::Buffer                         m_Buffer;
+    const bool                         m_bPersistent;
+    char*                              m_Mapped { nullptr };
+    size_t                             m_RegionSize { 0 };
+    size_t                             m_Current { 0 };
+    size_t                             m_WriteRegion { 0 };
+    std::array<GLsync, RegionCount>    m_Fences {};
+    size_t                             m_nStalls { 0 };
+};
@@ -0,0 +1,323 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Headless/HeadlessRenderer.h"
+#include "DrawableObjects/ResourceCache.h"
+#include "QuadraticCurveApproximation.h"
+
+#include <Corrade/Containers/ArrayView.h>
+#include <Corrade/Utility/Assert.h>
+#include <Magnum/Image.h>
+#include <Magnum/PixelFormat.h>
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Renderer.h>
+#include <Magnum/GL/RenderbufferFormat.h>
+#include <Magnum/GL/TimeQuery.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Functions.h>
+#include <Magnum/Math/Matrix4.h>
+#include <Magnum/SceneGraph/Camera.h>
+#include <Magnum/SceneGraph/Scene.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+/****************************************************************************************************/
+using Object3D = SceneGraph::Object<SceneGraph::MatrixTransformation3D>;
+using namespace Magnum::Math::Literals;
+
+namespace {
+void printUsage() {
+    std::fprintf(stderr,
+                 "Usage: QuadraticApproximationHeadless [options] [input...]\n"
+                 "Renders curve sets (points.txt format or binary curve file, points.bin / points.txt if no\n"
+                 "input is given) without a window and writes them as images.\n"
+                 "\n"
+                 "  -o, --output FILE       output image of a single input, .png or .ppm (default:\n"
+                 "                          <input name>.png in the output directory)\n"
+                 "  -d, --output-dir DIR    output directory of the images (default: .)\n"
+                 "  -f, --format FORMAT     image format in the output directory: png or ppm (default: png)\n"
+                 "  -s, --size WxH          image size in pixels (default: 512x512)\n"
+                 "  -m, --samples N         multisampling samples per pixel, 1 disables (default: 4)\n"
+                 "  -n, --segments N        segments per Bezier curve (default: 128)\n"
+                 "  -q, --quadratics        also render the quadratic approximation\n"
+                 "  -b, --benchmark N       redraw every input N times and print the time per frame\n"
+                 "  -h, --help              show this help\n"
+                 "\n"
+                 "Options of the GL context (--magnum-device, --magnum-log, ...) are passed through.\n");
+}
+
+bool parseInt(const char* text, long lo, long hi, long& value) {
+    char* end;
+    value = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && value >= lo && value <= hi;
+}
+
+/* File name without directories and extension */
+std::string baseName(const std::string& path) {
+    const auto slash = path.find_last_of("/\\");
+    auto       name  = slash == std::string::npos ? path : path.substr(slash + 1);
+    const auto dot   = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+}
+
+/****************************************************************************************************/
+HeadlessRenderer::HeadlessRenderer(const Arguments& arguments) :
+    Platform::WindowlessEglApplication{arguments} {
+    /* The context options were consumed by the context, all of them take a value */
+    for(int i = 1; i < arguments.argc; ++i) {
+        const std::string arg = arguments.argv[i];
+        if(arg.compare(0, 9, "--magnum-") == 0) {
+            i += arg.find('=') == std::string::npos ? 1 : 0;
+            continue;
+        }
+        m_Arguments.push_back(arg);
+    }
+}
+
+/****************************************************************************************************/
+bool HeadlessRenderer::parseArguments(bool& bHelp) {
+    auto& options    = m_Options;
+    bool  bFormatSet = false;
+    for(size_t i = 0; i < m_Arguments.size(); ++i) {
+        const std::string& arg  = m_Arguments[i];
+        auto               next = [&]() -> const char* {
+                                      return i + 1 < m_Arguments.size() ? m_Arguments[++i].c_str() : nullptr;
+                                  };
+        long               value;
+        if(arg == "-h" || arg == "--help") {
+            bHelp = true;
+        } else if(arg == "-q" || arg == "--quadratics") {
+            options.bQuadratics = true;
+        } else if(arg == "-o" || arg == "--output") {
+            const auto file = next();
+            if(!file) { return false; }
+            options.outputFile = file;
+        } else if(arg == "-d" || arg == "--output-dir") {
+            const auto dir = next();
+            if(!dir) { return false; }
+            options.outputDir = dir;
+        } else if(arg == "-f" || arg == "--format") {
+            const auto format = next();
+            if(!format || !Core::imageFormatFromPath(std::string(".") + format, options.format)) {
+                std::fprintf(stderr, "Unknown format: %s\n", format ? format : "");
+                return false;
+            }
+            bFormatSet = true;
+        } else if(arg == "-s" || arg == "--size") {
+            const auto size = next();
+            int        width, height;
+            char       trailing;
+            if(!size || std::sscanf(size, "%dx%d%c", &width, &height, &trailing) != 2 ||
+               width <= 0 || height <= 0 || width > 16384 || height > 16384) {
+                std::fprintf(stderr, "Invalid size, expected WxH\n");
+                return false;
+            }
+            options.size = Vector2i{ width, height };
+        } else if(arg == "-m" || arg == "--samples") {
+            const auto samples = next();
+            if(!samples || !parseInt(samples, 1, 64, value)) {
+                std::fprintf(stderr, "Invalid sample count\n");
+                return false;
+            }
+            options.nSamples = static_cast<Int>(value);
+        } else if(arg == "-n" || arg == "--segments") {
+            const auto segments = next();
+            if(!segments || !parseInt(segments, 1, 1024, value)) {
+                std::fprintf(stderr, "Invalid segment count\n");
+                return false;
+            }
+            options.subdivision = static_cast<Int>(value);
+        } else if(arg == "-b" || arg == "--benchmark") {
+            const auto frames = next();
+            if(!frames || !parseInt(frames, 1, std::numeric_limits<int>::max(), value)) {
+                std::fprintf(stderr, "Invalid frame count\n");
+                return false;
+            }
+            options.nBenchmarkFrames = static_cast<size_t>(value);
+        } else if(arg.size() > 1 && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            return false;
+        } else {
+            options.inputFiles.push_back(arg);
+        }
+    }
+
+    if(!options.outputFile.empty()) {
+        if(options.inputFiles.size() > 1 || !options.outputDir.empty()) {
+            std::fprintf(stderr, "--output takes a single input, use --output-dir for several\n");
+            return false;
+        }
+        const auto formatFlag = options.format;
+        if(!Core::imageFormatFromPath(options.outputFile, options.format) ||
+           (bFormatSet && options.format != formatFlag)) {
+            std::fprintf(stderr, "Output file must end in .png or .ppm, matching --format if given\n");
+            return false;
+        }
+    }
+    return true;
+}
+
+/****************************************************************************************************/
+int HeadlessRenderer::exec() {
+    bool bHelp = false;
+    if(!parseArguments(bHelp) || bHelp) {
+        printUsage();
+        return bHelp ? 0 : 2;
+    }
+    if(!GL::Context::current().isVersionSupported(GL::Version::GL330)) {
+        std::fprintf(stderr, "OpenGL 3.3 is required, the context has %s\n",
+                     GL::Context::current().versionString().c_str());
+        return 1;
+    }
+
+    GL::Renderer::enable(GL::Renderer::Feature::DepthTest);
+    setupFramebuffers();
+
+    /* An empty input name loads points.bin / points.txt */
+    auto inputFiles = m_Options.inputFiles;
+    if(inputFiles.empty()) {
+        inputFiles.emplace_back();
+    }
+    int status = 0;
+    for(const auto& inputFile : inputFiles) {
+        if(!render(inputFile, outputPath(inputFile))) {
+            status = 1;
+        }
+    }
+
+    /* The shared GL resources must go before the context */
+    ResourceCache::release();
+    return status;
+}
+
+/****************************************************************************************************/
+void HeadlessRenderer::setupFramebuffers() {
+    const auto size = m_Options.size;
+    m_RBColor = GL::Renderbuffer{};
+    m_RBDepth = GL::Renderbuffer{};
+    if(m_Options.nSamples > 1) {
+        m_RBColor.setStorageMultisample(m_Options.nSamples, GL::RenderbufferFormat::RGBA8, size);
+        m_RBDepth.setStorageMultisample(m_Options.nSamples, GL::RenderbufferFormat::DepthComponent24, size);
+    } else {
+        m_RBColor.setStorage(GL::RenderbufferFormat::RGBA8, size);
+        m_RBDepth.setStorage(GL::RenderbufferFormat::DepthComponent24, size);
+    }
+    m_FrameBuffer = GL::Framebuffer{ { {}, size } };
+    m_FrameBuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{ 0 }, m_RBColor)
+        .attachRenderbuffer(GL::Framebuffer::BufferAttachment::Depth, m_RBDepth);
+    CORRADE_INTERNAL_ASSERT(m_FrameBuffer.checkStatus(GL::FramebufferTarget::Draw) == GL::Framebuffer::Status::Complete);
+
+    /* Multisampled renderbuffers cannot be read, they are resolved by a blit */
+    m_RBResolvedColor = GL::Renderbuffer{};
+    m_RBResolvedColor.setStorage(GL::RenderbufferFormat::RGBA8, size);
+    m_ResolveFrameBuffer = GL::Framebuffer{ { {}, size } };
+    m_ResolveFrameBuffer.attachRenderbuffer(GL::Framebuffer::ColorAttachment{ 0 }, m_RBResolvedColor);
+    CORRADE_INTERNAL_ASSERT(m_ResolveFrameBuffer.checkStatus(GL::FramebufferTarget::Draw) == GL::Framebuffer::Status::Complete);
+}
+
+/****************************************************************************************************/
+std::string HeadlessRenderer::outputPath(const std::string& inputFile) const {
+    if(!m_Options.outputFile.empty()) {
+        return m_Options.outputFile;
+    }
+    const auto name = inputFile.empty() ? std::string("curves") : baseName(inputFile);
+    const auto dir  = m_Options.outputDir.empty() ? std::string(".") : m_Options.outputDir;
+    return dir + "/" + name + (m_Options.format == Core::ImageFormat::Png ? ".png" : ".ppm");
+}
+
+/****************************************************************************************************/
+bool HeadlessRenderer::render(const std::string& inputFile, const std::string& outputFile) {
+    /* The curves release their pooled drawables before the scene is destroyed, and the camera object
+     * removes itself from the scene */
+    Scene3D              scene;
+    Object3D             cameraObject{ &scene };
+    SceneGraph::Camera3D camera{ cameraObject };
+    Containers::Pointer<QuadraticCurveApproximation> curves;
+
+    curves.emplace(&scene, inputFile);
+    if(!curves->loadError().empty()) {
+        std::fprintf(stderr, "%s\n", curves->loadError().c_str());
+        return false;
+    }
+    curves->subdivision()               = m_Options.subdivision;
+    curves->quadC1BezierConfig.bEnabled = m_Options.bQuadratics;
+    curves->updateCurveConfigs();
+    curves->computeCurves();
+
+    /* Fit the bounding sphere of the data points into the view, looking down -z as the viewer does */
+    const auto& points = curves->dataPoints();
+    Vector3     lower{ std::numeric_limits<float>::max() }, upper{ -std::numeric_limits<float>::max() };
+    for(const auto& point : points) {
+        lower = Math::min(lower, point);
+        upper = Math::max(upper, point);
+    }
+    const Vector3 center   = points.empty() ? Vector3{} : (lower + upper) * 0.5f;
+    const float   radius   = points.empty() ? 1.0f : std::max((upper - lower).length() * 0.5f, 1.0e-3f);
+    const auto    fov      = 45.0_degf;
+    const float   aspect   = Vector2{ m_Options.size }.aspectRatio();
+    const float   distance = 1.05f * radius / Math::sin(fov * 0.5f) / std::min(aspect, 1.0f);
+    cameraObject.setTransformation(Matrix4::lookAt(center + Vector3::zAxis(distance), center, Vector3::yAxis()));
+    cameraObject.setClean();
+    camera.setProjectionMatrix(Matrix4::perspectiveProjection(fov, aspect, 0.01f * distance, distance + 2.0f * radius))
+        .setViewport(m_Options.size);
+
+    auto drawFrame = [&] {
+                         m_FrameBuffer
+                             .clearColor(0, m_BkgColor)
+                             .clearDepth(1.0f)
+                             .bind();
+                         curves->draw(camera, m_Options.size);
+                     };
+    drawFrame();
+    GL::AbstractFramebuffer::blit(m_FrameBuffer, m_ResolveFrameBuffer, { {}, m_Options.size }, GL::FramebufferBlit::Color);
+    m_ResolveFrameBuffer.mapForRead(GL::Framebuffer::ColorAttachment{ 0 });
+    const Image2D image = m_ResolveFrameBuffer.read({ {}, m_Options.size }, { PixelFormat::RGBA8Unorm });
+
+    std::string error;
+    const auto  pixels = Containers::arrayCast<const UnsignedByte>(image.data());
+    if(!Core::writeImage(outputFile, m_Options.format, pixels.data(), static_cast<size_t>(m_Options.size.x()),
+                         static_cast<size_t>(m_Options.size.y()), 4, true, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+
+    if(m_Options.nBenchmarkFrames > 0) {
+        const auto    nFrames = m_Options.nBenchmarkFrames;
+        GL::TimeQuery query{ GL::TimeQuery::Target::TimeElapsed };
+        const auto    start = std::chrono::steady_clock::now();
+        query.begin();
+        for(size_t frame = 0; frame < nFrames; ++frame) {
+            drawFrame();
+        }
+        query.end();
+        GL::Renderer::finish();
+        const double wallTime  = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() /
+                                 static_cast<double>(nFrames);
+        const double gpuTime   = static_cast<double>(query.result<UnsignedLong>()) * 1.0e-6 / static_cast<double>(nFrames);
+        const auto   nVertices = curves->tessellatedPointCount();
+        const auto   name      = inputFile.empty() ? std::string("points.bin / points.txt") : inputFile;
+        std::printf("%s: %zu frames, GPU %.3f ms, wall %.3f ms per frame, %zu vertices, %.1f Mvertices/s\n",
+                    name.c_str(), nFrames, gpuTime, wallTime, nVertices,
+                    static_cast<double>(nVertices) * 1.0e-3 / wallTime);
+    }
+    return true;
+}
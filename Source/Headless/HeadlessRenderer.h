@@ -0,0 +1,82 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <Corrade/Containers/Pointer.h>
+#include <Magnum/GL/Framebuffer.h>
+#include <Magnum/GL/Renderbuffer.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Platform/WindowlessEglApplication.h>
+
+#include "Core/ImageFile.h"
+
+#include <string>
+#include <vector>
+
+/****************************************************************************************************/
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Renders curve sets without a window, on an EGL context without surface (Mesa llvmpipe works on
+ * machines without GPU or display), and writes them as PNG or PPM images.
+ * Usage: QuadraticApproximationHeadless [options] [input...], see --help.
+ *
+ * Every input is loaded as the viewer loads points.bin / points.txt, and drawn by the same
+ * QuadraticCurveApproximation and LineShader with the camera fitted to its data points. With
+ * --benchmark, the drawing is repeated and its GPU and CPU time per frame printed.
+ */
+class HeadlessRenderer : public Platform::WindowlessEglApplication {
+public:
+    explicit HeadlessRenderer(const Arguments& arguments);
+    int exec() override;
+
+private:
+    struct Options {
+        std::vector<std::string> inputFiles;
+        std::string              outputFile;
+        std::string              outputDir;
+        Core::ImageFormat        format { Core::ImageFormat::Png };
+        Vector2i                 size { 512, 512 };
+        Int                      nSamples { 4 };
+        Int                      subdivision { 128 };
+        bool                     bQuadratics { false };
+        size_t                   nBenchmarkFrames { 0 };
+    };
+
+    bool parseArguments(bool& bHelp);
+    void setupFramebuffers();
+    std::string outputPath(const std::string& inputFile) const;
+
+    /* Returns false if the input cannot be loaded or the image cannot be written */
+    bool render(const std::string& inputFile, const std::string& outputFile);
+
+    std::vector<std::string> m_Arguments;
+    Options                  m_Options;
+    Color3                   m_BkgColor { 0.35f };
+
+    /* Multisampled framebuffer drawn into, and its resolved copy read back */
+    GL::Framebuffer  m_FrameBuffer { NoCreate };
+    GL::Renderbuffer m_RBColor { NoCreate };
+    GL::Renderbuffer m_RBDepth { NoCreate };
+    GL::Framebuffer  m_ResolveFrameBuffer { NoCreate };
+    GL::Renderbuffer m_RBResolvedColor { NoCreate };
+};
+
+/****************************************************************************************************/
+MAGNUM_WINDOWLESSEGLAPPLICATION_MAIN(HeadlessRenderer)
@@ -15,30 +15,58 @@
  */
 
 #include <Corrade/Utility/Assert.h>
+#include <Magnum/GL/TimeQuery.h>
 #include <Magnum/Math/Color.h>
-#include <Magnum/MeshTools/Compile.h>
-#include <Magnum/Trade/MeshData.h>
 #include <Magnum/SceneGraph/Scene.h>
 #include <Magnum/SceneGraph/Camera.h>
 #include <Magnum/SceneGraph/Drawable.h>
-#include <Magnum/Primitives/Grid.h>
-#include <Magnum/Primitives/UVSphere.h>
 
 #include "DrawableObjects/PickableObject.h"
 #include "DrawableObjects/FlatShadeObject.h"
+#include "DrawableObjects/ResourceCache.h"
+#include "DrawableObjects/Curves/BatchedCurveRenderer.h"
+#include "DrawableObjects/InstancedSphereRenderer.h"
 #include "DrawableObjects/Curves/Polyline.h"
 #include "DrawableObjects/Curves/CubicBezier.h"
 #include "DrawableObjects/Curves/QuadraticApproximatingCubic.h"
+#include "Core/CurveBatch.h"
+#include "Core/CurveFile.h"
+#include "Core/GammaSolver.h"
+#include "Core/PointIO.h"
+#include "Core/ThreadPool.h"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 
 #include "QuadraticCurveApproximation.h"
 
 /****************************************************************************************************/
-QuadraticCurveApproximation::QuadraticCurveApproximation(Scene3D* const                     scene,
-                                                         SceneGraph::DrawableGroup3D* const drawables) :
-    m_Scene(scene), m_Drawables(drawables) {
+/* Magnum::Vector3 and Core::Point3 are both three packed floats */
+static_assert(sizeof(Vector3) == sizeof(Core::Point3), "Vector3 and Core::Point3 layouts must match");
+static Core::Point3* toCorePoints(Vector3* points) { return reinterpret_cast<Core::Point3*>(points); }
+static const Core::Point3* toCorePoints(const Vector3* points) { return reinterpret_cast<const Core::Point3*>(points); }
+
+/* Tessellate the curves on the thread pool, then mark their vertices for upload by the batched renderers */
+template<class Curves>
+static void recomputeCurves(Curves& curves) {
+    Core::threadPool()->parallelFor(0, curves.size(), 1, [&](size_t begin, size_t end) {
+                                        for(size_t idx = begin; idx < end; ++idx) {
+                                            curves[idx]->computePoints();
+                                        }
+                                    });
+    for(auto& curve : curves) {
+        curve->invalidateBuffer();
+    }
+}
+
+/****************************************************************************************************/
+QuadraticCurveApproximation::QuadraticCurveApproximation(Scene3D* const scene, const std::string& pointsFile) :
+    m_Scene(scene),
+    m_PointsFile(pointsFile),
+    m_DataPointRenderer(ResourceCache::uvSphere(8, 16)),
+    m_CubicBezierControlPointRenderer(ResourceCache::icosphere(3)),
+    m_QuadraticC1ControlPointRenderer(ResourceCache::icosphere(3)) {
     /* Curves config */
     cubicBezierConfig.color     = Color3{ 0.0f, 0.0f, 1.0f };
     cubicBezierConfig.thickness = 10.0f;
@@ -48,26 +76,60 @@ QuadraticCurveApproximation::QuadraticCurveApproximation(Scene3D* const
     quadC1BezierConfig.thickness = 5.0f;
     quadC1BezierConfig.bEnabled  = false; /* disable by default */
 
-    m_Polylines = new Polyline(m_Scene, Color3{ 1.0f, 1.0f, 0.0f });
-
-    /* Variable for pickable control points */
-    m_MeshSphere = MeshTools::compile(Primitives::uvSphereSolid(8, 16));
+    m_Polylines.emplace(m_Scene, Color3{ 1.0f, 1.0f, 0.0f });
+    m_PolylineRenderer.setCurves(std::vector<Curve*>{ m_Polylines.get() });
 
     /* Update drawable control points and generate curve data */
     loadControlPoints();
 }
 
+/****************************************************************************************************/
+QuadraticCurveApproximation::~QuadraticCurveApproximation() {
+    /* Pooled drawables are children of the scene, which would delete them: they are released before it is
+     * destroyed, the curves release theirs with the curve pools */
+    for(const auto point : m_DrawablePoints) {
+        PickableObject::release(point);
+    }
+}
+
 /****************************************************************************************************/
 QuadraticCurveApproximation& QuadraticCurveApproximation::draw(SceneGraph::Camera3D& camera,
                                                                const Vector2i&       viewport) {
-    auto drawCurves = [&](auto& curves) {
-                          for(auto& curve: curves) {
-                              curve->draw(camera, viewport);
-                          }
-                      };
-    m_Polylines->draw(camera, viewport);
-    drawCurves(m_CubicBezierCurves);
-    drawCurves(m_QuadraticC1Curves);
+    /* One multi-draw (or instanced draw) per curve style, then one instanced draw of the control points of the styles showing them */
+    const auto transformPrjMat = camera.projectionMatrix() * camera.cameraMatrix();
+    auto       drawCurves      = [&](BatchedCurveRenderer& renderer, GpuCurveRenderer& gpuRenderer,
+                                     InstancedSphereRenderer& controlPointRenderer, int segments,
+                                     bool bAnalytic, auto& curves, const CurveConfig& config) {
+                                     if(!config.bEnabled) {
+                                         return;
+                                     }
+                                     if(bAnalytic) {
+                                         gpuRenderer.drawStrokes(ResourceCache::quadraticStrokeShader(), transformPrjMat,
+                                                                 viewport, config.color, config.thickness);
+                                     } else if(gpuEvaluated()) {
+                                         gpuRenderer.draw(ResourceCache::curveEvaluationShader(), transformPrjMat, viewport,
+                                                          config.color, config.thickness, segments);
+                                     } else {
+                                         renderer.draw(ResourceCache::lineShader(), transformPrjMat, viewport, config.color, config.thickness,
+                                                       config.miterLimit);
+                                     }
+                                     if(config.bRenderControlPoints) {
+                                         controlPointRenderer.clear();
+                                         for(auto& curve: curves) {
+                                             if(curve->enabled() && curve->renderControlPoints()) {
+                                                 controlPointRenderer.addObjects(curve->drawablePoints());
+                                             }
+                                         }
+                                         controlPointRenderer.draw(camera);
+                                     }
+                                 };
+    m_PolylineRenderer.draw(ResourceCache::lineShader(), transformPrjMat, viewport, m_Polylines->color(), m_Polylines->thickness(),
+                            m_Polylines->miterLimit());
+    drawCurves(m_CubicBezierRenderer, m_CubicBezierGpuRenderer, m_CubicBezierControlPointRenderer,
+               std::max(1, m_Subdivision), false, m_CubicBezierCurves, cubicBezierConfig);
+    drawCurves(m_QuadraticC1Renderer, m_QuadraticC1GpuRenderer, m_QuadraticC1ControlPointRenderer,
+               std::max(1, m_Subdivision >> 1), m_bAnalyticQuadratics, m_QuadraticC1Curves, quadC1BezierConfig);
+    m_DataPointRenderer.clear().addObjects(m_DrawablePoints).draw(camera);
     return *this;
 }
 
@@ -77,6 +139,7 @@ void QuadraticCurveApproximation::updateCurveConfigs() {
                       for(auto& curve :curves) {
                           curve->color()               = config.color;
                           curve->thickness()           = config.thickness;
+                          curve->miterLimit()          = config.miterLimit;
                           curve->controlPointRadius()  = config.controlPointRadius;
                           curve->renderControlPoints() = config.bRenderControlPoints;
                           curve->enabled()             = config.bEnabled;
@@ -118,25 +181,39 @@ void QuadraticCurveApproximation::generateCurves() {
     const auto nCurrentCurves = m_CubicBezierCurves.size();
     const auto nCurves        = m_BezierControlPoints.size() / 4;
 
+    /* Allocate the new curves and the drawables of their control points in bulk */
+    if(nCurves > nCurrentCurves) {
+        m_CubicBezierPool.reserve(nCurves);
+        m_QuadraticC1Pool.reserve(nCurves);
+        PickableObject::reserve((nCurves - nCurrentCurves) * (4 + 5));
+        m_CubicBezierCurves.reserve(nCurves);
+        m_QuadraticC1Curves.reserve(nCurves);
+    }
     for(size_t i = nCurrentCurves; i < nCurves; ++i) {
-        m_CubicBezierCurves.push_back(new CubicBezier(m_Scene, m_Subdivision,
-                                                      cubicBezierConfig.color,
-                                                      cubicBezierConfig.thickness,
-                                                      cubicBezierConfig.bRenderControlPoints,
-                                                      false,
-                                                      cubicBezierConfig.controlPointRadius));
-        m_QuadraticC1Curves.push_back(new QuadraticApproximatingCubic(m_Scene, m_Subdivision >> 1,
-                                                                      quadC1BezierConfig.color,
-                                                                      quadC1BezierConfig.thickness,
-                                                                      quadC1BezierConfig.bRenderControlPoints,
-                                                                      false,
-                                                                      quadC1BezierConfig.controlPointRadius));
+        m_CubicBezierCurves.push_back(m_CubicBezierPool.create(m_Scene, m_Subdivision,
+                                                               cubicBezierConfig.color,
+                                                               cubicBezierConfig.thickness,
+                                                               cubicBezierConfig.bRenderControlPoints,
+                                                               false,
+                                                               cubicBezierConfig.controlPointRadius));
+        m_QuadraticC1Curves.push_back(m_QuadraticC1Pool.create(m_Scene, m_Subdivision >> 1,
+                                                               quadC1BezierConfig.color,
+                                                               quadC1BezierConfig.thickness,
+                                                               quadC1BezierConfig.bRenderControlPoints,
+                                                               false,
+                                                               quadC1BezierConfig.controlPointRadius));
         m_QuadraticC1Curves.back()->enabled() = quadC1BezierConfig.bEnabled;
     }
 
-    /* Reduce number of curves, if applicable */
+    /* Reduce number of curves, if applicable, their slots are reused by the next curves */
+    for(size_t i = nCurves; i < nCurrentCurves; ++i) {
+        m_CubicBezierPool.destroy(m_CubicBezierCurves[i]);
+        m_QuadraticC1Pool.destroy(m_QuadraticC1Curves[i]);
+    }
     m_CubicBezierCurves.resize(nCurves);
     m_QuadraticC1Curves.resize(nCurves);
+    m_CubicBezierRenderer.setCurves(m_CubicBezierCurves);
+    m_QuadraticC1Renderer.setCurves(m_QuadraticC1Curves);
 
     /* Update polyline and quadratic curves */
     updatePolylines();
@@ -153,17 +230,20 @@ void QuadraticCurveApproximation::updatePolylines() {
 
 /****************************************************************************************************/
 void QuadraticCurveApproximation::updateDrawablePoints() {
+    /* Surplus drawables go back to the pool, their IDs may be reused by other objects */
     size_t oldSize = m_DrawablePoints.size();
+    for(size_t i = m_DataPoints.size(); i < oldSize; ++i) {
+        m_mDrawableIdxToPointIdx.erase(m_DrawablePoints[i]->idx());
+        PickableObject::release(m_DrawablePoints[i]);
+    }
     m_DrawablePoints.resize(m_DataPoints.size());
+    if(m_DataPoints.size() > oldSize) {
+        PickableObject::reserve(m_DataPoints.size() - oldSize);
+    }
 
     for(size_t i = oldSize; i < m_DataPoints.size(); ++i) {
         auto& newPoint = m_DrawablePoints[i];
-        newPoint = new PickableObject(m_SphereShader,
-                                      cubicBezierConfig.color,
-                                      m_MeshSphere,
-                                      m_Scene,
-                                      m_Drawables);
-        newPoint->setColor(cubicBezierConfig.color);
+        newPoint = PickableObject::create(cubicBezierConfig.color, m_Scene);
         m_mDrawableIdxToPointIdx[newPoint->idx()] = i;
     }
 
@@ -179,121 +259,438 @@ void QuadraticCurveApproximation::updateCurveControlPoints() {
         return;
     }
 
+    /* Choose gamma of each curve */
     const auto nCurves = m_BezierControlPoints.size() / 4;
+    const auto mode    = static_cast<GammaMode>(m_GammaMode);
+    m_CurveGammas.resize(nCurves);
+    if(mode == GammaMode::Global) {
+        std::fill(m_CurveGammas.begin(), m_CurveGammas.end(), m_gamma);
+    } else {
+        Core::optimalGammas(toCorePoints(m_BezierControlPoints.data()), nCurves,
+                            mode == GammaMode::OptimalL2 ? Core::GammaObjective::L2 : Core::GammaObjective::MaxDistance,
+                            m_CurveGammas.data());
+    }
+
+    /* Compute control points of the quadratic C1 curves for all curves at once */
+    m_QuadraticControlPoints.resize(nCurves * 5);
+    Core::convertCubicsToQuadratics(toCorePoints(m_BezierControlPoints.data()), nCurves, m_CurveGammas.data(),
+                                    toCorePoints(m_QuadraticControlPoints.data()));
+
+    /* Or split the cubics into chains of quadratic pairs meeting the tolerance, with the global gamma */
+    if(m_bToleranceDrivenQuadratics) {
+        Core::approximateCubicsWithQuadratics(toCorePoints(m_BezierControlPoints.data()), nCurves,
+                                              m_QuadraticTolerance, m_QuadraticChains, m_gamma);
+    }
 
     for(size_t idx = 0; idx < nCurves; ++idx) {
-        VPoints B = {
-            m_BezierControlPoints[idx * 4],
-            m_BezierControlPoints[idx * 4 + 1],
-            m_BezierControlPoints[idx * 4 + 2],
-            m_BezierControlPoints[idx * 4 + 3]
-        };
-        m_CubicBezierCurves[idx]->setControlPoints(B);
-
-        /* Compute control points of the quadratic C1 curves */
-        VPoints Q(5);
-        Q[0] = B[0];
-        Q[4] = B[3];
-        Q[1] = B[0] + 1.5f * m_gamma * (B[1] - B[0]);
-        Q[3] = B[3] - 1.5f * (1.0f - m_gamma) * (B[3] - B[2]);
-        Q[2] = (1.0f - m_gamma) * Q[1] + m_gamma * Q[3];
-        m_QuadraticC1Curves[idx]->setControlPoints(Q);
+        setCurveControlPoints(idx);
+    }
+    if(usesGpuControlPoints()) {
+        uploadGpuControlPoints();
+    } else {
+        m_bGpuControlPointsUploaded = false;
+    }
+    if(!gpuEvaluated()) {
+        recomputeCurves(m_CubicBezierCurves);
+        recomputeCurves(m_QuadraticC1Curves);
+    }
+    updateErrors();
+}
+
+/****************************************************************************************************/
+void QuadraticCurveApproximation::setCurveControlPoints(size_t idx) {
+    const auto B = m_BezierControlPoints.begin() + idx * 4;
+    m_CubicBezierCurves[idx]->setControlPoints(VPoints(B, B + 4), false);
+
+    if(m_bToleranceDrivenQuadratics) {
+        const auto chain = reinterpret_cast<const Vector3*>(m_QuadraticChains.points.data());
+        m_QuadraticC1Curves[idx]->gamma() = m_gamma;
+        m_QuadraticC1Curves[idx]->setControlPoints(VPoints(chain + m_QuadraticChains.offsets[idx],
+                                                           chain + m_QuadraticChains.offsets[idx + 1]), false);
+    } else {
+        const auto Q = m_QuadraticControlPoints.begin() + idx * 5;
+        m_QuadraticC1Curves[idx]->gamma() = m_CurveGammas[idx];
+        m_QuadraticC1Curves[idx]->setControlPoints(VPoints(Q, Q + 5), false);
+    }
+}
+
+/****************************************************************************************************/
+void QuadraticCurveApproximation::moveDataPoint(uint32_t selectedIdx, const Vector3& point) {
+    const auto it = m_mDrawableIdxToPointIdx.find(selectedIdx);
+    CORRADE_INTERNAL_ASSERT(it != m_mDrawableIdxToPointIdx.end()
+                            && it->second < m_DataPoints.size());
+    const auto pointIdx = it->second;
+    m_DataPoints[pointIdx] = point;
+
+    /* A data point is a control point of one cubic, or belongs to the windows of up to 4 Catmull-Rom segments */
+    size_t firstCurve, lastCurve;
+    if(m_bBezierFromCatmullRom) {
+        const auto nCurves = Core::catmullRomCurveCount(m_DataPoints.size());
+        firstCurve = pointIdx >= 3 ? pointIdx - 3 : 0;
+        lastCurve  = std::min(pointIdx + 1, nCurves);
+        if(firstCurve >= lastCurve) {
+            return;
+        }
+        Core::catmullRomToCubics(toCorePoints(&m_DataPoints[firstCurve]), lastCurve - firstCurve + 3, m_CatmullRom_Alpha,
+                                 toCorePoints(&m_BezierControlPoints[firstCurve * 4]));
+        m_Polylines->updateControlPoints(firstCurve * 4, &m_BezierControlPoints[firstCurve * 4],
+                                         (lastCurve - firstCurve) * 4);
+    } else {
+        m_BezierControlPoints[pointIdx] = point;
+        m_Polylines->updateControlPoints(pointIdx, &m_BezierControlPoints[pointIdx], 1);
+        firstCurve = pointIdx / 4;
+        lastCurve  = std::min(firstCurve + 1, m_BezierControlPoints.size() / 4);
+    }
+    updateCurveRange(firstCurve, lastCurve);
+}
+
+/****************************************************************************************************/
+void QuadraticCurveApproximation::updateCurveRange(size_t firstCurve, size_t lastCurve) {
+    if(firstCurve >= lastCurve) {
+        return;
+    }
+    const auto nCurves = lastCurve - firstCurve;
+    const auto B       = toCorePoints(&m_BezierControlPoints[firstCurve * 4]);
+    const auto mode    = static_cast<GammaMode>(m_GammaMode);
+    if(mode == GammaMode::Global) {
+        std::fill_n(&m_CurveGammas[firstCurve], nCurves, m_gamma);
+    } else {
+        Core::optimalGammas(B, nCurves,
+                            mode == GammaMode::OptimalL2 ? Core::GammaObjective::L2 : Core::GammaObjective::MaxDistance,
+                            &m_CurveGammas[firstCurve]);
+    }
+    const auto Q = toCorePoints(&m_QuadraticControlPoints[firstCurve * 5]);
+    Core::convertCubicsToQuadratics(B, nCurves, &m_CurveGammas[firstCurve], Q);
+
+    /* Splice the new chains of the range in, the following curves only move if the piece counts changed */
+    bool bChainsResized = false;
+    if(m_bToleranceDrivenQuadratics) {
+        Core::approximateCubicsWithQuadratics(B, nCurves, m_QuadraticTolerance, m_EditedChains, m_gamma);
+        auto&      chains   = m_QuadraticChains;
+        const auto begin    = chains.offsets[firstCurve];
+        const auto oldCount = chains.offsets[lastCurve] - begin;
+        const auto newCount = m_EditedChains.points.size();
+        const auto position = chains.points.begin() + static_cast<std::ptrdiff_t>(begin);
+        if(newCount > oldCount) {
+            chains.points.insert(position + static_cast<std::ptrdiff_t>(oldCount), newCount - oldCount, Core::Point3{});
+        } else if(newCount < oldCount) {
+            chains.points.erase(position + static_cast<std::ptrdiff_t>(newCount),
+                                position + static_cast<std::ptrdiff_t>(oldCount));
+        }
+        bChainsResized = newCount != oldCount;
+        if(bChainsResized) {
+            for(size_t idx = lastCurve + 1; idx < chains.offsets.size(); ++idx) {
+                chains.offsets[idx] = chains.offsets[idx] - oldCount + newCount;
+            }
+        }
+        std::copy(m_EditedChains.points.begin(), m_EditedChains.points.end(),
+                  chains.points.begin() + static_cast<std::ptrdiff_t>(begin));
+        for(size_t idx = 1; idx < nCurves; ++idx) {
+            chains.offsets[firstCurve + idx] = begin + m_EditedChains.offsets[idx];
+        }
+        chains.offsets[lastCurve] = begin + newCount;
+
+        /* Same splice of the clamped curve indices */
+        auto&       clamped    = chains.clampedCurves;
+        const auto& edited     = m_EditedChains.clampedCurves;
+        const auto  rangeBegin = std::lower_bound(clamped.begin(), clamped.end(), firstCurve);
+        const auto  rangeEnd   = std::lower_bound(rangeBegin, clamped.end(), lastCurve);
+        const auto  inserted   = clamped.insert(clamped.erase(rangeBegin, rangeEnd), edited.begin(), edited.end());
+        std::for_each(inserted, inserted + static_cast<std::ptrdiff_t>(edited.size()), [&](size_t& idx) { idx += firstCurve; });
+    }
+
+    for(size_t idx = firstCurve; idx < lastCurve; ++idx) {
+        setCurveControlPoints(idx);
+    }
+    if(!usesGpuControlPoints()) {
+        m_bGpuControlPointsUploaded = false;
+    } else if(!m_bGpuControlPointsUploaded) {
+        uploadGpuControlPoints();
+    } else {
+        /* Only the control points of the range go to the GPU, unless the chain layout changed */
+        m_CubicBezierGpuRenderer.updateControlPoints(firstCurve * 4, &m_BezierControlPoints[firstCurve * 4], nCurves * 4);
+        if(!m_bToleranceDrivenQuadratics) {
+            m_QuadraticC1GpuRenderer.updateControlPoints(firstCurve * 5, &m_QuadraticControlPoints[firstCurve * 5],
+                                                         nCurves * 5);
+        } else if(bChainsResized) {
+            m_QuadraticC1GpuRenderer.setControlPoints(reinterpret_cast<const Vector3*>(m_QuadraticChains.points.data()),
+                                                      m_QuadraticChains.points.size(), m_QuadraticChains.offsets);
+        } else {
+            const auto begin = m_QuadraticChains.offsets[firstCurve];
+            m_QuadraticC1GpuRenderer.updateControlPoints(begin,
+                                                         reinterpret_cast<const Vector3*>(&m_QuadraticChains.points[begin]),
+                                                         m_QuadraticChains.offsets[lastCurve] - begin);
+        }
+    }
+    if(!gpuEvaluated()) {
+        for(size_t idx = firstCurve; idx < lastCurve; ++idx) {
+            m_CubicBezierCurves[idx]->recomputeCurve();
+            m_QuadraticC1Curves[idx]->recomputeCurve();
+        }
+    }
+
+    if(m_bEvaluateErrors && m_HausdorffDistances.size() == m_CurveGammas.size()) {
+        const auto method = static_cast<Core::HausdorffMethod>(m_HausdorffMethod);
+        if(m_bToleranceDrivenQuadratics) {
+            Core::hausdorffDistances(B, m_EditedChains, method, &m_HausdorffDistances[firstCurve]);
+            Core::l2Errors(B, m_EditedChains, &m_L2Errors[firstCurve]);
+        } else {
+            Core::hausdorffDistances(B, Q, nCurves, method, &m_HausdorffDistances[firstCurve]);
+            Core::l2Errors(B, Q, nCurves, &m_L2Errors[firstCurve]);
+        }
     }
 }
 
 /****************************************************************************************************/
 void QuadraticCurveApproximation::computeCurves() {
+    /* With GPU evaluation, the segment count is only a draw parameter */
     auto compute = [&](auto& curves, int subdiv) {
                        for(auto& curve: curves) {
-                           curve->subdivision() = subdiv;
-                           curve->recomputeCurve();
+                           curve->subdivision()        = subdiv;
+                           curve->tessellationMethod() = static_cast<Core::TessellationMethod>(m_TessellationMethod);
+                           curve->adaptiveTessellation()  = m_bAdaptiveTessellation;
+                           curve->tessellationTolerance() = m_TessellationTolerance;
+                       }
+                       if(!gpuEvaluated()) {
+                           recomputeCurves(curves);
                        }
                    };
     m_Polylines->recomputeCurve();
     compute(m_CubicBezierCurves, m_Subdivision);
     compute(m_QuadraticC1Curves, m_Subdivision >> 1);
+    if(!usesGpuControlPoints()) {
+        m_bGpuControlPointsUploaded = false;
+    } else if(!m_bGpuControlPointsUploaded) {
+        uploadGpuControlPoints();
+    }
 }
 
 /****************************************************************************************************/
-void QuadraticCurveApproximation::loadControlPoints() {
-    std::ifstream file("points.txt");
-    if(!file.is_open()) {
-        Fatal() << "Cannot find point.txt";
+void QuadraticCurveApproximation::uploadGpuControlPoints() {
+    /* Every piece of a chain of quadratic pairs is drawn with the segment count of a single pair */
+    m_CubicBezierGpuRenderer.setControlPoints(m_BezierControlPoints.data(), m_BezierControlPoints.size(), 4);
+    if(m_bToleranceDrivenQuadratics) {
+        m_QuadraticC1GpuRenderer.setControlPoints(reinterpret_cast<const Vector3*>(m_QuadraticChains.points.data()),
+                                                  m_QuadraticChains.points.size(), m_QuadraticChains.offsets);
+    } else {
+        m_QuadraticC1GpuRenderer.setControlPoints(m_QuadraticControlPoints.data(), m_QuadraticControlPoints.size(), 5);
     }
+    m_bGpuControlPointsUploaded = true;
+}
 
-    m_DataPoints.resize(0);
-    std::string line;
-    std::string x, y, z;
-    while(std::getline(file, line)) {
-        line.erase(line.find_last_not_of(" \n\r\t") + 1);
+/****************************************************************************************************/
+void QuadraticCurveApproximation::updateErrors() {
+    const auto nCurves = m_BezierControlPoints.size() / 4;
+    if(!m_bEvaluateErrors || nCurves == 0) {
+        m_HausdorffDistances.clear();
+        m_L2Errors.clear();
+        return;
+    }
 
-        if(line == "") {
-            continue;
-        }
+    const auto B      = toCorePoints(m_BezierControlPoints.data());
+    const auto method = static_cast<Core::HausdorffMethod>(m_HausdorffMethod);
+    m_HausdorffDistances.resize(nCurves);
+    m_L2Errors.resize(nCurves);
+    if(m_bToleranceDrivenQuadratics) {
+        Core::hausdorffDistances(B, m_QuadraticChains, method, m_HausdorffDistances.data());
+        Core::l2Errors(B, m_QuadraticChains, m_L2Errors.data());
+    } else {
+        const auto Q = toCorePoints(m_QuadraticControlPoints.data());
+        Core::hausdorffDistances(B, Q, nCurves, method, m_HausdorffDistances.data());
+        Core::l2Errors(B, Q, nCurves, m_L2Errors.data());
+    }
+}
 
-        if(line.find("//") != std::string::npos) {
-            continue;
-        }
+/****************************************************************************************************/
+QuadraticCurveApproximation::RenderingBenchmark
+QuadraticCurveApproximation::benchmarkQuadraticRendering(SceneGraph::Camera3D& camera, const Vector2i& viewport,
+                                                         size_t nFrames /*= 100*/) {
+    using Clock = std::chrono::steady_clock;
+    const auto transformPrjMat = camera.projectionMatrix() * camera.cameraMatrix();
+    const auto segments        = std::max(1, m_Subdivision >> 1);
+    const auto& config         = quadC1BezierConfig;
+
+    /* Bring both representations up to date: tessellated vertices (timed) and control points */
+    RenderingBenchmark result;
+    result.nFrames = nFrames;
+    const auto startTime = Clock::now();
+    recomputeCurves(m_QuadraticC1Curves);
+    result.tessellationTime = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    if(!m_bGpuControlPointsUploaded) {
+        uploadGpuControlPoints();
+    }
+
+    /* Average GPU time of one draw, after a warm-up draw that also uploads pending data */
+    auto timeDraws = [&](auto&& drawFrame) {
+                         drawFrame();
+                         GL::TimeQuery query{ GL::TimeQuery::Target::TimeElapsed };
+                         query.begin();
+                         for(size_t frame = 0; frame < nFrames; ++frame) {
+                             drawFrame();
+                         }
+                         query.end();
+                         return static_cast<double>(query.result<UnsignedLong>()) * 1.0e-6 / static_cast<double>(nFrames);
+                     };
+    result.tessellatedTime = timeDraws([&] {
+                                           m_QuadraticC1Renderer.draw(ResourceCache::lineShader(), transformPrjMat, viewport,
+                                                                      config.color, config.thickness, config.miterLimit);
+                                       });
+    result.vertexPullingTime = timeDraws([&] {
+                                             m_QuadraticC1GpuRenderer.draw(ResourceCache::curveEvaluationShader(), transformPrjMat,
+                                                                           viewport, config.color, config.thickness, segments);
+                                         });
+    result.analyticTime = timeDraws([&] {
+                                        m_QuadraticC1GpuRenderer.drawStrokes(ResourceCache::quadraticStrokeShader(),
+                                                                             transformPrjMat, viewport, config.color,
+                                                                             config.thickness);
+                                    });
+
+    const auto nPieces = m_QuadraticC1GpuRenderer.pieceCount();
+    result.tessellatedVertices   = m_QuadraticC1Renderer.vertexCount();
+    result.vertexPullingVertices = nPieces * static_cast<size_t>(segments + 3);
+    result.analyticVertices      = nPieces * static_cast<size_t>(QuadraticStrokeShader::VertexCount);
+    return result;
+}
+
+/****************************************************************************************************/
+size_t QuadraticCurveApproximation::quadraticCount() const {
+    const auto nCurves = m_BezierControlPoints.size() / 4;
+    return m_bToleranceDrivenQuadratics && m_QuadraticChains.offsets.size() == nCurves + 1 ?
+           (m_QuadraticChains.points.size() - nCurves) / 2 : 2 * nCurves;
+}
 
-        std::istringstream iss(line);
-        iss >> x >> y >> z;
-        m_DataPoints.push_back(Vector3{ stof(x), stof(y), stof(z) });
+/****************************************************************************************************/
+size_t QuadraticCurveApproximation::tessellatedPointCount() const {
+    if(gpuEvaluated()) {
+        return m_CubicBezierGpuRenderer.pieceCount() * static_cast<size_t>(std::max(1, m_Subdivision) + 3) +
+               m_QuadraticC1GpuRenderer.pieceCount() * static_cast<size_t>(std::max(1, m_Subdivision >> 1) + 3);
+    }
+    size_t count = 0;
+    for(const auto curve : m_CubicBezierCurves) {
+        count += curve->pointCount();
+    }
+    for(const auto curve : m_QuadraticC1Curves) {
+        count += curve->pointCount();
+    }
+    return count;
+}
+
+/****************************************************************************************************/
+QuadraticCurveApproximation::MemoryFootprint QuadraticCurveApproximation::memoryFootprint() const {
+    MemoryFootprint footprint;
+    footprint.curves         = m_CubicBezierPool.size() + m_QuadraticC1Pool.size();
+    footprint.curvePoolBytes = m_CubicBezierPool.allocatedBytes() + m_QuadraticC1Pool.allocatedBytes();
+    footprint.pointObjects   = PickableObject::pooledCount();
+    footprint.pointPoolBytes = PickableObject::pooledBytes();
+    footprint.curveDataBytes = m_Polylines->memoryUsage();
+    for(const auto curve : m_CubicBezierCurves) {
+        footprint.curveDataBytes += curve->memoryUsage();
+    }
+    for(const auto curve : m_QuadraticC1Curves) {
+        footprint.curveDataBytes += curve->memoryUsage();
+    }
+    return footprint;
+}
+
+/****************************************************************************************************/
+bool QuadraticCurveApproximation::loadControlPoints() {
+    using Clock = std::chrono::steady_clock;
+    const auto startTime = Clock::now();
+
+    /* The binary file is mapped and copied in one go, the text file is the fallback. A given file is
+     * binary or text depending on its content */
+    const std::string     binaryPath = m_PointsFile.empty() ? "points.bin" : m_PointsFile;
+    Core::MappedCurveFile binaryFile;
+    if(Core::isCurveFile(binaryPath)) {
+        if(!binaryFile.open(binaryPath)) {
+            m_LoadError = binaryFile.error();
+            return false;
+        }
+        const auto topology = binaryFile.header().topology;
+        if(topology == Core::CurveFileTopology::QuadraticPair) {
+            m_LoadError = binaryPath + " contains quadratic curves, expected cubic Bezier or Catmull-Rom points";
+            return false;
+        }
+        m_DataPoints.resize(binaryFile.pointCount());
+        binaryFile.copyPoints(0, m_DataPoints.size(), toCorePoints(m_DataPoints.data()));
+        m_bBinaryPoints         = true;
+        m_bBezierFromCatmullRom = topology == Core::CurveFileTopology::CatmullRom;
+        if(m_bBezierFromCatmullRom) {
+            m_CatmullRom_Alpha = binaryFile.header().catmullRomAlpha;
+        }
+    } else {
+        std::vector<Core::Point3> points;
+        std::string               error;
+        if(!Core::loadTextPoints(m_PointsFile.empty() ? "points.txt" : m_PointsFile, points, error)) {
+            const auto file = m_PointsFile.empty() ? std::string("points.bin or points.txt") : m_PointsFile;
+            m_LoadError = "Cannot load " + file + ": " + error;
+            return false;
+        }
+        m_DataPoints.resize(points.size());
+        std::copy(points.begin(), points.end(), toCorePoints(m_DataPoints.data()));
+        m_bBinaryPoints         = false;
+        m_bBezierFromCatmullRom = (m_DataPoints.size() % 4) != 0;
     }
-    file.close();
     // Debug() << "Loaded" << m_DataPoints.size() << "points";
+    const auto loadedTime = Clock::now();
 
     /* Update drawable points and curves */
-    m_bBezierFromCatmullRom = (m_DataPoints.size() % 4) != 0;
     computeBezierControlPoints();
     generateCurves();
+    m_StartupTimings.loadPoints  = std::chrono::duration<double, std::milli>(loadedTime - startTime).count();
+    m_StartupTimings.setupCurves = std::chrono::duration<double, std::milli>(Clock::now() - loadedTime).count();
+    return true;
 }
 
 /****************************************************************************************************/
 void QuadraticCurveApproximation::saveControlPoints() {
-    std::ofstream file("points.txt");
-    int           i = 0;
-    for(auto& p : m_DataPoints) {
-        if(i % 4 == 0) {
-            file << "\n// Control point of curve #" << i / 4 << "\n";
+    /* Report failures of the previous background writes once */
+    const auto error = m_Saver.lastError();
+    if(error != m_LastSaveError) {
+        m_LastSaveError = error;
+        if(!error.empty()) {
+            Error() << "Cannot save control points:" << error.c_str();
         }
-        ++i;
-        file << p.x() << " " << p.y() << " " << p.z() << "\n";
     }
-    file.close();
+
+    /* Only the snapshot is taken here, formatting and writing happen on the saver thread. The points are
+     * saved in the format that was loaded */
+    const auto                points = toCorePoints(m_DataPoints.data());
+    std::vector<Core::Point3> snapshot(points, points + m_DataPoints.size());
+    if(m_bBinaryPoints) {
+        const auto topology = m_bBezierFromCatmullRom ?
+                              Core::CurveFileTopology::CatmullRom : Core::CurveFileTopology::CubicBezier;
+        const auto file     = m_PointsFile.empty() ? std::string("points.bin") : m_PointsFile;
+        m_Saver.save(file, [snapshot = std::move(snapshot), topology, alpha = m_CatmullRom_Alpha](
+                         const std::string& path) {
+                         Core::CurveFileWriter writer;
+                         return writer.open(path, topology, Core::CurveFilePrecision::Float32, alpha) &&
+                                writer.append(snapshot.data(), snapshot.size()) && writer.close();
+                     });
+        return;
+    }
+
+    const auto file = m_PointsFile.empty() ? std::string("points.txt") : m_PointsFile;
+    m_Saver.save(file, [snapshot = std::move(snapshot)](const std::string& path) {
+                     const auto  nCurves = snapshot.size() / 4;
+                     std::string text;
+                     Core::formatCurves(snapshot.data(), nCurves, 4, Core::PointFormat::Text, text);
+                     if(snapshot.size() % 4 != 0) {
+                         Core::formatCurves(&snapshot[4 * nCurves], 1, snapshot.size() % 4, Core::PointFormat::Text,
+                                            text, nCurves);
+                     }
+                     FILE* file = std::fopen(path.c_str(), "wb");
+                     if(!file) {
+                         return false;
+                     }
+                     const auto bWritten = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+                     return std::fclose(file) == 0 && bWritten;
+                 });
 }
 
 /****************************************************************************************************/
 void QuadraticCurveApproximation::computeBezierControlPointsFromCatmullRom() {
-    auto convert =
-        [](const VPoints& points, size_t idx, float alpha) {
-            const Vector3* P  = &points[idx];
-            const auto     d1 = (P[0] - P[1]).length();
-            const auto     d2 = (P[1] - P[2]).length();
-            const auto     d3 = (P[2] - P[3]).length();
-
-            const auto d1_alpha  = std::pow(d1, alpha);
-            const auto d2_alpha  = std::pow(d2, alpha);
-            const auto d3_alpha  = std::pow(d3, alpha);
-            const auto d1_2alpha = std::pow(d1, 2.0f * alpha);
-            const auto d2_2alpha = std::pow(d2, 2.0f * alpha);
-            const auto d3_2alpha = std::pow(d3, 2.0f * alpha);
-
-            /* Compute control points of the cubic Bezier curve */
-            VPoints B(4);
-            B[0] = P[1];
-            B[3] = P[2];
-            B[1] = (d1_2alpha * P[2] - d2_2alpha * P[0] +
-                    (2.0f * d1_2alpha + 3.0f * d1_alpha * d2_alpha + d2_2alpha) * P[1]) /
-                   (3.0f * d1_alpha * (d1_alpha + d2_alpha));
-            B[2] = (d3_2alpha * P[1] - d2_2alpha * P[3] +
-                    (2.0f * d3_2alpha + 3.0f * d3_alpha * d2_alpha + d2_2alpha) * P[2]) /
-                   (3.0f * d3_alpha * (d3_alpha + d2_alpha));
-            return B;
-        };
-
-    m_BezierControlPoints.resize(0);
-    for(size_t i = 0; i < m_DataPoints.size() - 3; ++i) {
-        const auto bpoints = convert(m_DataPoints, i, m_CatmullRom_Alpha);
-        m_BezierControlPoints.insert(m_BezierControlPoints.end(), bpoints.begin(), bpoints.end());
-    }
+    m_BezierControlPoints.resize(Core::catmullRomCurveCount(m_DataPoints.size()) * 4);
+    Core::catmullRomToCubics(toCorePoints(m_DataPoints.data()), m_DataPoints.size(), m_CatmullRom_Alpha,
+                             toCorePoints(m_BezierControlPoints.data()));
 }
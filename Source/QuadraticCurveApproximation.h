@@ -16,11 +16,20 @@
 
 #pragma once
 
+#include <Corrade/Containers/Pointer.h>
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/Math/Color.h>
-#include <Magnum/Shaders/Phong.h>
 #include <Magnum/SceneGraph/MatrixTransformation3D.h>
 
+#include "DrawableObjects/Curves/BatchedCurveRenderer.h"
+#include "DrawableObjects/Curves/GpuCurveRenderer.h"
+#include "DrawableObjects/InstancedSphereRenderer.h"
+#include "Core/AsyncSaver.h"
+#include "Core/ObjectPool.h"
+#include "Core/CurveBatch.h"
+#include "Core/ErrorMetrics.h"
+#include "Core/QuadraticChain.h"
+
 #include <unordered_map>
 
 /****************************************************************************************************/
@@ -42,14 +51,17 @@ public:
     using DrawablePoints = std::vector<PickableObject*>;
 
 public:
-    explicit QuadraticCurveApproximation(Scene3D* const                     scene,
-                                         SceneGraph::DrawableGroup3D* const drawables);
+    /* Loads the points of pointsFile (binary curve file or text), or of points.bin / points.txt in the
+     * working directory by default. On failure loadError() is set and there are no curves */
+    explicit QuadraticCurveApproximation(Scene3D* const scene, const std::string& pointsFile = {});
+    ~QuadraticCurveApproximation();
     QuadraticCurveApproximation& draw(Magnum::SceneGraph::Camera3D& camera, const Vector2i& viewport);
 
     void updateCurveConfigs();
     struct CurveConfig {
         Color3 color { 0.0f, 0.0f, 1.0f };
         float  thickness{ 1.0f };
+        float  miterLimit { 0.1f };
         float  controlPointRadius { 0.02f };
         bool   bRenderControlPoints{ true };
         bool   bEnabled { true };
@@ -59,42 +71,151 @@ public:
 
     int& subdivision() { return m_Subdivision; }
     float& gamma() { return m_gamma; }
+
+    /* Gamma of every curve: the global value, or the per-curve optimum of an error objective */
+    enum class GammaMode { Global, OptimalL2, OptimalMaxDistance };
+    int& gammaMode() { return m_GammaMode; }
+
+    /* Tolerance-driven approximation: chains of quadratic pairs within the given distance of the cubics */
+    bool& toleranceDrivenQuadratics() { return m_bToleranceDrivenQuadratics; }
+    float& quadraticTolerance() { return m_QuadraticTolerance; }
+    size_t quadraticCount() const;
+    /* Curves whose quadratic chain misses the tolerance, see Core::MaxQuadraticPairsPerCubic */
+    size_t clampedChainCount() const { return m_bToleranceDrivenQuadratics ? m_QuadraticChains.clampedCurves.size() : 0; }
+
+    /* Per-curve errors between the cubics and their quadratic approximations */
+    bool& evaluateErrors() { return m_bEvaluateErrors; }
+    int& hausdorffMethod() { return m_HausdorffMethod; }
+    const std::vector<float>& hausdorffDistances() const { return m_HausdorffDistances; }
+    const std::vector<float>& l2Errors() const { return m_L2Errors; }
+
     bool& BezierFromCatmullRom() { return m_bBezierFromCatmullRom; }
+    int& tessellationMethod() { return m_TessellationMethod; }
+    bool& adaptiveTessellation() { return m_bAdaptiveTessellation; }
+    float& tessellationTolerance() { return m_TessellationTolerance; }
+    size_t tessellatedPointCount() const;
+
+    /* Evaluate the Bezier and quadratic curves in the vertex shader from their control points, instead of
+     * tessellating them on the CPU. Adaptive tessellation is CPU only and takes precedence */
+    bool& gpuCurveEvaluation() { return m_bGpuCurveEvaluation; }
+
+    /* Stroke the quadratic curves analytically in the fragment shader (QuadraticStrokeShader), instead of
+     * drawing them as polylines */
+    bool& analyticQuadratics() { return m_bAnalyticQuadratics; }
+
+    /* Quadratic curve rendering paths compared on the current view: GPU time per draw in milliseconds and
+     * vertices per draw of the tessellated polylines (LineShader), the vertex-pulled polylines
+     * (CurveEvaluationShader) and the analytic strokes, with the CPU time of one tessellation */
+    struct RenderingBenchmark {
+        size_t nFrames { 0 };
+        double tessellationTime { 0.0 };
+        double tessellatedTime { 0.0 };
+        double vertexPullingTime { 0.0 };
+        double analyticTime { 0.0 };
+        size_t tessellatedVertices { 0 };
+        size_t vertexPullingVertices { 0 };
+        size_t analyticVertices { 0 };
+    };
+    RenderingBenchmark benchmarkQuadraticRendering(SceneGraph::Camera3D& camera, const Vector2i& viewport,
+                                                   size_t nFrames = 100);
 
     void setDataPoint(uint32_t selectedIdx, const Vector3& point);
+    /* Set a data point and update only the curves depending on it, with their polyline vertices and errors */
+    void moveDataPoint(uint32_t selectedIdx, const Vector3& point);
     void computeBezierControlPoints();
     void generateCurves();
     void updatePolylines();
     void updateCurveControlPoints();
     void computeCurves();
+    void updateErrors();
     void saveControlPoints();
 
+    /* Live objects and the memory behind them: the curves and the drawables of their points come from
+     * pools, the point data of the curves is counted by vector capacity */
+    struct MemoryFootprint {
+        size_t curves { 0 };
+        size_t curvePoolBytes { 0 };
+        size_t pointObjects { 0 };
+        size_t pointPoolBytes { 0 };
+        size_t curveDataBytes { 0 };
+    };
+    MemoryFootprint memoryFootprint() const;
+
+    /* Startup timings in milliseconds: reading the data points, then creating and computing the curves */
+    struct StartupTimings {
+        double loadPoints { 0.0 };
+        double setupCurves { 0.0 };
+    };
+    const StartupTimings& startupTimings() const { return m_StartupTimings; }
+    const std::string& loadError() const { return m_LoadError; }
+    const VPoints& dataPoints() const { return m_DataPoints; }
+
 private:
     void resetDataPoints();
     void updateDrawablePoints();
-    void loadControlPoints();
+    bool loadControlPoints();
     void computeBezierControlPointsFromCatmullRom();
+    void setCurveControlPoints(size_t idx);
+    void updateCurveRange(size_t firstCurve, size_t lastCurve);
+    bool gpuEvaluated() const { return m_bGpuCurveEvaluation && !m_bAdaptiveTessellation; }
+    bool usesGpuControlPoints() const { return gpuEvaluated() || m_bAnalyticQuadratics; }
+    void uploadGpuControlPoints();
 
-    Scene3D* const                     m_Scene;
-    SceneGraph::DrawableGroup3D* const m_Drawables;
-    Shaders::Phong                     m_SphereShader{ Shaders::Phong::Flag::ObjectId };
-    GL::Mesh m_MeshSphere{ NoCreate };
+    Scene3D* const m_Scene;
 
     DrawablePoints m_DrawablePoints;
     VPoints        m_DataPoints_t0;
     VPoints        m_DataPoints;
     VPoints        m_BezierControlPoints;
+    VPoints        m_QuadraticControlPoints;
     std::unordered_map<uint32_t, size_t> m_mDrawableIdxToPointIdx;
+    StartupTimings m_StartupTimings;
+    std::string m_PointsFile; /* empty for points.bin / points.txt */
+    std::string m_LoadError;
+    bool m_bBinaryPoints { false }; /* loaded from a binary curve file rather than text */
+    Core::AsyncSaver m_Saver;
+    std::string      m_LastSaveError;
 
     /* Line subdivision and curve approximation */
     bool  m_bBezierFromCatmullRom { false };
     float m_CatmullRom_Alpha { 0.5f };
 
     int   m_Subdivision { 128 };
+    int   m_TessellationMethod { static_cast<int>(Core::TessellationMethod::Horner) };
+    bool  m_bAdaptiveTessellation { false };
+    float m_TessellationTolerance { 1.0e-3f };
+    bool  m_bGpuCurveEvaluation { false };
+    bool  m_bAnalyticQuadratics { false };
+    bool  m_bGpuControlPointsUploaded { false };
     float m_gamma { 0.5f };
-
-    /* Curves */
-    Polyline* m_Polylines;
+    int   m_GammaMode { static_cast<int>(GammaMode::Global) };
+    std::vector<float> m_CurveGammas;
+    bool  m_bToleranceDrivenQuadratics { false };
+    float m_QuadraticTolerance { 1.0e-2f };
+    Core::QuadraticChains m_QuadraticChains;
+    Core::QuadraticChains m_EditedChains; /* chains of the curves updated by moveDataPoint() */
+    bool  m_bEvaluateErrors { false };
+    int   m_HausdorffMethod { static_cast<int>(Core::HausdorffMethod::Sampled) };
+    std::vector<float> m_HausdorffDistances;
+    std::vector<float> m_L2Errors;
+
+    /* Curves, allocated from pools that keep their memory when the curves are regenerated */
+    Core::ObjectPool<CubicBezier>                 m_CubicBezierPool;
+    Core::ObjectPool<QuadraticApproximatingCubic> m_QuadraticC1Pool;
+    Containers::Pointer<Polyline>                 m_Polylines;
     std::vector<CubicBezier*>     m_CubicBezierCurves;
     std::vector<QuadraticApproximatingCubic*> m_QuadraticC1Curves;
+
+    /* Line rendering, one batch per curve style */
+    BatchedCurveRenderer m_PolylineRenderer;
+    BatchedCurveRenderer m_CubicBezierRenderer;
+    BatchedCurveRenderer m_QuadraticC1Renderer;
+    GpuCurveRenderer     m_CubicBezierGpuRenderer { Core::CurveType::CubicBezier };
+    GpuCurveRenderer     m_QuadraticC1GpuRenderer { Core::CurveType::QuadraticPair };
+
+    /* Sphere rendering, one instanced draw for the data points and one per curve style for control points,
+     * each renderer keeping the instances of its previous frame */
+    InstancedSphereRenderer m_DataPointRenderer;
+    InstancedSphereRenderer m_CubicBezierControlPointRenderer;
+    InstancedSphereRenderer m_QuadraticC1ControlPointRenderer;
 };
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "CurveEvaluationShader.h"
+
+#include <Magnum/GL/BufferTexture.h>
+
+/****************************************************************************************************/
+CurveEvaluationShader::CurveEvaluationShader() : LineShader{ R"(
+        uniform highp mat4 transformationProjectionMatrix;
+        uniform highp samplerBuffer controlPoints;
+        uniform bool quadraticPair = false;
+        uniform int segments = 1;
+
+        /* Matches CurveEvaluationShader::FirstPoint definition */
+        layout(location = 0) in highp uint firstPoint;
+
+        vec3 controlPoint(int i) {
+            int texel = 3 * (int(firstPoint) + i);
+            return vec3(texelFetch(controlPoints, texel).r,
+                        texelFetch(controlPoints, texel + 1).r,
+                        texelFetch(controlPoints, texel + 2).r);
+        }
+
+        vec3 quadratic(int first, float t) {
+            float s = 1.0 - t;
+            return s * s * controlPoint(first) + 2.0 * s * t * controlPoint(first + 1) + t * t * controlPoint(first + 2);
+        }
+
+        vec3 cubic(float t) {
+            float s = 1.0 - t;
+            return s * s * s * controlPoint(0) + 3.0 * s * s * t * controlPoint(1) +
+                   3.0 * s * t * t * controlPoint(2) + t * t * t * controlPoint(3);
+        }
+
+        vec3 curve(int i) {
+            float t = float(i) / float(segments);
+            if(quadraticPair) {
+                return t < 0.5 ? quadratic(0, 2.0 * t) : quadratic(2, 2.0 * (t - 0.5));
+            }
+            return cubic(t);
+        }
+
+        void main() {
+            /* The first and last vertices are the adjacency of the line strip: the end segments mirrored
+             * across the end points, so that the geometry stage gets a straight join instead of an empty
+             * segment at each end */
+            int i = gl_VertexID - 1;
+            vec3 position = curve(clamp(i, 0, segments));
+            if(i < 0 || i > segments) {
+                position = 2.0 * position - curve(i < 0 ? 1 : segments - 1);
+            }
+            gl_Position = transformationProjectionMatrix * vec4(position, 1.0);
+        }
+    )" } {
+    m_uQuadraticPair = uniformLocation("quadraticPair");
+    m_uSegments      = uniformLocation("segments");
+    setUniform(uniformLocation("controlPoints"), ControlPointUnit);
+}
+
+/****************************************************************************************************/
+CurveEvaluationShader& CurveEvaluationShader::setCurveType(Core::CurveType type) {
+    setUniform(m_uQuadraticPair, static_cast<Int>(type == Core::CurveType::QuadraticPair));
+    return *this;
+}
+
+/****************************************************************************************************/
+CurveEvaluationShader& CurveEvaluationShader::setSegments(Int segments) {
+    setUniform(m_uSegments, segments);
+    return *this;
+}
+
+/****************************************************************************************************/
+CurveEvaluationShader& CurveEvaluationShader::bindControlPoints(GL::BufferTexture& texture) {
+    texture.bind(ControlPointUnit);
+    return *this;
+}
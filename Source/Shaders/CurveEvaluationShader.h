@@ -0,0 +1,47 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include "Shaders/LineShader.h"
+#include "Core/CurveBatch.h"
+
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/GL/GL.h>
+
+/****************************************************************************************************/
+/* Line shader evaluating the curve in the vertex stage (vertex pulling).
+ *
+ * Control points are read from a R32F buffer texture, three texels per point. Every instance is one
+ * curve piece (a cubic Bezier curve or a quadratic pair) starting at the control point given by the
+ * per-instance FirstPoint attribute. Vertex k of a piece is the point at t = (k - 1) / segments, with
+ * the end points repeated as line strip adjacency, so a piece is drawn with segments + 3 vertices.
+ */
+class CurveEvaluationShader : public LineShader {
+public:
+    typedef GL::Attribute<0, UnsignedInt> FirstPoint;
+
+    enum: Int { ControlPointUnit = 0 };
+
+    CurveEvaluationShader();
+    CurveEvaluationShader& setCurveType(Core::CurveType type);
+    CurveEvaluationShader& setSegments(Int segments);
+    CurveEvaluationShader& bindControlPoints(GL::BufferTexture& texture);
+
+private:
+    Int m_uQuadraticPair,
+        m_uSegments;
+};
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "InstancedSphereShader.h"
+#include "ProgramBinaryCache.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Matrix4.h>
+
+/****************************************************************************************************/
+InstancedSphereShader::InstancedSphereShader() {
+    const std::string srcVert = R"(
+        uniform highp mat4 cameraMatrix;
+        uniform highp mat3 normalMatrix;
+        uniform highp mat4 projectionMatrix;
+        uniform highp vec3 lightPosition;
+
+        /* Match InstancedSphereShader attribute definitions */
+        layout(location = 0) in highp vec3 position;
+        layout(location = 1) in mediump vec3 normal;
+        layout(location = 2) in highp vec4 centerRadius;
+        layout(location = 3) in lowp vec3 color;
+        layout(location = 4) in highp uint objectId;
+
+        out mediump vec3 transformedNormal;
+        out highp vec3 lightDirection;
+        out highp vec3 cameraDirection;
+        flat out lowp vec3 instanceColor;
+        flat out highp uint instanceObjectId;
+
+        void main() {
+            vec4 transformedPosition = cameraMatrix * vec4(centerRadius.xyz + centerRadius.w * position, 1.0);
+            transformedNormal = normalMatrix * normal;
+            lightDirection    = lightPosition - transformedPosition.xyz;
+            cameraDirection   = -transformedPosition.xyz;
+            instanceColor     = color;
+            instanceObjectId  = objectId;
+            gl_Position = projectionMatrix * transformedPosition;
+        }
+    )";
+
+    const std::string srcFrag = R"(
+        in mediump vec3 transformedNormal;
+        in highp vec3 lightDirection;
+        in highp vec3 cameraDirection;
+        flat in lowp vec3 instanceColor;
+        flat in highp uint instanceObjectId;
+
+        layout(location = 0) out lowp vec4 fragmentColor;
+        layout(location = 1) out highp uint fragmentObjectId;
+
+        void main() {
+            /* Diffuse and white specular terms of Shaders::Phong, without ambient */
+            mediump vec3 normal    = normalize(transformedNormal);
+            highp vec3   light     = normalize(lightDirection);
+            lowp float   intensity = max(0.0, dot(normal, light));
+            lowp vec3    result    = instanceColor * intensity;
+            if(intensity > 0.0) {
+                highp vec3 reflection  = reflect(-light, normal);
+                mediump float specularity = pow(max(0.0, dot(normalize(cameraDirection), reflection)), 80.0);
+                result += vec3(specularity);
+            }
+            fragmentColor    = vec4(result, 1.0);
+            fragmentObjectId = instanceObjectId;
+        }
+    )";
+
+    /* Reuse the binary linked by a previous run, or compile from source and store the result */
+    const auto cacheKey = ProgramBinaryCache::key({ &srcVert, &srcFrag });
+    if(!ProgramBinaryCache::load(*this, cacheKey)) {
+        GL::Shader vertShader{ GL::Version::GL330, GL::Shader::Type::Vertex };
+        GL::Shader fragShader{ GL::Version::GL330, GL::Shader::Type::Fragment };
+        vertShader.addSource(srcVert);
+        fragShader.addSource(srcFrag);
+        CORRADE_INTERNAL_ASSERT(GL::Shader::compile({ vertShader, fragShader }));
+        attachShaders({ vertShader, fragShader });
+        ProgramBinaryCache::setRetrievable(*this);
+        CORRADE_INTERNAL_ASSERT(link());
+        ProgramBinaryCache::save(*this, cacheKey);
+    }
+
+    m_uCameraMatrix     = uniformLocation("cameraMatrix");
+    m_uNormalMatrix     = uniformLocation("normalMatrix");
+    m_uProjectionMatrix = uniformLocation("projectionMatrix");
+    m_uLightPosition    = uniformLocation("lightPosition");
+}
+
+/****************************************************************************************************/
+InstancedSphereShader& InstancedSphereShader::setCameraMatrix(const Matrix4& matrix) {
+    setUniform(m_uCameraMatrix, matrix);
+    setUniform(m_uNormalMatrix, matrix.normalMatrix());
+    return *this;
+}
+
+/****************************************************************************************************/
+InstancedSphereShader& InstancedSphereShader::setProjectionMatrix(const Matrix4& matrix) {
+    setUniform(m_uProjectionMatrix, matrix);
+    return *this;
+}
+
+/****************************************************************************************************/
+InstancedSphereShader& InstancedSphereShader::setLightPosition(const Vector3& position) {
+    setUniform(m_uLightPosition, position);
+    return *this;
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/GL/GL.h>
+
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Phong-lit spheres drawn with one instanced draw call, for InstancedSphereRenderer.
+ *
+ * The mesh is a unit sphere, and every instance only carries its center, radius, color and object ID,
+ * from which the vertex shader builds the transformation. As spheres are scaled uniformly, the normals of
+ * the unit sphere are also the world-space normals. The object ID is written to ObjectIdOutput for
+ * picking, at the same output locations as Shaders::Phong.
+ */
+class InstancedSphereShader : public GL::AbstractShaderProgram {
+public:
+    typedef GL::Attribute<0, Vector3>     Position;
+    typedef GL::Attribute<1, Vector3>     Normal;
+    typedef GL::Attribute<2, Vector4>     CenterRadius;
+    typedef GL::Attribute<3, Vector3>     Color;
+    typedef GL::Attribute<4, UnsignedInt> ObjectId;
+
+    enum: UnsignedInt {
+        ColorOutput    = 0,
+        ObjectIdOutput = 1
+    };
+
+    InstancedSphereShader();
+    InstancedSphereShader& setCameraMatrix(const Matrix4& matrix);
+    InstancedSphereShader& setProjectionMatrix(const Matrix4& matrix);
+    /* Light position relative to the camera */
+    InstancedSphereShader& setLightPosition(const Vector3& position);
+
+private:
+    Int m_uCameraMatrix,
+        m_uNormalMatrix,
+        m_uProjectionMatrix,
+        m_uLightPosition;
+};
@@ -15,6 +15,7 @@
  */
 
 #include "LineShader.h"
+#include "ProgramBinaryCache.h"
 
 #include <Corrade/Containers/Reference.h>
 #include <Magnum/GL/Shader.h>
@@ -23,12 +24,7 @@
 #include <Magnum/Math/Matrix4.h>
 
 /****************************************************************************************************/
-LineShader::LineShader() {
-    GL::Shader vertShader{ GL::Version::GL330, GL::Shader::Type::Vertex };
-    GL::Shader fragShader{ GL::Version::GL330, GL::Shader::Type::Fragment };
-    GL::Shader geomShader{ GL::Version::GL330, GL::Shader::Type::Geometry };
-
-    const std::string srcVert = R"(
+LineShader::LineShader() : LineShader{ R"(
         uniform highp mat4 transformationProjectionMatrix;
 
         /* Matches LineShader::Position and LineShader::Normal definitions */
@@ -37,8 +33,10 @@ LineShader::LineShader() {
         void main() {
             gl_Position = transformationProjectionMatrix * position;
         }
-    )";
+    )" } {}
 
+/****************************************************************************************************/
+LineShader::LineShader(const std::string& srcVert) {
     const std::string srcFrag = R"(
         uniform lowp vec3 color;
         layout(location = 0) out lowp vec4 fragmentColor;
@@ -77,10 +75,11 @@ LineShader::LineShader() {
             if( p2.x < -area.x || p2.x > area.x ) return;
             if( p2.y < -area.y || p2.y > area.y ) return;
 
-            /* determine the direction of each of the 3 segments (previous, current, next) */
-            vec2 v0 = normalize( p1 - p0 );
+            /* determine the direction of each of the 3 segments (previous, current, next). The end points
+             * of a curve are repeated as adjacency, these empty segments continue the current one */
             vec2 v1 = normalize( p2 - p1 );
-            vec2 v2 = normalize( p3 - p2 );
+            vec2 v0 = p1 != p0 ? normalize( p1 - p0 ) : v1;
+            vec2 v2 = p3 != p2 ? normalize( p3 - p2 ) : v1;
 
             /* determine the normal of each of the 3 segments (previous, current, next) */
             vec2 n0 = vec2( -v0.y, v0.x );
@@ -178,12 +177,21 @@ LineShader::LineShader() {
         }
     )";
 
-    vertShader.addSource(srcVert);
-    fragShader.addSource(srcFrag);
-    geomShader.addSource(srcGeom);
-    CORRADE_INTERNAL_ASSERT(GL::Shader::compile({ vertShader, fragShader, geomShader }));
-    attachShaders({ vertShader, fragShader, geomShader });
-    CORRADE_INTERNAL_ASSERT(link());
+    /* Reuse the binary linked by a previous run, or compile from source and store the result */
+    const auto cacheKey = ProgramBinaryCache::key({ &srcVert, &srcFrag, &srcGeom });
+    if(!ProgramBinaryCache::load(*this, cacheKey)) {
+        GL::Shader vertShader{ GL::Version::GL330, GL::Shader::Type::Vertex };
+        GL::Shader fragShader{ GL::Version::GL330, GL::Shader::Type::Fragment };
+        GL::Shader geomShader{ GL::Version::GL330, GL::Shader::Type::Geometry };
+        vertShader.addSource(srcVert);
+        fragShader.addSource(srcFrag);
+        geomShader.addSource(srcGeom);
+        CORRADE_INTERNAL_ASSERT(GL::Shader::compile({ vertShader, fragShader, geomShader }));
+        attachShaders({ vertShader, fragShader, geomShader });
+        ProgramBinaryCache::setRetrievable(*this);
+        CORRADE_INTERNAL_ASSERT(link());
+        ProgramBinaryCache::save(*this, cacheKey);
+    }
 
     m_uColor      = uniformLocation("color");
     m_uThickness  = uniformLocation("thickness");
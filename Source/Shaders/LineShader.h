@@ -18,6 +18,8 @@
 #include <Magnum/GL/AbstractShaderProgram.h>
 #include <Magnum/Shaders/Generic.h>
 
+#include <string>
+
 using namespace Corrade;
 using namespace Magnum;
 
@@ -31,6 +33,11 @@ public:
     LineShader& setViewport(const Vector2i& viewport);
     LineShader& setTransformationProjectionMatrix(const Matrix4& matrix);
 
+protected:
+    /* Line shader with a custom vertex stage, which must output clip-space positions and declare the
+     * transformationProjectionMatrix uniform */
+    explicit LineShader(const std::string& srcVert);
+
 private:
     Int m_uColor,
         m_uThickness,
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Shaders/ProgramBinaryCache.h"
+
+#include <Magnum/GL/Context.h>
+#include <Magnum/GL/Extensions.h>
+#include <Magnum/GL/OpenGL.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#ifdef _WIN32
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
+
+/****************************************************************************************************/
+namespace {
+constexpr char ProgramBinaryMagic[8] = { 'Q', 'A', 'P', 'R', 'O', 'G', 'B', '1' };
+
+struct ProgramBinaryHeader {
+    char     magic[8];
+    uint32_t format;
+    uint32_t reserved;
+    uint64_t key;
+    uint64_t size;
+};
+
+/* 64-bit FNV-1a */
+uint64_t hashBytes(uint64_t hash, const char* data, size_t size) {
+    for(size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t hashString(uint64_t hash, const std::string& str) {
+    /* The length separates consecutive strings */
+    const uint64_t size = str.size();
+    hash = hashBytes(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+    return hashBytes(hash, str.data(), str.size());
+}
+}
+
+/****************************************************************************************************/
+uint64_t ProgramBinaryCache::key(std::initializer_list<const std::string*> sources) {
+    const auto& context = GL::Context::current();
+    uint64_t    hash    = 14695981039346656037ull;
+    hash = hashString(hash, context.vendorString());
+    hash = hashString(hash, context.rendererString());
+    hash = hashString(hash, context.versionString());
+    for(const auto source : sources) {
+        hash = hashString(hash, *source);
+    }
+    return hash;
+}
+
+/****************************************************************************************************/
+bool ProgramBinaryCache::load(GL::AbstractShaderProgram& program, uint64_t key) {
+    if(!isSupported()) {
+        return false;
+    }
+
+    FILE* file = std::fopen(path(key).c_str(), "rb");
+    if(!file) {
+        ++s_nMisses;
+        return false;
+    }
+    ProgramBinaryHeader header;
+    std::vector<char>   binary;
+    bool                bRead = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                                std::memcmp(header.magic, ProgramBinaryMagic, sizeof(ProgramBinaryMagic)) == 0 &&
+                                header.key == key && header.size > 0 && header.size < (uint64_t(1) << 30);
+    if(bRead) {
+        binary.resize(static_cast<size_t>(header.size));
+        bRead = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    std::fclose(file);
+
+    /* The driver may still reject a binary, e.g. after an update that kept the version string */
+    GLint linked = GL_FALSE;
+    if(bRead) {
+        glProgramBinary(program.id(), header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        glGetProgramiv(program.id(), GL_LINK_STATUS, &linked);
+    }
+    if(linked != GL_TRUE) {
+        ++s_nMisses;
+        return false;
+    }
+    ++s_nHits;
+    return true;
+}
+
+/****************************************************************************************************/
+void ProgramBinaryCache::setRetrievable(GL::AbstractShaderProgram& program) {
+    if(isSupported()) {
+        glProgramParameteri(program.id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+/****************************************************************************************************/
+void ProgramBinaryCache::save(GL::AbstractShaderProgram& program, uint64_t key) {
+    if(!isSupported()) {
+        return;
+    }
+    GLint size = 0;
+    glGetProgramiv(program.id(), GL_PROGRAM_BINARY_LENGTH, &size);
+    if(size <= 0) {
+        return;
+    }
+    std::vector<char> binary(static_cast<size_t>(size));
+    GLenum            format = 0;
+    GLsizei           length = 0;
+    glGetProgramBinary(program.id(), size, &length, &format, binary.data());
+    if(length <= 0) {
+        return;
+    }
+
+    /* Write to a temporary file of this process and rename it, concurrent launches never read or
+     * write each other's partial binary */
+#ifdef _WIN32
+    const auto      pid      = static_cast<long long>(_getpid());
+#else
+    const auto      pid      = static_cast<long long>(getpid());
+#endif
+    const auto      filePath = path(key);
+    const auto      tempPath = filePath + "." + std::to_string(pid) + ".tmp";
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(filePath).parent_path(), ec);
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if(!file) {
+        return;
+    }
+    ProgramBinaryHeader header{};
+    std::memcpy(header.magic, ProgramBinaryMagic, sizeof(ProgramBinaryMagic));
+    header.format = format;
+    header.key    = key;
+    header.size   = static_cast<uint64_t>(length);
+    const bool bWritten = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                          std::fwrite(binary.data(), 1, static_cast<size_t>(length), file) == static_cast<size_t>(length);
+    const bool bClosed = std::fclose(file) == 0;
+    if(bClosed && bWritten) {
+        std::filesystem::rename(tempPath, filePath, ec);
+    }
+    if(!bClosed || !bWritten || ec) {
+        std::remove(tempPath.c_str());
+    }
+}
+
+/****************************************************************************************************/
+bool ProgramBinaryCache::isSupported() {
+    return GL::Context::current().isExtensionSupported<GL::Extensions::ARB::get_program_binary>();
+}
+
+/****************************************************************************************************/
+std::string ProgramBinaryCache::path(uint64_t key) {
+    const char* directory = std::getenv("QA_SHADER_CACHE");
+    char        name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(directory && *directory ? directory : "shader_cache") / name).string();
+}
@@ -0,0 +1,60 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <Magnum/GL/AbstractShaderProgram.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Persistent cache of linked program binaries (ARB_get_program_binary / GL 4.1).
+ *
+ * A program is keyed by a hash of its shader sources and of the vendor, renderer and version strings
+ * of the context, so that driver updates or another GPU never get a stale binary. Binaries are stored
+ * as <directory>/<key>.bin, the directory is $QA_SHADER_CACHE or "shader_cache" in the working
+ * directory. Without the extension, or when the driver rejects a binary, load() fails and the caller
+ * compiles from source as usual.
+ */
+class ProgramBinaryCache {
+public:
+    static uint64_t key(std::initializer_list<const std::string*> sources);
+
+    /* Load the binary of key into program, returns false if there is none or it was rejected */
+    static bool load(GL::AbstractShaderProgram& program, uint64_t key);
+
+    /* Call before linking a program that will be saved */
+    static void setRetrievable(GL::AbstractShaderProgram& program);
+
+    /* Store the binary of a linked program */
+    static void save(GL::AbstractShaderProgram& program, uint64_t key);
+
+    static size_t hitCount() { return s_nHits; }
+    static size_t missCount() { return s_nMisses; }
+
+private:
+    static bool isSupported();
+    static std::string path(uint64_t key);
+
+    static inline size_t s_nHits { 0 };
+    static inline size_t s_nMisses { 0 };
+};
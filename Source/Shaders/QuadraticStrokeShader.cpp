@@ -0,0 +1,252 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "QuadraticStrokeShader.h"
+#include "ProgramBinaryCache.h"
+
+#include <Corrade/Containers/Reference.h>
+#include <Magnum/GL/BufferTexture.h>
+#include <Magnum/GL/Shader.h>
+#include <Magnum/GL/Version.h>
+#include <Magnum/Math/Color.h>
+#include <Magnum/Math/Matrix4.h>
+
+/****************************************************************************************************/
+QuadraticStrokeShader::QuadraticStrokeShader() {
+    const std::string srcVert = R"(
+        uniform highp mat4 transformationProjectionMatrix;
+        uniform highp samplerBuffer controlPoints;
+        uniform lowp float thickness = 5.0;
+        uniform lowp vec2 viewport;
+
+        /* Matches QuadraticStrokeShader::FirstPoint definition */
+        layout(location = 0) in highp uint firstPoint;
+
+        /* Control points in screen space (NDC scaled by the viewport, as in LineShader), and their NDC depth */
+        flat out highp vec2 A;
+        flat out highp vec2 B;
+        flat out highp vec2 C;
+        flat out highp vec3 depths;
+
+        /* Two triangles per quad, corners indexed by (x is max) | (y is max) << 1 */
+        const int quadCorners[6] = int[6](0, 1, 2, 2, 1, 3);
+
+        vec4 controlPoint(int i) {
+            int texel = 3 * (int(firstPoint) + i);
+            return transformationProjectionMatrix * vec4(texelFetch(controlPoints, texel).r,
+                                                         texelFetch(controlPoints, texel + 1).r,
+                                                         texelFetch(controlPoints, texel + 2).r, 1.0);
+        }
+
+        /* Longest parameter range in [0, 1] on which the quadratic with clip-space control points of distances
+         * d to the near plane (z + w) is in front of it, empty if the quadratic is entirely behind */
+        vec2 visibleRange(vec3 d) {
+            float a = d.x - 2.0 * d.y + d.z;
+            float b = 2.0 * (d.y - d.x);
+            float c = d.x;
+
+            /* Roots of a t^2 + b t + c clamped to [0, 1] in increasing order, 1 when missing */
+            vec2 roots = vec2(1.0);
+            if(abs(a) < 1.0e-12) {
+                if(b != 0.0) {
+                    roots.x = -c / b;
+                }
+            } else {
+                float disc = b * b - 4.0 * a * c;
+                if(disc > 0.0) {
+                    float sq = sqrt(disc);
+                    roots = vec2(-b - sq, -b + sq) / (2.0 * a);
+                    if(a < 0.0) {
+                        roots = roots.yx;
+                    }
+                }
+            }
+            roots = clamp(roots, 0.0, 1.0);
+
+            float ts[4] = float[4](0.0, roots.x, roots.y, 1.0);
+            vec2 range = vec2(0.0);
+            for(int i = 0; i < 3; ++i) {
+                float t = 0.5 * (ts[i] + ts[i + 1]);
+                if(ts[i + 1] - ts[i] > range.y - range.x && (a * t + b) * t + c > 0.0) {
+                    range = vec2(ts[i], ts[i + 1]);
+                }
+            }
+            return range;
+        }
+
+        /* Blossom of the quadratic (P0, P1, P2), the control points of its piece on [u, v] are
+         * blossom(u, u), blossom(u, v) and blossom(v, v) */
+        vec4 blossom(vec4 P0, vec4 P1, vec4 P2, float u, float v) {
+            return (1.0 - u) * (1.0 - v) * P0 + ((1.0 - u) * v + u * (1.0 - v)) * P1 + u * v * P2;
+        }
+
+        void main() {
+            /* The first quad covers Q0 Q1 Q2, the second one Q2 Q3 Q4 */
+            int quad   = gl_VertexID / 6;
+            int corner = quadCorners[gl_VertexID % 6];
+
+            vec4 Q0 = controlPoint(2 * quad);
+            vec4 Q1 = controlPoint(2 * quad + 1);
+            vec4 Q2 = controlPoint(2 * quad + 2);
+
+            /* Clip the quadratic against the near plane. The control points of the remaining piece are in
+             * front of it (the middle one too, as z + w is positive between the ends), so w > 0 */
+            vec2 range = visibleRange(vec3(Q0.z + Q0.w, Q1.z + Q1.w, Q2.z + Q2.w));
+            if(range.y <= range.x) {
+                gl_Position = vec4(2.0, 2.0, 2.0, 1.0); /* entirely behind the near plane: clipped */
+                return;
+            }
+            vec4 P0 = blossom(Q0, Q1, Q2, range.x, range.x);
+            vec4 P1 = blossom(Q0, Q1, Q2, range.x, range.y);
+            vec4 P2 = blossom(Q0, Q1, Q2, range.y, range.y);
+            A = P0.xy / P0.w * viewport;
+            B = P1.xy / P1.w * viewport;
+            C = P2.xy / P2.w * viewport;
+            depths = vec3(P0.z / P0.w, P1.z / P1.w, P2.z / P2.w);
+
+            vec2 lo = min(A, min(B, C)) - vec2(thickness);
+            vec2 hi = max(A, max(B, C)) + vec2(thickness);
+            vec2 position = vec2((corner & 1) != 0 ? hi.x : lo.x, (corner & 2) != 0 ? hi.y : lo.y);
+            gl_Position = vec4(position / viewport, 0.0, 1.0);
+        }
+    )";
+
+    const std::string srcFrag = R"(
+        uniform lowp vec3 color;
+        uniform lowp float thickness = 5.0;
+        uniform lowp vec2 viewport;
+
+        flat in highp vec2 A;
+        flat in highp vec2 B;
+        flat in highp vec2 C;
+        flat in highp vec3 depths;
+
+        layout(location = 0) out lowp vec4 fragmentColor;
+
+        float dot2(vec2 v) {
+            return dot(v, v);
+        }
+
+        /* Distance from p to the quadratic Bezier curve (A, B, C) and the parameter of the closest point.
+         * The closest point is a root of the cubic d/dt |Q(t) - p|^2 = 0, solved in closed form (Cardano).
+         * Under perspective the projected curve is a rational quadratic, which this polynomial one with the
+         * projected control points only approximates (see QuadraticStrokeShader) */
+        vec2 distanceToQuadratic(vec2 p) {
+            vec2 a = B - A;
+            vec2 b = A - 2.0 * B + C;
+            vec2 d = A - p;
+
+            /* Straight curve with evenly spaced control points: distance to the chord */
+            if(dot(b, b) < 1.0e-6) {
+                vec2  chord = C - A;
+                float t     = clamp(dot(p - A, chord) / max(dot(chord, chord), 1.0e-12), 0.0, 1.0);
+                return vec2(length(A + t * chord - p), t);
+            }
+
+            float k  = 1.0 / dot(b, b);
+            float kx = k * dot(a, b);
+            float ky = k * (2.0 * dot(a, a) + dot(d, b)) / 3.0;
+            float kz = k * dot(d, a);
+
+            float q  = ky - kx * kx;
+            float r  = kx * (2.0 * kx * kx - 3.0 * ky) + kz;
+            float h  = r * r + 4.0 * q * q * q;
+            if(h >= 0.0) {
+                /* One real root */
+                h = sqrt(h);
+                vec2  x  = (vec2(h, -h) - r) * 0.5;
+                vec2  uv = sign(x) * pow(abs(x), vec2(1.0 / 3.0));
+                float t  = clamp(uv.x + uv.y - kx, 0.0, 1.0);
+                return vec2(sqrt(dot2(d + (2.0 * a + b * t) * t)), t);
+            }
+
+            /* Three real roots, the middle one is never the closest point */
+            float z  = sqrt(-q);
+            float v  = acos(r / (q * z * 2.0)) / 3.0;
+            float m  = cos(v);
+            float n  = sin(v) * 1.732050808;
+            vec2  ts = clamp(vec2(m + m, -n - m) * z - kx, 0.0, 1.0);
+            float d0 = dot2(d + (2.0 * a + b * ts.x) * ts.x);
+            float d1 = dot2(d + (2.0 * a + b * ts.y) * ts.y);
+            return d0 < d1 ? vec2(sqrt(d0), ts.x) : vec2(sqrt(d1), ts.y);
+        }
+
+        void main() {
+            vec2 p = (gl_FragCoord.xy / viewport * 2.0 - 1.0) * viewport;
+            vec2 closest = distanceToQuadratic(p);
+            if(closest.x > thickness) {
+                discard;
+            }
+
+            float t = closest.y;
+            float s = 1.0 - t;
+            float z = s * s * depths.x + 2.0 * s * t * depths.y + t * t * depths.z;
+            gl_FragDepth  = z * 0.5 + 0.5;
+            fragmentColor = vec4(color, 1.0);
+        }
+    )";
+
+    /* Reuse the binary linked by a previous run, or compile from source and store the result */
+    const auto cacheKey = ProgramBinaryCache::key({ &srcVert, &srcFrag });
+    if(!ProgramBinaryCache::load(*this, cacheKey)) {
+        GL::Shader vertShader{ GL::Version::GL330, GL::Shader::Type::Vertex };
+        GL::Shader fragShader{ GL::Version::GL330, GL::Shader::Type::Fragment };
+        vertShader.addSource(srcVert);
+        fragShader.addSource(srcFrag);
+        CORRADE_INTERNAL_ASSERT(GL::Shader::compile({ vertShader, fragShader }));
+        attachShaders({ vertShader, fragShader });
+        ProgramBinaryCache::setRetrievable(*this);
+        CORRADE_INTERNAL_ASSERT(link());
+        ProgramBinaryCache::save(*this, cacheKey);
+    }
+
+    m_uColor      = uniformLocation("color");
+    m_uThickness  = uniformLocation("thickness");
+    m_uViewport   = uniformLocation("viewport");
+    m_uTransformationProjectionMatrix = uniformLocation("transformationProjectionMatrix");
+    setUniform(uniformLocation("controlPoints"), ControlPointUnit);
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& QuadraticStrokeShader::setThickness(float thickness) {
+    setUniform(m_uThickness, thickness);
+    return *this;
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& QuadraticStrokeShader::setColor(const Color3& color) {
+    setUniform(m_uColor, color);
+    return *this;
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& QuadraticStrokeShader::setViewport(const Vector2i& viewport) {
+    setUniform(m_uViewport, Vector2{ viewport });
+    return *this;
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& QuadraticStrokeShader::setTransformationProjectionMatrix(const Matrix4& matrix) {
+    setUniform(m_uTransformationProjectionMatrix, matrix);
+    return *this;
+}
+
+/****************************************************************************************************/
+QuadraticStrokeShader& QuadraticStrokeShader::bindControlPoints(GL::BufferTexture& texture) {
+    texture.bind(ControlPointUnit);
+    return *this;
+}
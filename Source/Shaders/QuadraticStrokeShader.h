@@ -0,0 +1,65 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <Magnum/GL/AbstractShaderProgram.h>
+#include <Magnum/GL/Attribute.h>
+#include <Magnum/GL/GL.h>
+
+using namespace Corrade;
+using namespace Magnum;
+
+/****************************************************************************************************/
+/* Analytic stroking of quadratic Bezier curves, without tessellation.
+ *
+ * Every instance is one quadratic pair, read from a R32F buffer texture as in CurveEvaluationShader, and
+ * is drawn as two screen-space quads (12 vertices), one per quadratic. Each quadratic is first clipped
+ * against the near plane in clip space, keeping its longest piece in front of it, and its quad is the
+ * bounding box of the projected control points of that piece grown by the thickness. The fragment shader
+ * computes the distance to the quadratic through the projected control points by solving the cubic of
+ * the closest point in closed form, discards fragments farther than the thickness and takes the depth
+ * of the closest point. Thickness is in the units of LineShader, so both shaders draw strokes of the
+ * same width.
+ *
+ * The distance is exact for affine projections only. Under perspective the projected curve is a rational
+ * quadratic with the clip-space w of the control points as weights, and the polynomial quadratic through
+ * the projected control points deviates from it where these weights differ, most for long curves at a
+ * steep depth. The end points and tangents still match, and the vertex count is fixed per curve, so the
+ * stroke has no facets at any zoom level.
+ */
+class QuadraticStrokeShader : public GL::AbstractShaderProgram {
+public:
+    typedef GL::Attribute<0, UnsignedInt> FirstPoint;
+
+    enum: Int { ControlPointUnit = 0 };
+
+    /* Vertices per instance */
+    enum: Int { VertexCount = 12 };
+
+    QuadraticStrokeShader();
+    QuadraticStrokeShader& setThickness(float thickness);
+    QuadraticStrokeShader& setColor(const Color3& color);
+    QuadraticStrokeShader& setViewport(const Vector2i& viewport);
+    QuadraticStrokeShader& setTransformationProjectionMatrix(const Matrix4& matrix);
+    QuadraticStrokeShader& bindControlPoints(GL::BufferTexture& texture);
+
+private:
+    Int m_uColor,
+        m_uThickness,
+        m_uViewport,
+        m_uTransformationProjectionMatrix;
+};
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+#include "Core/CurveFile.h"
+#include "Core/GammaSolver.h"
+#include "Core/PointIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/****************************************************************************************************/
+/* Streaming conversion of cubic Bezier curves (or Catmull-Rom splines) to C1 quadratic pairs.
+ * Input is read and output written in batches of BatchCurves curves, so memory stays constant for
+ * inputs of any size, and the tool can sit in a pipe. Binary curve files (Core/CurveFile.h) are
+ * memory-mapped and their float32 points converted in place, without parsing or copy.
+ */
+using namespace Core;
+
+namespace {
+constexpr size_t BatchCurves = 4096;
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "Usage: CurveConverter [options] [input]\n"
+                 "Converts cubic Bezier curves (4 points per curve, points.txt format or binary curve\n"
+                 "file) to pairs of C1 quadratic Bezier curves (5 points per curve). Reads stdin if no\n"
+                 "input file is given.\n"
+                 "\n"
+                 "  -o, --output FILE     output file (default: stdout)\n"
+                 "  -g, --gamma VALUE     split parameter in [0, 1] (default: 0.5), or l2 / max for the\n"
+                 "                        per-curve optimum of the L2 / max distance error\n"
+                 "  -c, --catmull-rom     input is a Catmull-Rom spline through the data points (given by\n"
+                 "                        the topology of binary input)\n"
+                 "  -a, --alpha VALUE     Catmull-Rom parameterization in [0, 1] (default: 0.5, or the\n"
+                 "                        value stored in binary input)\n"
+                 "  -f, --format FORMAT   output format: text, csv, raw or binary (default: text), binary\n"
+                 "                        output requires -o\n"
+                 "  -h, --help            show this help\n");
+}
+
+struct Options {
+    std::string inputFile;
+    std::string outputFile;
+    float       gamma { 0.5f };
+    bool        bOptimalGamma { false };
+    GammaObjective gammaObjective { GammaObjective::L2 };
+    bool        bCatmullRom { false };
+    float       alpha { 0.5f };
+    PointFormat format { PointFormat::Text };
+    bool        bBinaryOutput { false };
+};
+
+bool parseFloat(const char* text, float lo, float hi, float& value) {
+    char* end;
+    value = std::strtof(text, &end);
+    return end != text && *end == '\0' && value >= lo && value <= hi;
+}
+
+/* Returns false on invalid arguments */
+bool parseArguments(int argc, char** argv, Options& options, bool& bHelp) {
+    for(int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto              next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if(arg == "-h" || arg == "--help") {
+            bHelp = true;
+        } else if(arg == "-c" || arg == "--catmull-rom") {
+            options.bCatmullRom = true;
+        } else if(arg == "-o" || arg == "--output") {
+            const auto value = next();
+            if(!value) { return false; }
+            options.outputFile = value;
+        } else if(arg == "-g" || arg == "--gamma") {
+            const auto value = next();
+            if(!value) { return false; }
+            if(std::strcmp(value, "l2") == 0 || std::strcmp(value, "max") == 0) {
+                options.bOptimalGamma  = true;
+                options.gammaObjective = value[0] == 'l' ? GammaObjective::L2 : GammaObjective::MaxDistance;
+            } else if(!parseFloat(value, 0.0f, 1.0f, options.gamma)) {
+                std::fprintf(stderr, "Invalid gamma: %s\n", value);
+                return false;
+            }
+        } else if(arg == "-a" || arg == "--alpha") {
+            const auto value = next();
+            if(!value || !parseFloat(value, 0.0f, 1.0f, options.alpha)) {
+                std::fprintf(stderr, "Invalid alpha\n");
+                return false;
+            }
+        } else if(arg == "-f" || arg == "--format") {
+            const auto value = next();
+            if(!value) { return false; }
+            const std::string format = value;
+            if(format == "text") {
+                options.format = PointFormat::Text;
+            } else if(format == "csv") {
+                options.format = PointFormat::Csv;
+            } else if(format == "raw") {
+                options.format = PointFormat::Raw;
+            } else if(format == "binary") {
+                options.bBinaryOutput = true;
+            } else {
+                std::fprintf(stderr, "Unknown format: %s\n", value);
+                return false;
+            }
+        } else if(arg != "-" && !arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            return false;
+        } else if(options.inputFile.empty()) {
+            options.inputFile = arg;
+        } else {
+            std::fprintf(stderr, "Only one input file can be given\n");
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+/****************************************************************************************************/
+int main(int argc, char** argv) {
+    Options options;
+    bool    bHelp = false;
+    if(!parseArguments(argc, argv, options, bHelp) || bHelp) {
+        printUsage();
+        return bHelp ? 0 : 2;
+    }
+
+    if(options.bBinaryOutput && options.outputFile.empty()) {
+        std::fprintf(stderr, "Binary output requires an output file\n");
+        return 2;
+    }
+
+    /* Binary input is mapped, its topology and alpha override the options */
+    MappedCurveFile mappedInput;
+    const bool      bBinaryInput = !options.inputFile.empty() && options.inputFile != "-" &&
+                                   isCurveFile(options.inputFile);
+    if(bBinaryInput) {
+        if(!mappedInput.open(options.inputFile)) {
+            std::fprintf(stderr, "%s\n", mappedInput.error().c_str());
+            return 1;
+        }
+        if(mappedInput.header().topology == CurveFileTopology::QuadraticPair) {
+            std::fprintf(stderr, "%s already contains quadratic curves\n", options.inputFile.c_str());
+            return 1;
+        }
+        options.bCatmullRom = mappedInput.header().topology == CurveFileTopology::CatmullRom;
+        if(options.bCatmullRom) {
+            options.alpha = mappedInput.header().catmullRomAlpha;
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::ifstream inputFile;
+    if(!bBinaryInput && !options.inputFile.empty() && options.inputFile != "-") {
+        inputFile.open(options.inputFile);
+        if(!inputFile.is_open()) {
+            std::fprintf(stderr, "Cannot open %s\n", options.inputFile.c_str());
+            return 1;
+        }
+    }
+    std::istream& input = inputFile.is_open() ? inputFile : std::cin;
+
+    CurveFileWriter binaryOutput;
+    FILE*           output = nullptr;
+    if(options.bBinaryOutput) {
+        if(!binaryOutput.open(options.outputFile, CurveFileTopology::QuadraticPair)) {
+            std::fprintf(stderr, "%s\n", binaryOutput.error().c_str());
+            return 1;
+        }
+    } else {
+        output = options.outputFile.empty() ? stdout : std::fopen(options.outputFile.c_str(), "wb");
+        if(!output) {
+            std::fprintf(stderr, "Cannot open %s\n", options.outputFile.c_str());
+            return 1;
+        }
+    }
+
+    /* A Catmull-Rom curve needs 4 consecutive data points: the last 3 points of a batch are kept
+     * as the beginning of the next one */
+    const size_t        overlap = options.bCatmullRom ? 3 : 0;
+    const size_t        batchPoints = options.bCatmullRom ? BatchCurves : 4 * BatchCurves;
+    std::vector<Point3> points(overlap + batchPoints);
+    std::vector<Point3> cubics(4 * BatchCurves), quadratics(5 * BatchCurves);
+    std::vector<float>  gammas(BatchCurves);
+    std::string         text;
+    TextPointReader     reader(input);
+    size_t              nBuffered = 0;    /* points at the front of the buffer carried over from the last batch */
+    size_t              nMappedDone = 0;  /* first point of the batch in the mapped input */
+    size_t              nCurvesDone = 0;
+    int                 status = 0;
+
+    while(true) {
+        /* Points of this batch: straight from the mapping when possible, otherwise in the buffer */
+        const Point3* P = points.data();
+        size_t        nRead;
+        if(bBinaryInput) {
+            nRead = std::min(batchPoints, mappedInput.pointCount() - nMappedDone - nBuffered);
+            if(mappedInput.points()) {
+                P = mappedInput.points() + nMappedDone;
+            } else {
+                mappedInput.copyPoints(nMappedDone, nBuffered + nRead, points.data());
+            }
+            nMappedDone += nBuffered + nRead;
+        } else {
+            nRead = reader.read(&points[nBuffered], batchPoints);
+            if(reader.failed()) {
+                std::fprintf(stderr, "Invalid input, %s\n", reader.error().c_str());
+                status = 1;
+                break;
+            }
+        }
+        const auto nPoints = nBuffered + nRead;
+
+        size_t        nCurves;
+        const Point3* B = cubics.data();
+        if(options.bCatmullRom) {
+            nCurves = catmullRomToCubics(P, nPoints, options.alpha, cubics.data());
+        } else {
+            nCurves = nPoints / 4;
+            B       = P;
+        }
+
+        if(options.bOptimalGamma) {
+            optimalGammas(B, nCurves, options.gammaObjective, gammas.data());
+            convertCubicsToQuadratics(B, nCurves, gammas.data(), quadratics.data());
+        } else {
+            convertCubicsToQuadratics(B, nCurves, options.gamma, quadratics.data());
+        }
+
+        if(options.bBinaryOutput) {
+            if(!binaryOutput.append(quadratics.data(), 5 * nCurves)) {
+                std::fprintf(stderr, "%s\n", binaryOutput.error().c_str());
+                status = 1;
+                break;
+            }
+        } else {
+            text.clear();
+            formatCurves(quadratics.data(), nCurves, 5, options.format, text, nCurvesDone);
+            if(std::fwrite(text.data(), 1, text.size(), output) != text.size()) {
+                std::fprintf(stderr, "Write error\n");
+                status = 1;
+                break;
+            }
+        }
+        nCurvesDone += nCurves;
+
+        if(nRead < batchPoints) {
+            if(!options.bCatmullRom && nPoints % 4 != 0) {
+                std::fprintf(stderr, "Warning: ignored %zu trailing points (not a complete cubic curve)\n", nPoints % 4);
+            }
+            break;
+        }
+        if(options.bCatmullRom) {
+            nBuffered = std::min(nPoints, overlap);
+            if(bBinaryInput) {
+                nMappedDone -= nBuffered;
+            } else {
+                std::copy(points.begin() + static_cast<std::ptrdiff_t>(nPoints - nBuffered),
+                          points.begin() + static_cast<std::ptrdiff_t>(nPoints), points.begin());
+            }
+        }
+    }
+
+    if(options.bBinaryOutput) {
+        if(!binaryOutput.close()) {
+            std::fprintf(stderr, "%s\n", binaryOutput.error().c_str());
+            status = 1;
+        }
+    } else if(output != stdout) {
+        if(std::fclose(output) != 0) {
+            std::fprintf(stderr, "Write error\n");
+            status = 1;
+        }
+    } else if(std::fflush(output) != 0) {
+        status = 1;
+    }
+    return status;
+}
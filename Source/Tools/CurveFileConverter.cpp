@@ -0,0 +1,226 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveFile.h"
+#include "Core/PointIO.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/****************************************************************************************************/
+/* Conversion between the points.txt text format and the binary curve file format of Core/CurveFile.h.
+ * The direction is given by the input: binary files are recognized by their magic.
+ */
+using namespace Core;
+
+namespace {
+constexpr size_t BatchPoints = 65536;
+
+void printUsage() {
+    std::fprintf(stderr,
+                 "Usage: CurveFileConverter [options] input\n"
+                 "Converts a points.txt-style text file to a binary curve file, or a binary curve file\n"
+                 "back to text.\n"
+                 "\n"
+                 "  -o, --output FILE       output file (required for binary output, default: stdout)\n"
+                 "  -t, --topology TYPE     topology of text input: cubic, quadratic or catmull-rom\n"
+                 "                          (default: cubic)\n"
+                 "  -a, --alpha VALUE       Catmull-Rom parameterization in [0, 1] (default: 0.5)\n"
+                 "  -d, --double            write float64 coordinates (default: float32)\n"
+                 "  -f, --format FORMAT     text output format: text or csv (default: text)\n"
+                 "  -h, --help              show this help\n");
+}
+
+struct Options {
+    std::string        inputFile;
+    std::string        outputFile;
+    CurveFileTopology  topology { CurveFileTopology::CubicBezier };
+    CurveFilePrecision precision { CurveFilePrecision::Float32 };
+    float              alpha { 0.5f };
+    PointFormat        format { PointFormat::Text };
+};
+
+size_t pointsPerCurve(CurveFileTopology topology) {
+    switch(topology) {
+        case CurveFileTopology::CubicBezier:
+            return 4;
+        case CurveFileTopology::QuadraticPair:
+            return 5;
+        default:
+            return 1;
+    }
+}
+
+/* Returns false on invalid arguments */
+bool parseArguments(int argc, char** argv, Options& options, bool& bHelp) {
+    for(int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto              next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        if(arg == "-h" || arg == "--help") {
+            bHelp = true;
+        } else if(arg == "-d" || arg == "--double") {
+            options.precision = CurveFilePrecision::Float64;
+        } else if(arg == "-o" || arg == "--output") {
+            const auto value = next();
+            if(!value) { return false; }
+            options.outputFile = value;
+        } else if(arg == "-t" || arg == "--topology") {
+            const auto value = next();
+            if(!value) { return false; }
+            const std::string topology = value;
+            if(topology == "cubic") {
+                options.topology = CurveFileTopology::CubicBezier;
+            } else if(topology == "quadratic") {
+                options.topology = CurveFileTopology::QuadraticPair;
+            } else if(topology == "catmull-rom") {
+                options.topology = CurveFileTopology::CatmullRom;
+            } else {
+                std::fprintf(stderr, "Unknown topology: %s\n", value);
+                return false;
+            }
+        } else if(arg == "-a" || arg == "--alpha") {
+            const auto value = next();
+            char*      end;
+            if(!value || (options.alpha = std::strtof(value, &end), *end != '\0') ||
+               options.alpha < 0.0f || options.alpha > 1.0f) {
+                std::fprintf(stderr, "Invalid alpha\n");
+                return false;
+            }
+        } else if(arg == "-f" || arg == "--format") {
+            const auto value = next();
+            if(!value) { return false; }
+            const std::string format = value;
+            if(format == "text") {
+                options.format = PointFormat::Text;
+            } else if(format == "csv") {
+                options.format = PointFormat::Csv;
+            } else {
+                std::fprintf(stderr, "Unknown format: %s\n", value);
+                return false;
+            }
+        } else if(!arg.empty() && arg[0] == '-') {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            return false;
+        } else if(options.inputFile.empty()) {
+            options.inputFile = arg;
+        } else {
+            std::fprintf(stderr, "Only one input file can be given\n");
+            return false;
+        }
+    }
+    return !options.inputFile.empty();
+}
+
+/****************************************************************************************************/
+int textToBinary(const Options& options) {
+    if(options.outputFile.empty()) {
+        std::fprintf(stderr, "An output file is required for binary output\n");
+        return 2;
+    }
+    /* The text is mapped and parsed in parallel, then written in one go */
+    std::vector<Point3> points;
+    std::string         error;
+    if(!loadTextPoints(options.inputFile, points, error)) {
+        std::fprintf(stderr, "Invalid input, %s\n", error.c_str());
+        return 1;
+    }
+
+    CurveFileWriter writer;
+    if(!writer.open(options.outputFile, options.topology, options.precision, options.alpha) ||
+       !writer.append(points.data(), points.size())) {
+        std::fprintf(stderr, "%s\n", writer.error().c_str());
+        return 1;
+    }
+
+    const auto nPoints = points.size();
+    if(nPoints % pointsPerCurve(options.topology) != 0) {
+        std::fprintf(stderr, "Warning: %zu trailing points do not form a complete curve\n",
+                     nPoints % pointsPerCurve(options.topology));
+    }
+    if(!writer.close()) {
+        std::fprintf(stderr, "%s\n", writer.error().c_str());
+        return 1;
+    }
+    return 0;
+}
+
+/****************************************************************************************************/
+int binaryToText(const Options& options) {
+    MappedCurveFile file;
+    if(!file.open(options.inputFile)) {
+        std::fprintf(stderr, "%s\n", file.error().c_str());
+        return 1;
+    }
+
+    FILE* output = options.outputFile.empty() ? stdout : std::fopen(options.outputFile.c_str(), "wb");
+    if(!output) {
+        std::fprintf(stderr, "Cannot open %s\n", options.outputFile.c_str());
+        return 1;
+    }
+
+    /* Float32 files are formatted straight from the mapping, Float64 ones through a conversion buffer */
+    const auto          nControlPoints = pointsPerCurve(file.header().topology);
+    const auto          nCurves        = file.pointCount() / nControlPoints;
+    const auto          batchCurves    = BatchPoints / nControlPoints;
+    if(file.pointCount() % nControlPoints != 0) {
+        std::fprintf(stderr, "Warning: %zu trailing points do not form a complete curve and are skipped\n",
+                     file.pointCount() % nControlPoints);
+    }
+    std::vector<Point3> buffer(file.points() ? 0 : batchCurves * nControlPoints);
+    std::string         text;
+    int                 status = 0;
+    for(size_t first = 0; first < nCurves; first += batchCurves) {
+        const auto    n      = std::min(batchCurves, nCurves - first);
+        const Point3* points = buffer.data();
+        if(file.points()) {
+            points = file.points() + first * nControlPoints;
+        } else {
+            file.copyPoints(first * nControlPoints, n * nControlPoints, buffer.data());
+        }
+        text.clear();
+        formatCurves(points, n, nControlPoints, options.format, text, first);
+        if(std::fwrite(text.data(), 1, text.size(), output) != text.size()) {
+            std::fprintf(stderr, "Write error\n");
+            status = 1;
+            break;
+        }
+    }
+
+    if(output != stdout) {
+        if(std::fclose(output) != 0) {
+            std::fprintf(stderr, "Write error\n");
+            status = 1;
+        }
+    } else if(std::fflush(output) != 0) {
+        status = 1;
+    }
+    return status;
+}
+}
+
+/****************************************************************************************************/
+int main(int argc, char** argv) {
+    Options options;
+    bool    bHelp = false;
+    if(!parseArguments(argc, argv, options, bHelp) || bHelp) {
+        printUsage();
+        return bHelp ? 0 : 2;
+    }
+    return isCurveFile(options.inputFile) ? binaryToText(options) : textToBinary(options);
+}
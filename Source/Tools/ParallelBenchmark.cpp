@@ -0,0 +1,105 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CpuFeatures.h"
+#include "Core/CurveBatch.h"
+#include "Core/CurveSoA.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+/****************************************************************************************************/
+/* Thread scaling of the batch functions running on Core::threadPool().
+ * Usage: ParallelBenchmark [nCurves] [maxThreads]
+ *
+ * Thread counts double from 1 up to maxThreads (default: hardware concurrency). Speedups are relative
+ * to the single-threaded run. The cubic to quadratic conversion is then timed single-threaded on every
+ * SIMD level supported by the CPU, from the packed Point3 layout and from SoA storage.
+ */
+using namespace Core;
+
+namespace {
+template<class Function>
+double bestTimeMs(const Function& function) {
+    double best = 1.0e30;
+    for(int run = 0; run < 3; ++run) {
+        const auto t0 = std::chrono::steady_clock::now();
+        function();
+        const auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+}
+
+/****************************************************************************************************/
+int main(int argc, char** argv) {
+    const size_t nCurves    = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 1000000;
+    const size_t maxThreads = argc > 2 ? static_cast<size_t>(std::atol(argv[2])) :
+                              std::max(1u, std::thread::hardware_concurrency());
+
+    std::mt19937                          rng(2020);
+    std::uniform_real_distribution<float> coord(-2.0f, 2.0f);
+    std::vector<Point3>                   dataPoints(nCurves + 3);
+    for(auto& p : dataPoints) {
+        p = Point3{ coord(rng), coord(rng), coord(rng) };
+    }
+    std::vector<Point3> cubics(nCurves * 4), quadratics(nCurves * 5), points, adaptivePoints;
+    std::vector<size_t> offsets;
+
+    const struct { const char* name; std::function<void()> function; } stages[] = {
+        { "Catmull-Rom (alpha 0.3)", [&] { catmullRomToCubics(dataPoints.data(), dataPoints.size(), 0.3f, cubics.data()); } },
+        { "Cubic to quadratics", [&] { convertCubicsToQuadratics(cubics.data(), nCurves, 0.5f, quadratics.data()); } },
+        { "Tessellate cubics (32)", [&] { tessellate(CurveType::CubicBezier, cubics.data(), nCurves, 32, points); } },
+        { "Adaptive quadratics", [&] {
+              tessellateAdaptive(CurveType::QuadraticPair, quadratics.data(), nCurves, 1.0e-3f, adaptivePoints, offsets);
+          } },
+    };
+
+    std::printf("%zu curves\n", nCurves);
+    std::printf("%-26s %8s %12s %10s\n", "Stage", "Threads", "Time (ms)", "Speedup");
+    for(const auto& stage : stages) {
+        double serialMs = 0.0;
+        for(size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+            setThreadCount(nThreads);
+            const auto ms = bestTimeMs(stage.function);
+            if(nThreads == 1) {
+                serialMs = ms;
+            }
+            std::printf("%-26s %8zu %12.3f %10.2f\n", stage.name, nThreads, ms, serialMs / ms);
+        }
+    }
+
+    CurveSoA cubicsSoA(CurveType::CubicBezier, nCurves), quadraticsSoA;
+    cubicsSoA.fromPoints(cubics.data());
+    setThreadCount(1);
+    std::printf("\n%-26s %8s %20s %20s\n", "Cubic to quadratics", "SIMD", "Point3 (Mcurves/s)", "SoA (Mcurves/s)");
+    for(int level = 0; level <= static_cast<int>(detectSimdLevel()); ++level) {
+        setSimdLevel(static_cast<SimdLevel>(level));
+        const auto aosMs = bestTimeMs([&] { convertCubicsToQuadratics(cubics.data(), nCurves, 0.5f, quadratics.data()); });
+        const auto soaMs = bestTimeMs([&] { convertCubicsToQuadratics(cubicsSoA, 0.5f, quadraticsSoA); });
+        std::printf("%-26s %8s %20.1f %20.1f\n", "", simdLevelName(simdLevel()),
+                    1.0e-3 * static_cast<double>(nCurves) / aosMs, 1.0e-3 * static_cast<double>(nCurves) / soaMs);
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2020 Nghia Truong <nghiatruong.vn@gmail.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Core/CurveBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/****************************************************************************************************/
+/* Accuracy and speed comparison of the tessellation strategies of Core::tessellate().
+ * Usage: TessellationBenchmark [nCurves]
+ *
+ * The error is the maximum distance to a double precision Bernstein evaluation, relative to the
+ * control polygon extent of each curve, so that it can be compared against float epsilon (~1.2e-7).
+ */
+using namespace Core;
+
+namespace {
+Point3d evaluateReference(CurveType type, const Point3* C, int i, int subdivision) {
+    auto bernstein = [](const Point3* P, int degree, double t) {
+                         const auto s = 1.0 - t;
+                         const double w3[] = { s * s * s, 3.0 * s * s * t, 3.0 * s * t * t, t * t * t };
+                         const double w2[] = { s * s, 2.0 * s * t, t * t };
+                         Point3d p{ 0.0, 0.0, 0.0 };
+                         for(int k = 0; k <= degree; ++k) {
+                             const auto w = degree == 3 ? w3[k] : w2[k];
+                             p.x += w * P[k].x;
+                             p.y += w * P[k].y;
+                             p.z += w * P[k].z;
+                         }
+                         return p;
+                     };
+    if(type == CurveType::CubicBezier) {
+        return bernstein(C, 3, static_cast<double>(i) / subdivision);
+    }
+    /* Same half selection as the float code: t < 0.5 on the first quadratic */
+    const int nFirstHalf = (subdivision + 1) / 2;
+    return i < nFirstHalf ?
+           bernstein(C, 2, 2.0 * i / subdivision) :
+           bernstein(C + 2, 2, (2.0 * i - subdivision) / subdivision);
+}
+
+double controlPolygonExtent(const Point3* C, size_t n) {
+    Point3 lo = C[0], hi = C[0];
+    for(size_t k = 1; k < n; ++k) {
+        lo = Point3{ std::min(lo.x, C[k].x), std::min(lo.y, C[k].y), std::min(lo.z, C[k].z) };
+        hi = Point3{ std::max(hi.x, C[k].x), std::max(hi.y, C[k].y), std::max(hi.z, C[k].z) };
+    }
+    return std::max(static_cast<double>(length(hi - lo)), 1e-30);
+}
+}
+
+/****************************************************************************************************/
+int main(int argc, char** argv) {
+    const size_t nCurves = argc > 1 ? static_cast<size_t>(std::atol(argv[1])) : 10000;
+
+    std::mt19937                          rng(2020);
+    std::uniform_real_distribution<float> coord(-2.0f, 2.0f);
+    std::vector<Point3>                   cubics(nCurves * 4);
+    for(auto& p : cubics) {
+        p = Point3{ coord(rng), coord(rng), coord(rng) };
+    }
+    std::vector<Point3> quadratics(nCurves * 5);
+    convertCubicsToQuadratics(cubics.data(), nCurves, 0.5f, quadratics.data());
+
+    const struct { TessellationMethod method; const char* name; } methods[] = {
+        { TessellationMethod::Bernstein, "Bernstein" },
+        { TessellationMethod::Horner, "Horner" },
+        { TessellationMethod::ForwardDifferencing, "ForwardDifferencing" },
+    };
+
+    std::printf("%zu curves\n", nCurves);
+    std::printf("%-10s %-20s %8s %12s %14s\n", "Curve", "Method", "Segments", "ns/point", "Max rel error");
+    std::vector<Point3> points;
+    for(const auto type : { CurveType::CubicBezier, CurveType::QuadraticPair }) {
+        const auto* controlPoints  = type == CurveType::CubicBezier ? cubics.data() : quadratics.data();
+        const auto  nControlPoints = controlPointCount(type);
+        for(const int subdivision : { 16, 128, 1024, 4096 }) {
+            for(const auto& m : methods) {
+                /* Keep the total work roughly constant across subdivisions */
+                const auto nRuns = std::max<size_t>(1, (1u << 24) / tessellatedPointCount(nCurves, subdivision));
+                const auto t0    = std::chrono::steady_clock::now();
+                for(size_t run = 0; run < nRuns; ++run) {
+                    tessellate(type, controlPoints, nCurves, subdivision, points, m.method);
+                }
+                const auto t1 = std::chrono::steady_clock::now();
+                const auto ns = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                                static_cast<double>(nRuns * points.size());
+
+                double maxError = 0.0;
+                for(size_t idx = 0; idx < nCurves; ++idx) {
+                    const auto* C      = &controlPoints[idx * nControlPoints];
+                    const auto  extent = controlPolygonExtent(C, nControlPoints);
+                    for(int i = 0; i <= subdivision; ++i) {
+                        const auto  ref = evaluateReference(type, C, i, subdivision);
+                        const auto& p   = points[idx * static_cast<size_t>(subdivision + 1) + static_cast<size_t>(i)];
+                        const auto  dx  = p.x - ref.x, dy = p.y - ref.y, dz = p.z - ref.z;
+                        maxError = std::max(maxError, std::sqrt(dx * dx + dy * dy + dz * dz) / extent);
+                    }
+                }
+                std::printf("%-10s %-20s %8d %12.3f %14.3e\n",
+                            type == CurveType::CubicBezier ? "Cubic" : "Quadratic",
+                            m.name, subdivision, ns, maxError);
+            }
+        }
+    }
+    return 0;
+}